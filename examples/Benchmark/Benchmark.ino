@@ -0,0 +1,228 @@
+/**
+ * @file Benchmark.ino
+ * @brief Microbenchmark suite for the Paranode library
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Measures the hot paths behind the numbers in OPTIMIZATION.md:
+ *  - ParanodeJsonBuilder vs. ArduinoJson + String serialization
+ *  - ParanodeMessageQueue enqueue / dequeue / batch / expire
+ *  - handleMessage dispatch (fed through injectMessage)
+ *  - The full sendData<T> path (build + queue)
+ *
+ * No WiFi or server is needed. Results are printed as CSV on Serial so they
+ * can be captured and compared between library versions:
+ *
+ *   bench,iterations,total_us,ns_per_op,bytes,heap_delta
+ *
+ * "bytes" is the size of the produced message (0 when not applicable) and
+ * "heap_delta" is the free heap lost over the whole run. It is a net
+ * figure: memory allocated and freed within the run does not show up.
+ *
+ * The first line reports the footprint profile and the RAM taken by the
+ * Paranode object, so builds with different PARANODE_PROFILE_* flags can
+ * be compared.
+ */
+
+#include <Paranode.h>
+
+// Iterations per benchmark - raise for more stable numbers
+const unsigned long ITERATIONS = 2000;
+
+Paranode paranode("benchmark-token");
+
+char buffer[PARANODE_MAX_MESSAGE_SIZE];
+char batchBuffer[1024];
+ParanodeMessageQueue queue;
+volatile unsigned long sink = 0;
+
+typedef size_t (*BenchFunction)(unsigned long iteration);
+
+void report(const char *name, unsigned long iterations, unsigned long totalUs, size_t bytes, long heapDelta)
+{
+    Serial.print(name);
+    Serial.print(',');
+    Serial.print(iterations);
+    Serial.print(',');
+    Serial.print(totalUs);
+    Serial.print(',');
+    Serial.print((unsigned long)((totalUs * 1000ULL) / iterations));
+    Serial.print(',');
+    Serial.print((unsigned long)bytes);
+    Serial.print(',');
+    Serial.println(heapDelta);
+}
+
+void runBenchmark(const char *name, BenchFunction fn, unsigned long iterations = ITERATIONS)
+{
+    // Warm up caches and any lazily initialized state
+    size_t bytes = fn(0);
+
+    long heapBefore = ESP.getFreeHeap();
+    unsigned long start = micros();
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        bytes = fn(i);
+    }
+    unsigned long elapsed = micros() - start;
+    long heapAfter = ESP.getFreeHeap();
+
+    report(name, iterations, elapsed, bytes, heapBefore - heapAfter);
+    yield();
+}
+
+// ---------------------------------------------------------------------------
+// Serialization
+// ---------------------------------------------------------------------------
+
+size_t benchJsonBuilder(unsigned long i)
+{
+    ParanodeJsonBuilder builder(buffer, sizeof(buffer));
+    builder.startObject();
+    builder.addString("type", "telemetry");
+    builder.addString("key", "temperature");
+    builder.addFloat("value", 25.5f + (i & 7));
+    builder.addString("unit", "C");
+    builder.addULong("timestamp", millis());
+    builder.endObject();
+    return builder.length();
+}
+
+size_t benchArduinoJson(unsigned long i)
+{
+    StaticJsonDocument<256> doc;
+    doc["type"] = "telemetry";
+    doc["key"] = "temperature";
+    doc["value"] = 25.5f + (i & 7);
+    doc["unit"] = "C";
+    doc["timestamp"] = millis();
+
+    String message;
+    serializeJson(doc, message);
+    return message.length();
+}
+
+// ---------------------------------------------------------------------------
+// Message queue
+// ---------------------------------------------------------------------------
+
+size_t benchQueueEnqueue(unsigned long i)
+{
+    size_t len = benchJsonBuilder(i);
+    queue.enqueue(buffer, len, 1); // Drops oldest once full - steady state
+    return len;
+}
+
+size_t benchQueueDequeue(unsigned long i)
+{
+    if (queue.isEmpty())
+    {
+        benchQueueEnqueue(i);
+    }
+    return queue.dequeue(buffer, sizeof(buffer));
+}
+
+size_t benchQueueBatch(unsigned long i)
+{
+    if (queue.count() < 5)
+    {
+        for (int n = 0; n < 5; n++)
+        {
+            benchQueueEnqueue(i);
+        }
+    }
+    int batched = queue.batchMessages(batchBuffer, sizeof(batchBuffer), 5);
+    sink += batched;
+    return strlen(batchBuffer);
+}
+
+size_t benchQueueExpire(unsigned long i)
+{
+    // Nothing is old enough to expire, so this measures the full scan
+    while (!queue.isFull())
+    {
+        benchQueueEnqueue(i);
+    }
+    return queue.removeExpired(300000);
+}
+
+// ---------------------------------------------------------------------------
+// Dispatch and send paths
+// ---------------------------------------------------------------------------
+
+const char COMMAND_FRAME[] = "{\"type\":\"command\",\"command\":{\"id\":\"cmd-1\",\"action\":\"relay\",\"value\":true}}";
+const char CONFIG_FRAME[] = "{\"type\":\"config\",\"config\":{\"heartbeatInterval\":30000,\"metricsInterval\":60000}}";
+const char UNKNOWN_FRAME[] = "{\"type\":\"noop\"}";
+
+size_t benchDispatchCommand(unsigned long i)
+{
+    paranode.injectMessage(COMMAND_FRAME, sizeof(COMMAND_FRAME) - 1);
+    return sizeof(COMMAND_FRAME) - 1;
+}
+
+size_t benchDispatchConfig(unsigned long i)
+{
+    paranode.injectMessage(CONFIG_FRAME, sizeof(CONFIG_FRAME) - 1);
+    return sizeof(CONFIG_FRAME) - 1;
+}
+
+size_t benchDispatchUnknown(unsigned long i)
+{
+    paranode.injectMessage(UNKNOWN_FRAME, sizeof(UNKNOWN_FRAME) - 1);
+    return sizeof(UNKNOWN_FRAME) - 1;
+}
+
+size_t benchSendDataFloat(unsigned long i)
+{
+    // Offline, so the message is built and handed to the queue
+    sink += paranode.sendData<float>("temperature", 25.5f + (i & 7), "C", true);
+    return paranode.getQueuedCount();
+}
+
+size_t benchSendDataInt(unsigned long i)
+{
+    sink += paranode.sendData<int>("counter", (int)i, "", true);
+    return paranode.getQueuedCount();
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    delay(1000);
+
+    paranode.begin();
+    paranode.onCommand([](const JsonObject &command)
+                       { sink++; });
+
+    Serial.println();
+    Serial.print("# profile,");
+    Serial.print(PARANODE_PROFILE_NAME);
+    Serial.print(",paranode_bytes,");
+    Serial.println((unsigned long)sizeof(Paranode));
+
+    Serial.println("bench,iterations,total_us,ns_per_op,bytes,heap_delta");
+
+    runBenchmark("json_builder", benchJsonBuilder);
+    runBenchmark("arduinojson_string", benchArduinoJson);
+
+    queue.clear();
+    runBenchmark("queue_enqueue", benchQueueEnqueue);
+    runBenchmark("queue_dequeue", benchQueueDequeue);
+    queue.clear();
+    runBenchmark("queue_batch", benchQueueBatch);
+    runBenchmark("queue_expire", benchQueueExpire, ITERATIONS / 10);
+
+    runBenchmark("dispatch_command", benchDispatchCommand);
+    runBenchmark("dispatch_config", benchDispatchConfig);
+    runBenchmark("dispatch_unknown", benchDispatchUnknown);
+
+    runBenchmark("send_data_float", benchSendDataFloat);
+    runBenchmark("send_data_int", benchSendDataInt);
+
+    Serial.println("# done");
+}
+
+void loop()
+{
+    delay(1000);
+}
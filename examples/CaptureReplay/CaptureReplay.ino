@@ -0,0 +1,184 @@
+/**
+ * @file CaptureReplay.ino
+ * @brief Record live server traffic and replay it through the dispatcher
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Step 1 (RECORD_MODE = true): connects to the server and records every
+ * inbound and outbound frame to /capture.pnc on LittleFS for a while.
+ *
+ * Step 2 (RECORD_MODE = false): no network needed. Replays the inbound
+ * frames of the capture through the socket receive path and the message
+ * dispatcher, either as fast as possible or with the recorded timing, and
+ * prints throughput as CSV:
+ *
+ *   mode,frames,bytes,total_us,frames_per_sec
+ *
+ * This gives parser and callback throughput on production-representative
+ * traffic instead of synthetic strings.
+ */
+
+#include <Paranode.h>
+#include <LittleFS.h>
+
+// true = record live traffic, false = replay /capture.pnc
+const bool RECORD_MODE = true;
+
+// How long to record (milliseconds)
+const unsigned long RECORD_DURATION = 10UL * 60UL * 1000UL;
+
+const char *WIFI_SSID = "yourWiFiSSID";
+const char *WIFI_PASSWORD = "yourWiFiPassword";
+const char *PROJECT_TOKEN = "your-project-token";
+
+const char *CAPTURE_PATH = "/capture.pnc";
+
+Paranode paranode(PROJECT_TOKEN);
+File captureFile;
+unsigned long recordStart = 0;
+unsigned long commandsHandled = 0;
+
+void setup()
+{
+    Serial.begin(115200);
+    delay(1000);
+
+#ifdef ESP32
+    if (!LittleFS.begin(true))
+#else
+    if (!LittleFS.begin())
+#endif
+    {
+        Serial.println("LittleFS mount failed");
+        while (1) delay(1000);
+    }
+
+    paranode.begin();
+
+    // Your real command handler - its cost is part of what gets measured
+    paranode.onCommand([](const JsonObject &command)
+                       { commandsHandled++; });
+
+    if (RECORD_MODE)
+    {
+        startRecording();
+    }
+    else
+    {
+        replay(false); // Full speed
+        replay(true);  // Recorded timing
+    }
+}
+
+void loop()
+{
+    paranode.loop();
+
+    if (RECORD_MODE && captureFile && millis() - recordStart > RECORD_DURATION)
+    {
+        paranode.stopCapture();
+        captureFile.close();
+        Serial.println("Capture complete - set RECORD_MODE = false to replay");
+    }
+}
+
+void startRecording()
+{
+    captureFile = LittleFS.open(CAPTURE_PATH, "w");
+    if (!captureFile)
+    {
+        Serial.println("Cannot create capture file");
+        return;
+    }
+
+    paranode.connectWifi(WIFI_SSID, WIFI_PASSWORD);
+    paranode.startCapture(captureFile);
+    paranode.connect();
+    recordStart = millis();
+
+    Serial.println("Recording traffic...");
+}
+
+void replay(bool realTime)
+{
+    File in = LittleFS.open(CAPTURE_PATH, "r");
+    if (!in)
+    {
+        Serial.println("No capture file - run with RECORD_MODE = true first");
+        return;
+    }
+
+    ParanodeCaptureReader reader(in);
+    if (!reader.begin())
+    {
+        Serial.println("Not a Paranode capture");
+        in.close();
+        return;
+    }
+
+    static char frame[2048];
+    ParanodeCaptureRecord record;
+    unsigned long frames = 0;
+    unsigned long bytes = 0;
+    unsigned long firstTimestamp = 0;
+    unsigned long busyUs = 0;
+    unsigned long replayStart = millis();
+    int length;
+
+    while ((length = reader.next(record, frame, sizeof(frame))) >= 0)
+    {
+        if (record.direction != PARANODE_CAPTURE_INBOUND)
+        {
+            continue;
+        }
+
+        if (frames == 0)
+        {
+            firstTimestamp = record.timestamp;
+        }
+
+        if (realTime)
+        {
+            // Wait until the frame's original offset from the first frame
+            while (millis() - replayStart < record.timestamp - firstTimestamp)
+            {
+                yield();
+            }
+        }
+
+        unsigned long start = micros();
+
+        // Behave like the server: wait for a receive credit. Queued commands
+        // run (and return their credit) in loop().
+        while (paranode.receiveCredits() == 0)
+        {
+            paranode.loop();
+        }
+        paranode.injectMessage(frame, length);
+        busyUs += micros() - start;
+
+        frames++;
+        bytes += length;
+        yield();
+    }
+    in.close();
+
+    // Commands still queued are part of the work
+    unsigned long drainStart = micros();
+    while (paranode.receiveCredits() < PARANODE_RECEIVE_CREDITS)
+    {
+        paranode.loop();
+    }
+    busyUs += micros() - drainStart;
+
+    Serial.println("mode,frames,bytes,total_us,frames_per_sec");
+    Serial.print(realTime ? "realtime" : "fullspeed");
+    Serial.print(',');
+    Serial.print(frames);
+    Serial.print(',');
+    Serial.print(bytes);
+    Serial.print(',');
+    Serial.print(busyUs);
+    Serial.print(',');
+    Serial.println(busyUs > 0 ? (frames * 1000000.0) / busyUs : 0.0, 1);
+}
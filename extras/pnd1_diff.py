@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+"""Reference encoder for PND1 delta OTA patches.
+
+Builds the patch ParanodeDeltaTarget applies (format in
+src/Paranode/OTA/ParanodeDelta.h) and prints the fields of the
+"ota_update" message that announces it:
+
+    pnd1_diff.py old.bin new.bin patch.pnd1
+
+old.bin is the image running on the device, new.bin the image to install.
+Every patch is decoded again and compared with new.bin before it is
+written. Matching is a simple bsdiff-style search over 8-byte anchors;
+production servers may use a stronger matcher, the format stays the same.
+
+    pnd1_diff.py --apply old.bin patch.pnd1 new.bin
+
+applies a patch the way the device does.
+
+Author: Muhammad Daffa
+Date: 2025-10-25
+"""
+
+import argparse
+import hashlib
+import struct
+import sys
+
+MAGIC = b"PND1"
+ANCHOR = 8         # Bytes hashed to find candidate matches in the old image
+CANDIDATES = 16    # Old positions kept per anchor
+MAX_RUN = 256      # Zero diff bytes per 0x00 n pair
+
+
+def index_old(old):
+    """Map each ANCHOR-byte string of the old image to where it occurs."""
+    index = {}
+    for pos in range(len(old) - ANCHOR + 1):
+        positions = index.setdefault(old[pos:pos + ANCHOR], [])
+        if len(positions) < CANDIDATES:
+            positions.append(pos)
+    return index
+
+
+def match_length(old, new, old_pos, new_pos):
+    length = 0
+    limit = min(len(old) - old_pos, len(new) - new_pos)
+    while length < limit and old[old_pos + length] == new[new_pos + length]:
+        length += 1
+    return length
+
+
+def best_match(old, new, index, scan):
+    """Longest exact match for new[scan:] among the anchor candidates."""
+    best_pos, best_len = 0, 0
+    for pos in index.get(new[scan:scan + ANCHOR], ()):
+        length = match_length(old, new, pos, scan)
+        if length > best_len:
+            best_pos, best_len = pos, length
+    return best_pos, best_len
+
+
+def forward_length(old, new, old_pos, new_start, new_end):
+    """How far the alignment old_pos <-> new_start is worth diffing.
+
+    Like bsdiff: the prefix where matching bytes outnumber the rest, so
+    mostly-equal code with shifted addresses still goes into the diff block.
+    """
+    score, best_score, best = 0, 0, 0
+    for i in range(new_end - new_start):
+        if old_pos + i >= len(old):
+            break
+        score += 1 if old[old_pos + i] == new[new_start + i] else -1
+        if score > best_score:
+            best_score, best = score, i + 1
+    return best
+
+
+def encode_diff(old, new, old_pos, new_pos, length):
+    """new - old byte-wise, with zero runs as 0x00 n (n + 1 zeros)."""
+    out = bytearray()
+    i = 0
+    while i < length:
+        diff = (new[new_pos + i] - old[old_pos + i]) & 0xFF
+        if diff:
+            out.append(diff)
+            i += 1
+            continue
+        run = 1
+        while run < MAX_RUN and i + run < length and new[new_pos + i + run] == old[old_pos + i + run]:
+            run += 1
+        out += bytes((0, run - 1))
+        i += run
+    return out
+
+
+def diff(old, new):
+    index = index_old(old)
+    patch = bytearray(MAGIC + struct.pack("<I", len(new)))
+
+    last_scan, last_pos = 0, 0   # Start of the pending triple and its old position
+    scan = 0
+    while scan < len(new):
+        pos, length = best_match(old, new, index, scan)
+        if length < ANCHOR or pos - scan == last_pos - last_scan:
+            # No anchor here, or the current alignment already covers it
+            scan += max(length, 1)
+            continue
+
+        diff_len = forward_length(old, new, last_pos, last_scan, scan)
+        extra_len = scan - last_scan - diff_len
+        seek = pos - (last_pos + diff_len)
+        patch += struct.pack("<IIi", diff_len, extra_len, seek)
+        patch += encode_diff(old, new, last_pos, last_scan, diff_len)
+        patch += new[last_scan + diff_len:scan]
+
+        last_scan, last_pos = scan, pos
+        scan += length
+
+    diff_len = forward_length(old, new, last_pos, last_scan, len(new))
+    extra_len = len(new) - last_scan - diff_len
+    patch += struct.pack("<IIi", diff_len, extra_len, 0)
+    patch += encode_diff(old, new, last_pos, last_scan, diff_len)
+    patch += new[last_scan + diff_len:]
+    return bytes(patch)
+
+
+def apply(old, patch):
+    """Decode a patch exactly as ParanodeDeltaTarget does."""
+    if patch[:4] != MAGIC:
+        raise ValueError("not a PND1 patch")
+    (size,) = struct.unpack_from("<I", patch, 4)
+    out = bytearray()
+    old_pos, p = 0, 8
+    while len(out) < size:
+        diff_len, extra_len, seek = struct.unpack_from("<IIi", patch, p)
+        p += 12
+        if len(out) + diff_len + extra_len > size:
+            raise ValueError("triple runs past the image size")
+        end = len(out) + diff_len
+        if old_pos < 0 or old_pos + diff_len > len(old):
+            raise ValueError("diff block reads outside the old image")
+        while len(out) < end:
+            byte = patch[p]
+            p += 1
+            if byte:
+                out.append((old[old_pos] + byte) & 0xFF)
+                old_pos += 1
+                continue
+            run = patch[p] + 1
+            p += 1
+            if len(out) + run > end:
+                raise ValueError("zero run crosses the diff block")
+            out += old[old_pos:old_pos + run]
+            old_pos += run
+        old_pos += seek
+        out += patch[p:p + extra_len]
+        p += extra_len
+    if p != len(patch):
+        raise ValueError("trailing bytes after the last triple")
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Build or apply a PND1 delta OTA patch")
+    parser.add_argument("--apply", action="store_true", help="apply PATCH to OLD and write NEW")
+    parser.add_argument("first", help="old image")
+    parser.add_argument("second", help="new image (or the patch with --apply)")
+    parser.add_argument("output", help="patch to write (or the new image with --apply)")
+    args = parser.parse_args()
+
+    with open(args.first, "rb") as f:
+        old = f.read()
+    with open(args.second, "rb") as f:
+        second = f.read()
+
+    if args.apply:
+        with open(args.output, "wb") as f:
+            f.write(apply(old, second))
+        return 0
+
+    new = second
+    if not new:
+        print("the new image is empty", file=sys.stderr)
+        return 1
+    patch = diff(old, new)
+    if apply(old, patch) != new:
+        print("internal error: patch does not rebuild the new image", file=sys.stderr)
+        return 1
+    with open(args.output, "wb") as f:
+        f.write(patch)
+
+    print('"delta":true,"size":%d,"sha256":"%s","imageSize":%d,"imageSha256":"%s"'
+          % (len(patch), hashlib.sha256(patch).hexdigest(), len(new), hashlib.sha256(new).hexdigest()))
+    print("patch is %.1f%% of the image" % (100.0 * len(patch) / max(len(new), 1)), file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -21,24 +21,93 @@
 #error "This library only supports ESP8266 and ESP32 boards."
 #endif
 
+#include "Paranode/ParanodeConfig.h"
 #include "Paranode/Connection/ParanodeConnection.h"
 #include "Paranode/Wifi/ParanodeWifi.h"
 #include "Paranode/Socket/ParanodeSocket.h"
 #include "Paranode/Utils/ParanodeJsonBuilder.h"
 #include "Paranode/Utils/ParanodeMessageQueue.h"
+#include "Paranode/Utils/ParanodeCapture.h"
+#include "Paranode/Utils/ParanodeTrace.h"
+#include "Paranode/Utils/ParanodeScratch.h"
+#include "Paranode/Utils/ParanodeBufferPool.h"
+#include "Paranode/Utils/ParanodeClock.h"
+#include "Paranode/Utils/ParanodeTuning.h"
+#include "Paranode/Utils/ParanodeMessageClass.h"
+#include "Paranode/Utils/ParanodeRateLimiter.h"
+#include "Paranode/Utils/ParanodeSampler.h"
+#include "Paranode/Utils/ParanodePressure.h"
+#include "Paranode/Utils/ParanodeCommandCache.h"
+#include "Paranode/Utils/ParanodeCommandQueue.h"
+#include "Paranode/Utils/ParanodeReceiveCredits.h"
+#include "Paranode/Utils/ParanodeSessionStore.h"
+#include "Paranode/Utils/ParanodeScheduler.h"
+#include "Paranode/OTA/ParanodeOTA.h"
 
 typedef std::function<void(const JsonObject &)> CommandCallback;
 typedef std::function<void(void)> ConnectionCallback;
 typedef std::function<void(const String &)> OTACallback;
 typedef std::function<void(int)> OTAProgressCallback;
+typedef std::function<void(ParanodePressureLevel)> PressureCallback;
+
+// Parse document whose pool comes from the scratch arena
+typedef BasicJsonDocument<ParanodeScratchAllocator> ParanodeScratchDocument;
+
+// A command callback may flush the queue while the parse document is live
+static_assert(PARANODE_SCRATCH_SIZE >= PARANODE_JSON_DOC_SIZE + PARANODE_MAX_MESSAGE_SIZE,
+              "PARANODE_SCRATCH_SIZE must hold the parse document plus one message buffer");
+
+/**
+ * @struct ParanodeStats
+ * @brief Outbound delivery counters since begin()
+ *
+ * generated = sent + failed + dropped + expired + throttled + (messages still queued)
+ */
+struct ParanodeStats
+{
+    uint32_t generated; // Messages handed to the send path
+    uint32_t sent;      // Messages written to the socket (batched ones counted individually)
+    uint32_t failed;    // Direct sends lost because the socket was down
+    uint32_t queued;    // Messages placed in the offline/batch queue
+    uint32_t requeued;  // Queued messages left in place by a failed write
+    uint32_t dropped;   // Queued messages discarded because the queue was full
+    uint32_t expired;   // Queued messages discarded by the TTL check
+    uint32_t connects;  // Successful server connections
+    uint32_t bufferExhausted; // Sends refused because every build buffer was leased
+    uint32_t throttled; // Messages dropped or coalesced away by the rate limiter
+    uint32_t shed;      // Readings skipped or aggregated by sampling rules (never generated)
+    uint32_t droppedByPriority[4]; // dropped, split by the priority of the discarded message
+};
 
 /**
- * @class Paranode
+ * @class BasicParanode
  * @brief Main class for the Paranode IoT platform
+ *
+ * Components are template parameters so alternatives compile to direct
+ * calls with no virtual dispatch:
+ *  - Transport: send(const char*), send(const char*, size_t), connect(url),
+ *    disconnect(), isConnected(), loop(), setExtraHeaders(const char*),
+ *    onConnect/onDisconnect(ConnectionCallback),
+ *    onRawMessage(RawMessageCallback), onBinaryMessage(BinaryMessageCallback),
+ *    injectMessage(), setCapture() - see ParanodeSocket
+ *  - Queue: enqueue/coalesce/removeExpired (taking Clock time), dequeue/
+ *    peekKind and their *Since variants, countBefore, batchBefore/batchSince/
+ *    discardBefore/discardSince, count/bytes/isEmpty/clear,
+ *    droppedCount/expiredCount - see ParanodeMessageQueue
+ *  - Encoder: constructed from (char*, size_t); reset, startObject/add.../
+ *    endObject, startNestedArray/endArray, hasSpace, getJson - see
+ *    ParanodeJsonBuilder
+ *  - Clock: static millis() and micros() - see ParanodeClock
+ *
+ * Most sketches use the Paranode typedef below. Other combinations must
+ * also include "Paranode/ParanodeImpl.h" in exactly one .cpp file and
+ * explicitly instantiate the class there.
  */
-class Paranode
+template<typename Transport, typename Queue, typename Encoder, typename Clock>
+class BasicParanode
 {
 public:
+#if PARANODE_ENABLE_LEGACY_AUTH
     /**
      * @brief Constructor (Legacy - for backward compatibility)
      * @param deviceId Unique identifier for the device
@@ -46,7 +115,8 @@ public:
      * @param serverUrl URL of the Paranode server
      * @deprecated Use Paranode(projectToken) for new projects
      */
-    Paranode(const String &deviceId, const String &secretKey, const String &serverUrl = "wss://api.paranode.io/ws");
+    BasicParanode(const String &deviceId, const String &secretKey, const String &serverUrl = "wss://api.paranode.io/ws");
+#endif
 
     /**
      * @brief Constructor with Project Token (Recommended)
@@ -61,7 +131,7 @@ public:
      *
      * Free tier includes 3 projects. Upgrade for unlimited projects.
      */
-    Paranode(const String &projectToken, bool useTokenAuth = true);
+    BasicParanode(const String &projectToken, bool useTokenAuth = true);
 
     /**
      * @brief Initialize the Paranode library
@@ -69,6 +139,22 @@ public:
      */
     bool begin();
 
+#if PARANODE_ENABLE_SESSION_STORE
+    /**
+     * @brief Check whether begin() restored the last session
+     * @return True if the device ID and config from the previous boot were applied;
+     *         config saved by another config schema or firmware version is not
+     * @note The server's replies still confirm or update the restored values,
+     *       so a sketch only needs requestConfig() when this returns false.
+     */
+    bool isSessionRestored() const;
+
+    /**
+     * @brief Forget the stored device ID and config
+     */
+    void clearSession();
+#endif
+
     /**
      * @brief Connect to WiFi
      * @param ssid WiFi SSID
@@ -95,8 +181,10 @@ public:
      * @param key Data key
      * @param value Data value (int, float, bool, String, const char*)
      * @param unit Optional unit of measurement
-     * @param useQueue If true, queue message for batching (default: false)
-     * @return True if data is sent successfully, false otherwise
+     * @param useQueue If true, the reading may wait for the next batch frame
+     *        (default: false, sent at once when connected)
+     * @return True if data is sent or queued (or shed by a sampling rule),
+     *         false otherwise
      */
     template<typename T>
     bool sendData(const char* key, const T& value, const char* unit = "", bool useQueue = false);
@@ -107,15 +195,21 @@ public:
     bool sendData(const String &key, const String &value, const String &unit = "");
     bool sendData(const String &key, bool value, const String &unit = "");
 
+#if PARANODE_ENABLE_JSON_OBJECT_API
     /**
      * @brief Send multiple telemetry points data to the server
      * @param json JSON object containing data points
-     * @return True if data is sent successfully, false otherwise
+     * @return True if data is sent or queued, false otherwise
      */
     bool sendData(const JsonObject &json);
+#endif
 
     /**
-     * @brief Flush queued messages (send all buffered messages)
+     * @brief Flush queued messages through the live/backlog scheduler
+     *
+     * With batching on this sends one batch frame (the auto-batch timer
+     * calls it); otherwise it sends what the scheduler's slow start and the
+     * rate limits allow.
      * @return Number of messages sent
      */
     int flushQueue();
@@ -132,26 +226,45 @@ public:
      */
     size_t getQueuedCount() const;
 
+    /**
+     * @brief Current outbound backpressure
+     * @return PARANODE_PRESSURE_NORMAL, _ELEVATED, _HIGH or _CRITICAL
+     * @note Computed in loop() from queue fill, growth and link state; this
+     *       only reads the last result.
+     */
+    ParanodePressureLevel pressure() const;
+
+    /**
+     * @brief Get outbound delivery counters
+     * @return Snapshot of the counters since begin()
+     * @note The same counters are reported to the server in every metrics
+     *       message, and telemetry carries a per-device "seq" number, so the
+     *       backend can compute loss and duplicate rates per device.
+     */
+    ParanodeStats getStats() const;
+
     /**
      * @brief Send device status update
      * @param status Device status (ONLINE, OFFLINE, MAINTENANCE, ERROR, UPDATING)
-     * @return True if status is sent successfully, false otherwise
+     * @return True if status is sent or queued, false otherwise
      */
     bool sendStatus(const String &status);
+    bool sendStatus(const char *status);
 
     /**
      * @brief Send error log to server
      * @param errorMessage Error message
      * @param errorCode Optional error code
-     * @return True if error is sent successfully, false otherwise
+     * @return True if error is sent or queued, false otherwise
      */
     bool sendError(const String &errorMessage, int errorCode = 0);
+    bool sendError(const char *errorMessage, int errorCode = 0);
 
     /**
      * @brief Send performance metrics
      * @param freeHeap Free heap memory
      * @param rssi WiFi RSSI value
-     * @return True if metrics are sent successfully, false otherwise
+     * @return True if metrics are sent or queued, false otherwise
      */
     bool sendMetrics(uint32_t freeHeap, int rssi);
 
@@ -159,6 +272,8 @@ public:
      * @brief Set device information
      * @param firmwareVersion Firmware version
      * @param hardwareVersion Hardware version
+     * @note Tuning restored by begin() that was saved by another firmware
+     *       version is replaced by the defaults here.
      */
     void setDeviceInfo(const String &firmwareVersion, const String &hardwareVersion);
 
@@ -174,6 +289,23 @@ public:
      */
     void onCommand(CommandCallback callback);
 
+    /**
+     * @brief Set how long loop() may spend running queued commands
+     * @param budgetMs Milliseconds per loop() (at least one command always
+     *        runs); 0 runs each command inside the WebSocket handler as it arrives
+     * @note Commands are queued by default, so a slow actuator never blocks
+     *       the socket and responses sent from the callback go out batched.
+     */
+    void setCommandBudget(unsigned long budgetMs);
+
+    /**
+     * @brief Inbound messages the device can take right now
+     * @return Receive credits not held by messages or queued commands
+     * @note The server is told its grant in "credits" messages; anything
+     *       replaying traffic into injectMessage() should wait for a credit.
+     */
+    uint16_t receiveCredits() const;
+
     /**
      * @brief Set callback for successful connection to the server
      * @param callback Function to be called when connection is established
@@ -186,6 +318,13 @@ public:
      */
     void onDisconnect(ConnectionCallback callback);
 
+    /**
+     * @brief Set callback for backpressure level changes
+     * @param callback Function called from loop() with the new level
+     */
+    void onPressureChange(PressureCallback callback);
+
+#if PARANODE_ENABLE_OTA
     /**
      * @brief Set callback for OTA update notifications
      * @param callback Function to be called when OTA update is available
@@ -198,6 +337,33 @@ public:
      */
     void onOTAProgress(OTAProgressCallback callback);
 
+    /**
+     * @brief Download updates over the Paranode connection instead of
+     *        handing the URL to onOTAUpdate
+     * @param enable Use the built-in downloader for updates that carry a
+     *        size and sha256
+     * @param autoRestart Restart into the new image once it is committed
+     */
+    void setOTAStreaming(bool enable, bool autoRestart = true);
+
+    /**
+     * @brief Write downloaded images somewhere other than the OTA partition
+     * @param target Target, or nullptr for the OTA partition
+     */
+    void setOTATarget(ParanodeUpdateTarget *target);
+
+    /**
+     * @brief Read the running image from somewhere else when applying deltas
+     * @param reader Reader, or nullptr for the running partition
+     */
+    void setOTAImageReader(ParanodeImageReader reader);
+
+    /**
+     * @brief State of the built-in downloader
+     */
+    ParanodeOTAState getOTAState() const;
+#endif
+
     /**
      * @brief Request configuration from server
      * @return True if request is sent successfully, false otherwise
@@ -210,8 +376,11 @@ public:
      * @param status Command execution status
      * @param response Optional response message
      * @return True if response is sent successfully, false otherwise
+     * @note The response is remembered and replayed if the server redelivers
+     *       the command, instead of running the command callback again.
      */
     bool sendCommandResponse(const String &commandId, const String &status, const String &response = "");
+    bool sendCommandResponse(const char *commandId, const char *status, const char *response = "");
 
     /**
      * @brief Enable/disable auto-reconnect
@@ -219,18 +388,102 @@ public:
      */
     void setAutoReconnect(bool enable);
 
+    /**
+     * @brief Set the base interval between reconnect attempts
+     * @param interval Interval in milliseconds (minimum 1000)
+     * @note Each device adds a fixed jitter of up to half the interval,
+     *       derived from its MAC address, so a fleet that loses the server
+     *       at the same moment does not reconnect in lockstep.
+     */
+    void setReconnectInterval(unsigned long interval);
+
     /**
      * @brief Set heartbeat interval
      * @param interval Interval in milliseconds (minimum 10000)
      */
     void setHeartbeatInterval(unsigned long interval);
 
+    /**
+     * @brief Get the current traffic parameters
+     * @return Intervals, batching and queue limits in effect
+     * @note The server can change these with a "config" message; see
+     *       ParanodeTuning for the field names and handleConfig() for bounds.
+     */
+    ParanodeTuning getTuning() const;
+
+    /**
+     * @brief Get the device ID
+     * @return The ID the server assigned (or restored from the last session);
+     *         empty until then. With legacy auth, the constructor's ID.
+     */
+    const char *getDeviceId() const;
+
+    /**
+     * @brief Limit how fast a message class is sent
+     * @param cls PARANODE_MSG_TELEMETRY, _STATUS, _ERROR or _METRICS
+     * @param perMinute Sustained rate, 0 = unlimited
+     * @param burst Messages that may go out at once (0 = ten seconds' worth)
+     * @note Limits from the project plan in auth_response replace these.
+     */
+    void setRateLimit(ParanodeMessageClass cls, uint32_t perMinute, uint32_t burst = 0);
+
+    /**
+     * @brief Choose what happens to messages over the limit
+     * @param cls Message class
+     * @param policy PARANODE_RATE_QUEUE (default for telemetry and errors),
+     *        PARANODE_RATE_COALESCE (default for status and metrics) or
+     *        PARANODE_RATE_DROP
+     */
+    void setRatePolicy(ParanodeMessageClass cls, ParanodeRatePolicy policy);
+
+    /**
+     * @brief Change how a message class is delivered
+     * @param cls Any class except PARANODE_MSG_CONTROL
+     * @param policy Queue priority, offline buffering, batching, urgent
+     *        lane, drop policy when the queue is full and TTL
+     */
+    void setClassPolicy(ParanodeMessageClass cls, const ParanodeClassPolicy &policy);
+    ParanodeClassPolicy getClassPolicy(ParanodeMessageClass cls) const;
+
+    /**
+     * @brief Split the send budget after a reconnect
+     * @param live Live messages sent per round
+     * @param backlog Bulk backlog frames sent per round; the backlog also
+     *        ramps up from one frame per interval after each reconnect
+     */
+    void setScheduleShares(uint8_t live, uint8_t backlog);
+
+    /**
+     * @brief Check whether a reading for this key would be sent now
+     * @param key Telemetry key
+     * @return False while a sampling rule would skip it, so the sketch can
+     *         skip the sensor read as well
+     */
+    bool shouldSample(const char* key);
+
+    /**
+     * @brief Set a sampling rule locally (the server's "sampling" message replaces all rules)
+     * @param key Telemetry key, or "*" for every key without its own rule
+     * @param minInterval Minimum ms between readings sent for the key
+     * @param mode PARANODE_SAMPLE_INTERVAL, PARANODE_SAMPLE_AGGREGATE or PARANODE_SAMPLE_DROP
+     * @param priority Queue priority for the key (0 = low, 2 = high)
+     * @return False if the rule table is full
+     */
+    bool setSamplingRule(const char* key, uint32_t minInterval,
+                         ParanodeSampleMode mode = PARANODE_SAMPLE_INTERVAL, uint8_t priority = 1);
+
+    /**
+     * @brief Remove all sampling rules
+     */
+    void clearSamplingRules();
+
     /**
      * @brief Get device uptime in seconds
      * @return Uptime in seconds
      */
     unsigned long getUptime();
 
+#if PARANODE_ENABLE_GEOLOCATION
     /**
      * @brief Send geolocation data
      * @param latitude Device latitude
@@ -239,6 +492,7 @@ public:
      * @return True if sent successfully
      */
     bool sendGeolocation(double latitude, double longitude, float accuracy = 0.0);
+#endif
 
     /**
      * @brief Request WiFi configuration change from server
@@ -253,12 +507,14 @@ public:
      */
     void onWiFiConfig(std::function<void(const String &ssid, const String &password)> callback);
 
+#if PARANODE_ENABLE_JSON_OBJECT_API
     /**
      * @brief Update device online status and metadata
      * @param metadata JSON object with additional device info (location, IP, etc.)
      * @return True if sent successfully
      */
     bool updateDeviceStatus(const JsonObject &metadata);
+#endif
 
     /**
      * @brief Get project information from server
@@ -272,12 +528,64 @@ public:
      */
     void loop();
 
+    /**
+     * @brief Feed a raw server frame into the message dispatcher
+     * @param message Frame payload (JSON text, not necessarily null-terminated)
+     * @param length Payload length in bytes
+     * @note The frame is handled exactly as if it had arrived on the socket.
+     *       Intended for benchmarks and replaying recorded traffic.
+     */
+    void injectMessage(const char *message, size_t length);
+
+    /**
+     * @brief Start recording all inbound and outbound frames
+     * @param out Destination for the capture (e.g. a LittleFS File)
+     * @note See ParanodeCapture.h for the format. Read it back with
+     *       ParanodeCaptureReader and replay inbound frames through
+     *       injectMessage().
+     */
+    void startCapture(Print &out);
+
+    /**
+     * @brief Stop recording frames
+     */
+    void stopCapture();
+
+    /**
+     * @brief Trace only every Nth telemetry message
+     * @param everyN Sampling interval (1 = every message)
+     * @note Tracing requires -DPARANODE_ENABLE_TRACE; without it the trace
+     *       functions do nothing.
+     */
+    void setTraceSampling(uint16_t everyN);
+
+    /**
+     * @brief Write recent message traces as Chrome trace-event JSON
+     * @param out Destination (Serial, File, ...)
+     */
+    void writeTrace(Print &out);
+
+    /**
+     * @brief Get per-stage latency percentiles of recent messages
+     * @param summary Output summary
+     */
+    void getTraceSummary(ParanodeTraceSummary &summary);
+
+    /**
+     * @brief Get peak stack depth and scratch arena use per entry point
+     * @param report Output report
+     */
+    void getStackReport(ParanodeStackReport &report) const;
+
 private:
-    String _deviceId;
+    // Identity fields use fixed storage so reconnects don't touch the heap
+    char _deviceId[PARANODE_MAX_ID_LENGTH];
+#if PARANODE_ENABLE_LEGACY_AUTH
     String _secretKey;
-    String _projectToken;
+#endif
+    char _projectToken[PARANODE_MAX_TOKEN_LENGTH];
     String _serverUrl;
-    String _macAddress;
+    char _macAddress[18];
     String _firmwareVersion;
     String _hardwareVersion;
     bool _isConnected;
@@ -286,125 +594,176 @@ private:
     bool _useTokenAuth;
     unsigned long _startTime;
 
+    // Resumable session: the token goes into the WebSocket upgrade, so a
+    // reconnect is authenticated as soon as it opens
+    char _sessionToken[PARANODE_MAX_TOKEN_LENGTH];
+    bool _sessionResumed;   // Current connection was authenticated by token
+    uint32_t _deviceInfoHash; // device_info the server already has
+
     ParanodeWifi _wifi;
-    ParanodeSocket _socket;
-    ParanodeConnection _connection;
-    ParanodeMessageQueue _messageQueue;
+    Transport _socket;
+    Queue _messageQueue;
+    ParanodeCapture _capture;
+    ParanodeTrace _trace;
+    ParanodeScratch _scratch;
+#if PARANODE_ENABLE_SESSION_STORE
+    ParanodeSessionStore _session;
+    bool _sessionRestored;
+    bool _tuningRestored;   // _tuning came from the store and no config has replaced it
+    bool _deviceInfoSet;
+    uint32_t _tuningFirmware; // Firmware hash the restored tuning was saved with
+#endif
 
     CommandCallback _commandCallback;
     ConnectionCallback _connectCallback;
     ConnectionCallback _disconnectCallback;
+#if PARANODE_ENABLE_OTA
     OTACallback _otaCallback;
     OTAProgressCallback _otaProgressCallback;
+
+    // Built-in downloader
+    ParanodeOTA _ota;
+    bool _otaStreaming;
+    bool _otaAutoRestart;
+    uint32_t _otaRequestedEnd;
+    unsigned long _otaLastRequest;
+    unsigned long _otaCompletedAt;
+    uint8_t _otaLastProgress;
+#endif
     std::function<void(const String &, const String &)> _wifiConfigCallback;
+    PressureCallback _pressureCallback;
+
+    // Intervals, batching and queue limits; replaced as a whole by config
+    ParanodeTuning _tuning;
+
+    // Per-class quota from the project plan
+    ParanodeRateLimiter _limiter;
+
+    // Priority, offline buffering and batching per message class
+    ParanodeClassPolicies _policies;
+
+    // Shares the send budget between live data and the outage backlog
+    ParanodeScheduler _scheduler;
+
+    // Per-key rules pushed by the server for load shedding
+    ParanodeSampler _sampler;
+
+    ParanodePressureGauge _pressure;
+
+    // Command IDs already run, so redelivered commands are answered, not re-run
+    ParanodeCommandCache _commands;
 
     unsigned long _lastHeartbeatTime;
-    unsigned long _heartbeatInterval;
     unsigned long _lastMetricsTime;
-    unsigned long _metricsInterval;
+    unsigned long _lastReconnectAttempt;
+    uint32_t _reconnectSeed;
+    unsigned long _lastExpiryCheck;
+
+    // Delivery accounting
+    ParanodeStats _stats;
+    uint32_t _sequence;
 
-    // Optimization: Reusable buffers to avoid repeated allocations
-    char _messageBuffer[PARANODE_MAX_MESSAGE_SIZE];
-    char _batchBuffer[1024];
+    // Optimization: Reusable buffers to avoid repeated allocations.
+    // Messages are built in leased pool buffers so nested sends are safe.
+    ParanodeBufferPool _bufferPool;
+    char _batchBuffer[PARANODE_BATCH_BUFFER_SIZE];
 
-    // Batching configuration
-    bool _batchingEnabled;
-    int _batchSize;
     unsigned long _lastBatchTime;
-    unsigned long _batchInterval;
 
-    void handleMessage(const String &message);
+    // Commands run from loop(); their responses are sent as one frame
+    ParanodeCommandQueue _commandQueue;
+    unsigned long _commandBudget;
+    bool _runningCommands;
+    char _responseBatch[PARANODE_MAX_MESSAGE_SIZE];
+    size_t _responseBatchLength;
+    uint8_t _responseBatchCount;
+
+    // command_batch_response being built in _responseBatch, while a batch runs
+    Encoder *_batchResponse;
+    const char *_batchResponseId;
+    bool _batchResultAdded;
+
+    // Inbound flow control; the message being handled, for its credit
+    ParanodeReceiveCredits _credits;
+    size_t _inboundLength;
+    bool _inboundDeferred;
+
+    void receiveMessage(const char *message, size_t length);
+    void sendCredits();
+    void rejectOverrun(const char *message, size_t length);
+    void handleMessage(const char *message, size_t length);
     void sendHeartbeat();
     bool authenticate();
-    void sendDeviceInfo();
+    void onAuthenticated();
+    void setSessionToken(const char *token);
+    bool sendDeviceInfo();
+    uint32_t deviceInfoHash();
+#if PARANODE_ENABLE_OTA
     void handleOTAUpdate(const JsonObject &update);
+    void handleBinaryMessage(const uint8_t *data, size_t length);
+    void requestOTAChunk();
+    void sendOTAStatus(const char *status, const char *error);
+    void serviceOTA(unsigned long currentTime);
+#endif
     void handleConfig(const JsonObject &config);
+    void applyProjectLimits(const JsonObject &project);
+    void handleSampling(const JsonObject &doc);
+    void handleCommand(const JsonObject &command);
+    void handleCommandBatch(const JsonObject &batch);
+    bool deferCommand(const JsonObject &command, ParanodeCommandKind kind);
+    void runCommands();
+    void runCommandBatch(const JsonObject &batch);
+    void startBatchResponse();
+    void appendBatchResult(const char *commandId, const char *status, const char *response);
+    void sendBatchResponse(bool more);
+    bool batchCommandResponse(const char *response);
+    void flushCommandResponses();
+    bool writeCommandResponse(const char *commandId, const char *status, const char *response, bool replayed);
+    void sendConfigAck(bool applied, const char *rejected, uint8_t ignored);
+#if PARANODE_ENABLE_SESSION_STORE
+    void restoreSession();
+    void saveSession();
+    void checkRestoredTuning();
+    const char *sessionOwner() const;
+#endif
     String getDefaultMacAddress();
-
-    // Optimized message sending
-    bool sendMessageDirect(const char* message);
-    bool sendMessageQueued(const char* message, uint8_t priority = 1);
+    static void copyField(char *dest, size_t size, const char *src);
+    static bool scanString(const char *json, size_t length, const char *key, char *dest, size_t size);
+
+    // Outbound pipeline: every message goes through sendMessage. PARANODE_MSG_CONTROL
+    // (handshake, credits, OTA) skips the limiter and the queue but is still
+    // counted and traced. priority -1 takes the class policy's; batchable
+    // false skips the batch wait.
+    bool sendMessage(const char* message, uint8_t cls, uint32_t seq = 0, int priority = -1,
+                     bool batchable = true);
+    bool throttleMessage(const char* message, uint8_t priority, uint32_t seq, uint8_t cls);
+    bool writeMessage(const char* message, uint32_t seq = 0);
     void processQueue();
-
-    // Template implementation helpers
-    template<typename T>
-    bool buildAndSendMessage(const char* key, const T& value, const char* unit, bool useQueue);
+    // Urgent lane, then live/backlog by the scheduler; returns messages sent
+    int sendQueued(char *buffer, int maxFrames, bool batchLive);
+    int sendBatch(ParanodeLane lane, int maxMessages);
+    // Live messages processQueue may send on their own while batching is on
+    static bool sendsAlone(void *context, uint8_t kind);
+
+    // Telemetry builders behind sendData<T>
+    bool buildAndSendMessage(const char* key, int value, const char* unit, bool useQueue);
+    bool buildAndSendMessage(const char* key, float value, const char* unit, bool useQueue);
+    bool buildAndSendMessage(const char* key, bool value, const char* unit, bool useQueue);
+    bool buildAndSendMessage(const char* key, const char* value, const char* unit, bool useQueue);
+    bool buildAndSendMessage(const char* key, const String& value, const char* unit, bool useQueue);
+    bool sendSummary(const char* key, const ParanodeSampleSummary& summary, const char* unit,
+                     bool useQueue, uint8_t priority);
 };
 
 // Template implementation (must be in header)
+template<typename Transport, typename Queue, typename Encoder, typename Clock>
 template<typename T>
-bool Paranode::sendData(const char* key, const T& value, const char* unit, bool useQueue) {
+bool BasicParanode<Transport, Queue, Encoder, Clock>::sendData(const char* key, const T& value, const char* unit, bool useQueue) {
     return buildAndSendMessage(key, value, unit, useQueue);
 }
 
-// Specialized template implementations
-template<>
-inline bool Paranode::buildAndSendMessage<int>(const char* key, const int& value, const char* unit, bool useQueue) {
-    ParanodeJsonBuilder builder(_messageBuffer, sizeof(_messageBuffer));
-    builder.startObject();
-    builder.addString("type", "telemetry");
-    builder.addString("key", key);
-    builder.addInt("value", value);
-    if (unit && unit[0] != '\0') {
-        builder.addString("unit", unit);
-    }
-    builder.addULong("timestamp", millis());
-    builder.endObject();
-
-    return useQueue ? sendMessageQueued(builder.getJson()) : sendMessageDirect(builder.getJson());
-}
-
-template<>
-inline bool Paranode::buildAndSendMessage<float>(const char* key, const float& value, const char* unit, bool useQueue) {
-    ParanodeJsonBuilder builder(_messageBuffer, sizeof(_messageBuffer));
-    builder.startObject();
-    builder.addString("type", "telemetry");
-    builder.addString("key", key);
-    builder.addFloat("value", value);
-    if (unit && unit[0] != '\0') {
-        builder.addString("unit", unit);
-    }
-    builder.addULong("timestamp", millis());
-    builder.endObject();
-
-    return useQueue ? sendMessageQueued(builder.getJson()) : sendMessageDirect(builder.getJson());
-}
+// Today's components; compiled once in Paranode.cpp
+typedef BasicParanode<ParanodeSocket, ParanodeMessageQueue, ParanodeJsonBuilder, ParanodeClock> Paranode;
+extern template class BasicParanode<ParanodeSocket, ParanodeMessageQueue, ParanodeJsonBuilder, ParanodeClock>;
 
-template<>
-inline bool Paranode::buildAndSendMessage<bool>(const char* key, const bool& value, const char* unit, bool useQueue) {
-    ParanodeJsonBuilder builder(_messageBuffer, sizeof(_messageBuffer));
-    builder.startObject();
-    builder.addString("type", "telemetry");
-    builder.addString("key", key);
-    builder.addBool("value", value);
-    if (unit && unit[0] != '\0') {
-        builder.addString("unit", unit);
-    }
-    builder.addULong("timestamp", millis());
-    builder.endObject();
-
-    return useQueue ? sendMessageQueued(builder.getJson()) : sendMessageDirect(builder.getJson());
-}
-
-template<>
-inline bool Paranode::buildAndSendMessage<const char*>(const char* key, const char* const& value, const char* unit, bool useQueue) {
-    ParanodeJsonBuilder builder(_messageBuffer, sizeof(_messageBuffer));
-    builder.startObject();
-    builder.addString("type", "telemetry");
-    builder.addString("key", key);
-    builder.addString("value", value);
-    if (unit && unit[0] != '\0') {
-        builder.addString("unit", unit);
-    }
-    builder.addULong("timestamp", millis());
-    builder.endObject();
-
-    return useQueue ? sendMessageQueued(builder.getJson()) : sendMessageDirect(builder.getJson());
-}
-
-template<>
-inline bool Paranode::buildAndSendMessage<String>(const char* key, const String& value, const char* unit, bool useQueue) {
-    return buildAndSendMessage(key, value.c_str(), unit, useQueue);
-}
-
-#endif
\ No newline at end of file
+#endif
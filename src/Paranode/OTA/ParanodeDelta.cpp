@@ -0,0 +1,308 @@
+/**
+ * @file ParanodeDelta.cpp
+ * @brief Implementation of streaming delta application
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "ParanodeDelta.h"
+#include "Paranode/ParanodeConfig.h"
+
+#if PARANODE_ENABLE_OTA
+
+#ifdef ESP32
+#include <esp_ota_ops.h>
+#endif
+
+static uint32_t readU32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+bool paranodeReadRunningImage(uint32_t offset, uint8_t *buffer, size_t length)
+{
+#ifdef ESP32
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    if (!running || offset + length > running->size)
+    {
+        return false;
+    }
+    return esp_partition_read(running, offset, buffer, length) == ESP_OK;
+#else
+    // The sketch image starts at flash offset 0; flashRead wants aligned words
+    uint32_t block[16];
+    while (length > 0)
+    {
+        uint32_t base = offset & ~3u;
+        uint32_t skip = offset - base;
+        size_t take = sizeof(block) - skip;
+        if (take > length)
+        {
+            take = length;
+        }
+
+        if (!ESP.flashRead(base, block, sizeof(block)))
+        {
+            return false;
+        }
+        memcpy(buffer, (uint8_t *)block + skip, take);
+
+        buffer += take;
+        offset += take;
+        length -= take;
+    }
+    return true;
+#endif
+}
+
+ParanodeDeltaTarget::ParanodeDeltaTarget() : _output(nullptr),
+                                             _reader(nullptr),
+                                             _imageSize(0),
+                                             _patchRemaining(0),
+                                             _stage(STAGE_HEADER),
+                                             _headerLength(0),
+                                             _remaining(0),
+                                             _extraLength(0),
+                                             _seek(0),
+                                             _oldPosition(0),
+                                             _produced(0),
+                                             _zeroRun(0),
+                                             _runPending(false),
+                                             _bufferLength(0)
+{
+    memset(_expected, 0, sizeof(_expected));
+}
+
+void ParanodeDeltaTarget::configure(ParanodeUpdateTarget *output, ParanodeImageReader reader,
+                                    uint32_t imageSize, const uint8_t imageSha256[PARANODE_SHA256_SIZE])
+{
+    _output = output;
+    _reader = reader ? reader : paranodeReadRunningImage;
+    _imageSize = imageSize;
+    memcpy(_expected, imageSha256, sizeof(_expected));
+}
+
+bool ParanodeDeltaTarget::begin(uint32_t size)
+{
+    _stage = STAGE_HEADER;
+    _headerLength = 0;
+    _remaining = 0;
+    _oldPosition = 0;
+    _produced = 0;
+    _zeroRun = 0;
+    _runPending = false;
+    _bufferLength = 0;
+    _sha.reset();
+    _patchRemaining = size;
+
+    // size is the patch size, at least its header; the output needs the image size
+    return _output && _imageSize > 0 && size >= 8 && _output->begin(_imageSize);
+}
+
+bool ParanodeDeltaTarget::flush()
+{
+    if (_bufferLength == 0)
+    {
+        return true;
+    }
+    bool ok = _output->write(_buffer, _bufferLength);
+    _bufferLength = 0;
+    return ok;
+}
+
+bool ParanodeDeltaTarget::write(const uint8_t *data, size_t length)
+{
+    if (length > _patchRemaining)
+    {
+        return false;
+    }
+    _patchRemaining -= length;
+
+    // A zero run can still be producing after the last input byte
+    while (length > 0 || _zeroRun > 0)
+    {
+        if (_stage == STAGE_HEADER || _stage == STAGE_CONTROL)
+        {
+            size_t want = (_stage == STAGE_HEADER ? 8 : 12) - _headerLength;
+            size_t take = length < want ? length : want;
+            memcpy(_header + _headerLength, data, take);
+            _headerLength += take;
+            data += take;
+            length -= take;
+
+            if (_headerLength < (_stage == STAGE_HEADER ? 8 : 12))
+            {
+                continue;
+            }
+            _headerLength = 0;
+
+            if (_stage == STAGE_HEADER)
+            {
+                if (memcmp(_header, "PND1", 4) != 0 || readU32(_header + 4) != _imageSize)
+                {
+                    return false;
+                }
+                _stage = STAGE_CONTROL;
+                continue;
+            }
+
+            uint32_t diffLength = readU32(_header);
+            _extraLength = readU32(_header + 4);
+            _seek = (int32_t)readU32(_header + 8);
+            if ((uint64_t)_produced + diffLength + _extraLength > _imageSize)
+            {
+                return false;
+            }
+
+            _remaining = diffLength;
+            _stage = diffLength > 0 ? STAGE_DIFF : STAGE_EXTRA;
+            if (_stage == STAGE_EXTRA)
+            {
+                _remaining = _extraLength;
+                _oldPosition += _seek;
+                if (_remaining == 0)
+                {
+                    _stage = STAGE_CONTROL;
+                }
+            }
+            continue;
+        }
+
+        // Flush lazily, so the tail of the image is still buffered when
+        // end() verifies the hash
+        if (_bufferLength == sizeof(_buffer) && !flush())
+        {
+            return false;
+        }
+
+        size_t take = sizeof(_buffer) - _bufferLength;
+        if (take > _remaining)
+        {
+            take = _remaining;
+        }
+        uint8_t *out = _buffer + _bufferLength;
+
+        if (_stage == STAGE_DIFF)
+        {
+            // Diff bytes are zero-run encoded: 0x00 n = n + 1 unchanged bytes
+            if (_zeroRun == 0)
+            {
+                if (_runPending)
+                {
+                    _zeroRun = data[0] + 1u;
+                    _runPending = false;
+                    data++;
+                    length--;
+                    if (_zeroRun > _remaining)
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+                if (data[0] == 0)
+                {
+                    _runPending = true;
+                    data++;
+                    length--;
+                    continue;
+                }
+            }
+
+            if (_zeroRun > 0)
+            {
+                if (take > _zeroRun)
+                {
+                    take = _zeroRun;
+                }
+                if (!_reader(_oldPosition, out, take))
+                {
+                    return false;
+                }
+                _zeroRun -= take;
+            }
+            else
+            {
+                // Literal diff bytes up to the next run marker
+                size_t literal = 0;
+                while (literal < take && literal < length && data[literal] != 0)
+                {
+                    literal++;
+                }
+                take = literal;
+
+                if (!_reader(_oldPosition, out, take))
+                {
+                    return false;
+                }
+                for (size_t i = 0; i < take; i++)
+                {
+                    out[i] += data[i];
+                }
+                data += take;
+                length -= take;
+            }
+            _oldPosition += take;
+        }
+        else
+        {
+            if (take > length)
+            {
+                take = length;
+            }
+            memcpy(out, data, take);
+            data += take;
+            length -= take;
+        }
+
+        _sha.update(out, take);
+        _bufferLength += take;
+        _produced += take;
+        _remaining -= take;
+
+        if (_remaining == 0)
+        {
+            if (_stage == STAGE_DIFF)
+            {
+                _stage = STAGE_EXTRA;
+                _remaining = _extraLength;
+                _oldPosition += _seek;
+            }
+            if (_remaining == 0)
+            {
+                _stage = STAGE_CONTROL;
+            }
+        }
+    }
+    return true;
+}
+
+bool ParanodeDeltaTarget::end()
+{
+    if (_stage != STAGE_CONTROL || _headerLength != 0 || _produced != _imageSize || _patchRemaining != 0)
+    {
+        abort();
+        return false;
+    }
+
+    uint8_t digest[PARANODE_SHA256_SIZE];
+    _sha.finish(digest);
+    if (memcmp(digest, _expected, sizeof(digest)) != 0)
+    {
+        // The last bytes are still buffered, so the output is incomplete
+        abort();
+        return false;
+    }
+
+    return flush() && _output->end();
+}
+
+void ParanodeDeltaTarget::abort()
+{
+    _bufferLength = 0;
+    if (_output)
+    {
+        _output->abort();
+    }
+}
+
+#endif
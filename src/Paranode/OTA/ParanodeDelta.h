@@ -0,0 +1,112 @@
+/**
+ * @file ParanodeDelta.h
+ * @brief Streaming delta (binary patch) application for OTA updates
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Patch format "PND1" (bsdiff-style control triples):
+ *
+ *   "PND1" | newSize u32
+ *   repeat until newSize bytes are produced:
+ *     diffLen u32 | extraLen u32 | seek i32        (little-endian)
+ *     diff data:  decodes to diffLen bytes, new = old[oldPos++] + diff
+ *                 (byte-wise, mod 256); a 0x00 byte is followed by a count
+ *                 n and stands for n + 1 zero diff bytes
+ *     extraLen bytes: copied to the output as-is
+ *     oldPos += seek
+ *
+ * oldPos starts at 0. A zero run never crosses the end of its diff block,
+ * and the patch ends exactly after the triple that completes newSize bytes.
+ * extras/pnd1_diff.py is the reference encoder (and a decoder to check it).
+ *
+ * The patch is consumed as it arrives, the old image is read through a
+ * callback, and the new image is written to an inner update target, so RAM
+ * use is fixed (PARANODE_DELTA_BUFFER_SIZE plus a 64-byte flash read block)
+ * regardless of image size.
+ */
+
+#ifndef PARANODE_DELTA_H
+#define PARANODE_DELTA_H
+
+#include <Arduino.h>
+#include <functional>
+#include "Paranode/Utils/ParanodeSha256.h"
+#include "Paranode/OTA/ParanodeUpdateTarget.h"
+
+// Output staged between flash writes
+#ifndef PARANODE_DELTA_BUFFER_SIZE
+#define PARANODE_DELTA_BUFFER_SIZE 256
+#endif
+
+/**
+ * @brief Reads the currently running image
+ * @return False if the range can't be read
+ */
+typedef std::function<bool(uint32_t offset, uint8_t *buffer, size_t length)> ParanodeImageReader;
+
+/**
+ * @brief Default reader: the running app partition (ESP32) or sketch (ESP8266)
+ */
+bool paranodeReadRunningImage(uint32_t offset, uint8_t *buffer, size_t length);
+
+/**
+ * @class ParanodeDeltaTarget
+ * @brief Update target that turns patch bytes into new-image bytes
+ */
+class ParanodeDeltaTarget : public ParanodeUpdateTarget
+{
+public:
+    ParanodeDeltaTarget();
+
+    /**
+     * @brief Set up the next patch
+     * @param output Target receiving the new image
+     * @param reader Source of the old image
+     * @param imageSize Size of the new image
+     * @param imageSha256 Expected SHA-256 of the new image
+     */
+    void configure(ParanodeUpdateTarget *output, ParanodeImageReader reader,
+                   uint32_t imageSize, const uint8_t imageSha256[PARANODE_SHA256_SIZE]);
+
+    /**
+     * @param size Patch size; more patch bytes than this are refused
+     */
+    bool begin(uint32_t size) override;
+    bool write(const uint8_t *data, size_t length) override;
+    bool end() override;
+    void abort() override;
+
+private:
+    enum Stage
+    {
+        STAGE_HEADER,
+        STAGE_CONTROL,
+        STAGE_DIFF,
+        STAGE_EXTRA
+    };
+
+    ParanodeUpdateTarget *_output;
+    ParanodeImageReader _reader;
+    ParanodeSha256 _sha;
+    uint8_t _expected[PARANODE_SHA256_SIZE];
+    uint32_t _imageSize;
+    uint32_t _patchRemaining; // Patch bytes announced by begin() not yet written
+
+    Stage _stage;
+    uint8_t _header[12];
+    uint8_t _headerLength;
+    uint32_t _remaining; // Bytes left in the current diff/extra block
+    uint32_t _extraLength;
+    int32_t _seek;
+    uint32_t _oldPosition;
+    uint32_t _produced;
+    uint32_t _zeroRun;    // Unchanged bytes still to copy from the old image
+    bool _runPending;     // Saw 0x00, waiting for the run length
+
+    uint8_t _buffer[PARANODE_DELTA_BUFFER_SIZE];
+    size_t _bufferLength;
+
+    bool flush();
+};
+
+#endif
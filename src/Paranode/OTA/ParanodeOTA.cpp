@@ -0,0 +1,186 @@
+/**
+ * @file ParanodeOTA.cpp
+ * @brief Implementation of the WebSocket OTA download
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "ParanodeOTA.h"
+
+#if PARANODE_ENABLE_OTA
+
+ParanodeOTA::ParanodeOTA() : _output(&_flash),
+                             _target(&_flash),
+                             _imageReader(nullptr),
+                             _size(0),
+                             _offset(0),
+                             _state(PARANODE_OTA_IDLE),
+                             _error("")
+{
+    _id[0] = '\0';
+    memset(_expected, 0, sizeof(_expected));
+}
+
+void ParanodeOTA::setTarget(ParanodeUpdateTarget *target)
+{
+    if (isActive())
+    {
+        return;
+    }
+    _output = target ? target : &_flash;
+    _target = _output;
+}
+
+void ParanodeOTA::setImageReader(ParanodeImageReader reader)
+{
+    _imageReader = reader;
+}
+
+bool ParanodeOTA::start(const char *id, uint32_t size, const char *sha256Hex)
+{
+    uint8_t expected[PARANODE_SHA256_SIZE];
+    if (!id || size == 0 || !ParanodeSha256::parseHex(sha256Hex, expected))
+    {
+        fail("invalid update");
+        return false;
+    }
+
+    return begin(id, size, expected, _output);
+}
+
+bool ParanodeOTA::startDelta(const char *id, uint32_t patchSize, const char *patchSha256Hex,
+                             uint32_t imageSize, const char *imageSha256Hex)
+{
+    uint8_t expected[PARANODE_SHA256_SIZE];
+    uint8_t imageExpected[PARANODE_SHA256_SIZE];
+    if (!id || patchSize == 0 || imageSize == 0 ||
+        !ParanodeSha256::parseHex(patchSha256Hex, expected) ||
+        !ParanodeSha256::parseHex(imageSha256Hex, imageExpected))
+    {
+        fail("invalid update");
+        return false;
+    }
+
+    // Only sets parameters; state is reset by begin(), so resuming is unaffected
+    _delta.configure(_output, _imageReader, imageSize, imageExpected);
+    return begin(id, patchSize, expected, &_delta);
+}
+
+bool ParanodeOTA::begin(const char *id, uint32_t size, const uint8_t expected[PARANODE_SHA256_SIZE],
+                        ParanodeUpdateTarget *target)
+{
+    // Same update offered again (e.g. after a reconnect): keep going
+    if (isActive() && strcmp(id, _id) == 0 && size == _size && target == _target &&
+        memcmp(expected, _expected, PARANODE_SHA256_SIZE) == 0)
+    {
+        return true;
+    }
+
+    if (isActive())
+    {
+        _target->abort();
+    }
+
+    _target = target;
+    strncpy(_id, id, sizeof(_id) - 1);
+    _id[sizeof(_id) - 1] = '\0';
+    memcpy(_expected, expected, sizeof(_expected));
+    _size = size;
+    _offset = 0;
+    _sha.reset();
+    _error = "";
+
+    if (!_target->begin(size))
+    {
+        fail("begin failed");
+        return false;
+    }
+
+    _state = PARANODE_OTA_DOWNLOADING;
+    return true;
+}
+
+bool ParanodeOTA::handleFrame(const uint8_t *frame, size_t length)
+{
+    if (!isActive() || length < 4)
+    {
+        return false;
+    }
+
+    uint32_t offset = (uint32_t)frame[0] | ((uint32_t)frame[1] << 8) |
+                      ((uint32_t)frame[2] << 16) | ((uint32_t)frame[3] << 24);
+    if (offset != _offset)
+    {
+        return false;
+    }
+
+    const uint8_t *data = frame + 4;
+    size_t dataLength = length - 4;
+    if (dataLength == 0 || dataLength > _size - _offset)
+    {
+        fail("chunk overruns image");
+        return false;
+    }
+
+    _sha.update(data, dataLength);
+
+    if (_offset + dataLength == _size)
+    {
+        // Verify before the final bytes reach the target
+        uint8_t digest[PARANODE_SHA256_SIZE];
+        _sha.finish(digest);
+        if (memcmp(digest, _expected, sizeof(digest)) != 0)
+        {
+            fail("sha256 mismatch");
+            return false;
+        }
+    }
+
+    if (!_target->write(data, dataLength))
+    {
+        fail("write failed");
+        return false;
+    }
+    _offset += dataLength;
+
+    if (_offset == _size)
+    {
+        if (!_target->end())
+        {
+            _state = PARANODE_OTA_FAILED;
+            _error = "commit failed";
+            return false;
+        }
+        _state = PARANODE_OTA_COMPLETE;
+    }
+    return true;
+}
+
+void ParanodeOTA::abort()
+{
+    if (isActive())
+    {
+        fail("aborted");
+    }
+}
+
+uint8_t ParanodeOTA::progress() const
+{
+    if (_size == 0)
+    {
+        return 0;
+    }
+    return (uint8_t)(((uint64_t)_offset * 100) / _size);
+}
+
+void ParanodeOTA::fail(const char *error)
+{
+    if (isActive())
+    {
+        _target->abort();
+    }
+    _state = PARANODE_OTA_FAILED;
+    _error = error;
+}
+
+#endif
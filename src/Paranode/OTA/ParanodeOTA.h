@@ -0,0 +1,142 @@
+/**
+ * @file ParanodeOTA.h
+ * @brief Firmware download over the Paranode WebSocket connection
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * The image is pulled in windows of PARANODE_OTA_WINDOW_SIZE bytes with
+ * "ota_chunk_request" messages and arrives as binary frames:
+ *
+ *   [offset: 4 bytes little-endian][up to PARANODE_OTA_CHUNK_SIZE image bytes]
+ *
+ * Each chunk is hashed and written straight to the update target; only the
+ * offset of fully written data advances, so after a reconnect the download
+ * resumes from there. That offset and the hash state are RAM only: after a
+ * reset the download starts again from zero. The SHA-256 is checked before the last chunk is
+ * written, so a corrupt image never reaches the commit step.
+ */
+
+#ifndef PARANODE_OTA_H
+#define PARANODE_OTA_H
+
+#include <Arduino.h>
+#include "Paranode/ParanodeConfig.h"
+#include "Paranode/Utils/ParanodeSha256.h"
+#include "Paranode/OTA/ParanodeUpdateTarget.h"
+#include "Paranode/OTA/ParanodeDelta.h"
+
+// Largest image payload per binary frame
+#ifndef PARANODE_OTA_CHUNK_SIZE
+#define PARANODE_OTA_CHUNK_SIZE 1024
+#endif
+
+// Bytes requested per ota_chunk_request
+#ifndef PARANODE_OTA_WINDOW_SIZE
+#define PARANODE_OTA_WINDOW_SIZE 8192
+#endif
+
+// Re-request the current window if nothing arrives for this long (ms)
+#ifndef PARANODE_OTA_CHUNK_TIMEOUT
+#define PARANODE_OTA_CHUNK_TIMEOUT 10000
+#endif
+
+#define PARANODE_OTA_MAX_ID_LENGTH 40
+
+enum ParanodeOTAState
+{
+    PARANODE_OTA_IDLE = 0,
+    PARANODE_OTA_DOWNLOADING,
+    PARANODE_OTA_COMPLETE,
+    PARANODE_OTA_FAILED
+};
+
+/**
+ * @class ParanodeOTA
+ * @brief Download state machine; the caller sends the chunk requests
+ */
+class ParanodeOTA
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    ParanodeOTA();
+
+    /**
+     * @brief Use a different update target
+     * @param target Target, or nullptr for the flash partition
+     */
+    void setTarget(ParanodeUpdateTarget *target);
+
+    /**
+     * @brief Start (or resume) a download
+     * @param id Update identifier from the server
+     * @param size Image size in bytes
+     * @param sha256Hex Expected SHA-256 as 64 hex characters
+     * @return True if downloading; an identical update already in progress
+     *         keeps its offset
+     */
+    bool start(const char *id, uint32_t size, const char *sha256Hex);
+
+    /**
+     * @brief Start (or resume) a delta update
+     * @param id Update identifier from the server
+     * @param patchSize Patch size in bytes (what gets downloaded)
+     * @param patchSha256Hex Expected SHA-256 of the patch
+     * @param imageSize Size of the resulting image
+     * @param imageSha256Hex Expected SHA-256 of the resulting image
+     * @see ParanodeDelta.h for the patch format
+     */
+    bool startDelta(const char *id, uint32_t patchSize, const char *patchSha256Hex,
+                    uint32_t imageSize, const char *imageSha256Hex);
+
+    /**
+     * @brief Source of the running image for delta updates
+     * @param reader Reader, or nullptr for the running partition
+     */
+    void setImageReader(ParanodeImageReader reader);
+
+    /**
+     * @brief Consume a binary frame
+     * @return True if the frame advanced the download. Frames for another
+     *         offset (duplicates after a re-request) are ignored.
+     */
+    bool handleFrame(const uint8_t *frame, size_t length);
+
+    /**
+     * @brief Abandon the download
+     */
+    void abort();
+
+    ParanodeOTAState state() const { return _state; }
+    bool isActive() const { return _state == PARANODE_OTA_DOWNLOADING; }
+    const char *id() const { return _id; }
+    uint32_t offset() const { return _offset; }
+    uint32_t size() const { return _size; }
+    const char *error() const { return _error; }
+
+    /**
+     * @brief Download progress (0-100)
+     */
+    uint8_t progress() const;
+
+private:
+    ParanodeFlashTarget _flash;
+    ParanodeUpdateTarget *_output; // Final destination (flash unless overridden)
+    ParanodeUpdateTarget *_target; // _output, or _delta in front of it
+    ParanodeDeltaTarget _delta;
+    ParanodeImageReader _imageReader;
+    ParanodeSha256 _sha;
+    uint8_t _expected[PARANODE_SHA256_SIZE];
+    char _id[PARANODE_OTA_MAX_ID_LENGTH];
+    uint32_t _size;
+    uint32_t _offset;
+    ParanodeOTAState _state;
+    const char *_error;
+
+    void fail(const char *error);
+    bool begin(const char *id, uint32_t size, const uint8_t expected[PARANODE_SHA256_SIZE],
+               ParanodeUpdateTarget *target);
+};
+
+#endif
@@ -0,0 +1,45 @@
+/**
+ * @file ParanodeUpdateTarget.cpp
+ * @brief Flash update target
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "ParanodeUpdateTarget.h"
+#include "Paranode/ParanodeConfig.h"
+
+#if PARANODE_ENABLE_OTA
+
+#ifdef ESP8266
+#include <Updater.h>
+#elif defined(ESP32)
+#include <Update.h>
+#endif
+
+bool ParanodeFlashTarget::begin(uint32_t size)
+{
+    return Update.begin(size);
+}
+
+bool ParanodeFlashTarget::write(const uint8_t *data, size_t length)
+{
+    return Update.write(const_cast<uint8_t *>(data), length) == length;
+}
+
+bool ParanodeFlashTarget::end()
+{
+    return Update.end();
+}
+
+void ParanodeFlashTarget::abort()
+{
+#ifdef ESP32
+    Update.abort();
+#else
+    // Fails (and resets the updater) while bytes are still outstanding;
+    // ParanodeOTA never writes the last chunk of an image it rejects
+    Update.end(false);
+#endif
+}
+
+#endif
@@ -0,0 +1,80 @@
+/**
+ * @file ParanodeUpdateTarget.h
+ * @brief Destinations for downloaded firmware images
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#ifndef PARANODE_UPDATE_TARGET_H
+#define PARANODE_UPDATE_TARGET_H
+
+#include <Arduino.h>
+
+/**
+ * @class ParanodeUpdateTarget
+ * @brief Where downloaded image bytes go
+ */
+class ParanodeUpdateTarget
+{
+public:
+    virtual ~ParanodeUpdateTarget() {}
+
+    /**
+     * @brief Prepare for an image of the given size
+     */
+    virtual bool begin(uint32_t size) = 0;
+
+    /**
+     * @brief Write the next bytes of the image
+     */
+    virtual bool write(const uint8_t *data, size_t length) = 0;
+
+    /**
+     * @brief Make the complete, verified image bootable
+     */
+    virtual bool end() = 0;
+
+    /**
+     * @brief Discard a partial image
+     */
+    virtual void abort() = 0;
+};
+
+/**
+ * @class ParanodeFlashTarget
+ * @brief Writes to the inactive OTA partition through the core's Update
+ */
+class ParanodeFlashTarget : public ParanodeUpdateTarget
+{
+public:
+    bool begin(uint32_t size) override;
+    bool write(const uint8_t *data, size_t length) override;
+    bool end() override;
+    void abort() override;
+};
+
+/**
+ * @class ParanodeStreamTarget
+ * @brief Writes the image to any Print (a LittleFS/SD File, a host file)
+ *
+ * Stand-in for the flash partition when testing the download path.
+ */
+class ParanodeStreamTarget : public ParanodeUpdateTarget
+{
+public:
+    /**
+     * @param capacity Largest image accepted, 0 = no limit (e.g. free space on the file system)
+     */
+    explicit ParanodeStreamTarget(Print &out, uint32_t capacity = 0) : _out(out), _capacity(capacity) {}
+
+    bool begin(uint32_t size) override { return _capacity == 0 || size <= _capacity; }
+    bool write(const uint8_t *data, size_t length) override { return _out.write(data, length) == length; }
+    bool end() override { _out.flush(); return true; }
+    void abort() override {}
+
+private:
+    Print &_out;
+    uint32_t _capacity;
+};
+
+#endif
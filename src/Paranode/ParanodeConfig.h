@@ -0,0 +1,202 @@
+/**
+ * @file ParanodeConfig.h
+ * @brief Footprint profiles and feature switches
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Pick one profile as a global build flag (it must reach the library's own
+ * translation units, so a #define in the sketch is not enough):
+ *
+ *   -DPARANODE_PROFILE_TINY      ESP8266 / small SKUs
+ *   -DPARANODE_PROFILE_STANDARD  default
+ *   -DPARANODE_PROFILE_GATEWAY   ESP32 gateways with large backlogs
+ *
+ * OPTIMIZATION.md lists each profile's sizeof(Paranode), measured by the
+ * host build.
+ *
+ * A profile only supplies defaults; any individual macro set on the command
+ * line wins. Sizes are chosen together so the scratch arena always holds the
+ * parse document plus one message buffer.
+ */
+
+#ifndef PARANODE_CONFIG_H
+#define PARANODE_CONFIG_H
+
+#if (defined(PARANODE_PROFILE_TINY) + defined(PARANODE_PROFILE_STANDARD) + defined(PARANODE_PROFILE_GATEWAY)) > 1
+#error "Define only one PARANODE_PROFILE_*"
+#endif
+
+#if defined(PARANODE_PROFILE_TINY)
+
+#define PARANODE_PROFILE_NAME "tiny"
+#ifndef PARANODE_QUEUE_SIZE
+#define PARANODE_QUEUE_SIZE 6
+#endif
+#ifndef PARANODE_MAX_MESSAGE_SIZE
+#define PARANODE_MAX_MESSAGE_SIZE 192
+#endif
+#ifndef PARANODE_BATCH_BUFFER_SIZE
+#define PARANODE_BATCH_BUFFER_SIZE 512
+#endif
+#ifndef PARANODE_BUFFER_POOL_SIZE
+#define PARANODE_BUFFER_POOL_SIZE 1
+#endif
+#ifndef PARANODE_JSON_DOC_SIZE
+#define PARANODE_JSON_DOC_SIZE 512
+#endif
+#ifndef PARANODE_SCRATCH_SIZE
+#define PARANODE_SCRATCH_SIZE 768
+#endif
+#ifndef PARANODE_TX_BUFFER_SIZE
+#define PARANODE_TX_BUFFER_SIZE 512
+#endif
+#ifndef PARANODE_ENABLE_OTA
+#define PARANODE_ENABLE_OTA 0
+#endif
+#ifndef PARANODE_ENABLE_GEOLOCATION
+#define PARANODE_ENABLE_GEOLOCATION 0
+#endif
+#ifndef PARANODE_ENABLE_LEGACY_AUTH
+#define PARANODE_ENABLE_LEGACY_AUTH 0
+#endif
+#ifndef PARANODE_ENABLE_JSON_OBJECT_API
+#define PARANODE_ENABLE_JSON_OBJECT_API 0
+#endif
+#ifndef PARANODE_SAMPLING_RULES
+#define PARANODE_SAMPLING_RULES 4
+#endif
+#ifndef PARANODE_COMMAND_CACHE_SIZE
+#define PARANODE_COMMAND_CACHE_SIZE 4
+#endif
+#ifndef PARANODE_COMMAND_QUEUE_BYTES
+#define PARANODE_COMMAND_QUEUE_BYTES 256
+#endif
+#ifndef PARANODE_RECEIVE_CREDITS
+#define PARANODE_RECEIVE_CREDITS 4
+#endif
+#ifndef PARANODE_RECEIVE_CREDIT_BYTES
+#define PARANODE_RECEIVE_CREDIT_BYTES 1024
+#endif
+
+#elif defined(PARANODE_PROFILE_GATEWAY)
+
+#define PARANODE_PROFILE_NAME "gateway"
+#ifndef PARANODE_QUEUE_SIZE
+#define PARANODE_QUEUE_SIZE 40
+#endif
+#ifndef PARANODE_MAX_MESSAGE_SIZE
+#define PARANODE_MAX_MESSAGE_SIZE 512
+#endif
+#ifndef PARANODE_BATCH_BUFFER_SIZE
+#define PARANODE_BATCH_BUFFER_SIZE 2048
+#endif
+#ifndef PARANODE_BUFFER_POOL_SIZE
+#define PARANODE_BUFFER_POOL_SIZE 4
+#endif
+#ifndef PARANODE_JSON_DOC_SIZE
+#define PARANODE_JSON_DOC_SIZE 2048
+#endif
+#ifndef PARANODE_SCRATCH_SIZE
+#define PARANODE_SCRATCH_SIZE 2560
+#endif
+#ifndef PARANODE_TX_BUFFER_SIZE
+#define PARANODE_TX_BUFFER_SIZE 2048
+#endif
+#ifndef PARANODE_SAMPLING_RULES
+#define PARANODE_SAMPLING_RULES 16
+#endif
+#ifndef PARANODE_COMMAND_CACHE_SIZE
+#define PARANODE_COMMAND_CACHE_SIZE 16
+#endif
+#ifndef PARANODE_COMMAND_QUEUE_BYTES
+#define PARANODE_COMMAND_QUEUE_BYTES 3072
+#endif
+#ifndef PARANODE_RECEIVE_CREDITS
+#define PARANODE_RECEIVE_CREDITS 16
+#endif
+#ifndef PARANODE_RECEIVE_CREDIT_BYTES
+#define PARANODE_RECEIVE_CREDIT_BYTES 16384
+#endif
+
+#else
+
+#ifndef PARANODE_PROFILE_STANDARD
+#define PARANODE_PROFILE_STANDARD
+#endif
+#define PARANODE_PROFILE_NAME "standard"
+
+#endif
+
+// Feature switches (1 = compiled in). Profiles other than tiny keep everything.
+#ifndef PARANODE_ENABLE_OTA
+#define PARANODE_ENABLE_OTA 1
+#endif
+
+#ifndef PARANODE_ENABLE_GEOLOCATION
+#define PARANODE_ENABLE_GEOLOCATION 1
+#endif
+
+// Paranode(deviceId, secretKey) constructor and "auth" message
+#ifndef PARANODE_ENABLE_LEGACY_AUTH
+#define PARANODE_ENABLE_LEGACY_AUTH 1
+#endif
+
+// sendData(const JsonObject&) and updateDeviceStatus()
+#ifndef PARANODE_ENABLE_JSON_OBJECT_API
+#define PARANODE_ENABLE_JSON_OBJECT_API 1
+#endif
+
+// Server-assigned device ID and config kept across reboots (NVS/EEPROM).
+// Opt-in on ESP8266, where the EEPROM it writes belongs to the sketch
+#ifndef PARANODE_ENABLE_SESSION_STORE
+#ifdef ESP8266
+#define PARANODE_ENABLE_SESSION_STORE 0
+#else
+#define PARANODE_ENABLE_SESSION_STORE 1
+#endif
+#endif
+
+// Identity field storage
+#ifndef PARANODE_MAX_ID_LENGTH
+#define PARANODE_MAX_ID_LENGTH 64
+#endif
+
+#ifndef PARANODE_MAX_TOKEN_LENGTH
+#define PARANODE_MAX_TOKEN_LENGTH 96
+#endif
+
+// Server sampling rules, including per-key copies of the "*" rule
+#ifndef PARANODE_SAMPLING_RULES
+#define PARANODE_SAMPLING_RULES 8
+#endif
+
+#ifndef PARANODE_MAX_KEY_LENGTH
+#define PARANODE_MAX_KEY_LENGTH 32
+#endif
+
+// Recently seen command IDs, so redelivered commands run once
+#ifndef PARANODE_COMMAND_CACHE_SIZE
+#define PARANODE_COMMAND_CACHE_SIZE 8
+#endif
+
+// Commands waiting to run from loop(), as MessagePack copies
+#ifndef PARANODE_COMMAND_QUEUE_BYTES
+#define PARANODE_COMMAND_QUEUE_BYTES 768
+#endif
+
+// Inbound messages (and bytes) the server may have in flight to the device.
+// The byte window must hold the largest message the server sends.
+#ifndef PARANODE_RECEIVE_CREDITS
+#define PARANODE_RECEIVE_CREDITS 8
+#endif
+
+#ifndef PARANODE_RECEIVE_CREDIT_BYTES
+#define PARANODE_RECEIVE_CREDIT_BYTES 4096
+#endif
+
+// Batched frames and JsonObject sends are serialized here
+#ifndef PARANODE_BATCH_BUFFER_SIZE
+#define PARANODE_BATCH_BUFFER_SIZE 1024
+#endif
+
+#endif
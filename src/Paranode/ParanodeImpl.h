@@ -0,0 +1,2470 @@
+/**
+ * @file ParanodeImpl.h
+ * @brief Member definitions of BasicParanode
+ * @author Muhammad Daffa
+ * @date 2025-05-21
+ *
+ * Included by Paranode.cpp, which instantiates the default Paranode. Include
+ * it in one .cpp of your own only when instantiating BasicParanode with
+ * other components.
+ */
+
+#ifndef PARANODE_IMPL_H
+#define PARANODE_IMPL_H
+
+#include "Paranode.h"
+
+#define PARANODE_EXPIRY_CHECK_INTERVAL 30000
+
+#define PARANODE_TEMPLATE template<typename Transport, typename Queue, typename Encoder, typename Clock>
+#define PARANODE_CLASS BasicParanode<Transport, Queue, Encoder, Clock>
+
+#if PARANODE_ENABLE_LEGACY_AUTH
+// Legacy constructor (backward compatibility)
+PARANODE_TEMPLATE
+PARANODE_CLASS::BasicParanode(const String &deviceId, const String &secretKey, const String &serverUrl)
+    : _secretKey(secretKey),
+      _serverUrl(serverUrl),
+      _firmwareVersion("1.0.0"),
+      _hardwareVersion("1.0.0"),
+      _isConnected(false),
+      _isAuthenticated(false),
+      _autoReconnect(true),
+      _useTokenAuth(false),
+      _startTime(Clock::millis()),
+      _sessionResumed(false),
+      _deviceInfoHash(0),
+      _wifi(),
+      _socket(),
+      _messageQueue(),
+      _capture(),
+      _trace(),
+      _scratch(),
+#if PARANODE_ENABLE_SESSION_STORE
+      _session(),
+      _sessionRestored(false),
+      _tuningRestored(false),
+      _deviceInfoSet(false),
+      _tuningFirmware(0),
+#endif
+      _commandCallback(nullptr),
+      _connectCallback(nullptr),
+      _disconnectCallback(nullptr),
+#if PARANODE_ENABLE_OTA
+      _otaCallback(nullptr),
+      _otaProgressCallback(nullptr),
+      _ota(),
+      _otaStreaming(false),
+      _otaAutoRestart(true),
+      _otaRequestedEnd(0),
+      _otaLastRequest(0),
+      _otaCompletedAt(0),
+      _otaLastProgress(0),
+#endif
+      _wifiConfigCallback(nullptr),
+      _pressureCallback(nullptr),
+      _tuning(ParanodeTuning::defaults()),
+      _limiter(),
+      _policies(),
+      _scheduler(),
+      _sampler(),
+      _pressure(),
+      _commands(),
+      _lastHeartbeatTime(0),
+      _lastMetricsTime(0),
+      _lastReconnectAttempt(0),
+      _reconnectSeed(0),
+      _lastExpiryCheck(0),
+      _stats(),
+      _sequence(0),
+      _lastBatchTime(0),
+      _commandQueue(),
+      _commandBudget(PARANODE_COMMAND_BUDGET),
+      _runningCommands(false),
+      _responseBatchLength(0),
+      _responseBatchCount(0),
+      _batchResponse(nullptr),
+      _batchResponseId(nullptr),
+      _batchResultAdded(false),
+      _inboundLength(0),
+      _inboundDeferred(false)
+{
+    copyField(_deviceId, sizeof(_deviceId), deviceId.c_str());
+    _projectToken[0] = '\0';
+    _sessionToken[0] = '\0';
+    _macAddress[0] = '\0';
+
+    // Initialize buffers
+    _batchBuffer[0] = '\0';
+}
+#endif
+
+// New token-based constructor (recommended)
+PARANODE_TEMPLATE
+PARANODE_CLASS::BasicParanode(const String &projectToken, bool useTokenAuth)
+    : _serverUrl("wss://api.paranode.io/ws"),
+      _firmwareVersion("1.0.0"),
+      _hardwareVersion("1.0.0"),
+      _isConnected(false),
+      _isAuthenticated(false),
+      _autoReconnect(true),
+      _useTokenAuth(true),
+      _startTime(Clock::millis()),
+      _sessionResumed(false),
+      _deviceInfoHash(0),
+      _wifi(),
+      _socket(),
+      _messageQueue(),
+      _capture(),
+      _trace(),
+      _scratch(),
+#if PARANODE_ENABLE_SESSION_STORE
+      _session(),
+      _sessionRestored(false),
+      _tuningRestored(false),
+      _deviceInfoSet(false),
+      _tuningFirmware(0),
+#endif
+      _commandCallback(nullptr),
+      _connectCallback(nullptr),
+      _disconnectCallback(nullptr),
+#if PARANODE_ENABLE_OTA
+      _otaCallback(nullptr),
+      _otaProgressCallback(nullptr),
+      _ota(),
+      _otaStreaming(false),
+      _otaAutoRestart(true),
+      _otaRequestedEnd(0),
+      _otaLastRequest(0),
+      _otaCompletedAt(0),
+      _otaLastProgress(0),
+#endif
+      _wifiConfigCallback(nullptr),
+      _pressureCallback(nullptr),
+      _tuning(ParanodeTuning::defaults()),
+      _limiter(),
+      _policies(),
+      _scheduler(),
+      _sampler(),
+      _pressure(),
+      _commands(),
+      _lastHeartbeatTime(0),
+      _lastMetricsTime(0),
+      _lastReconnectAttempt(0),
+      _reconnectSeed(0),
+      _lastExpiryCheck(0),
+      _stats(),
+      _sequence(0),
+      _lastBatchTime(0),
+      _commandQueue(),
+      _commandBudget(PARANODE_COMMAND_BUDGET),
+      _runningCommands(false),
+      _responseBatchLength(0),
+      _responseBatchCount(0),
+      _batchResponse(nullptr),
+      _batchResponseId(nullptr),
+      _batchResultAdded(false),
+      _inboundLength(0),
+      _inboundDeferred(false)
+{
+    _deviceId[0] = '\0';
+    copyField(_projectToken, sizeof(_projectToken), projectToken.c_str());
+    _sessionToken[0] = '\0';
+    _macAddress[0] = '\0';
+
+    // Initialize buffers
+    _batchBuffer[0] = '\0';
+
+    // Device ID will be auto-generated from MAC address
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::begin()
+{
+    _socket.onRawMessage([this](const char *message, size_t length)
+                         { this->receiveMessage(message, length); });
+
+#if PARANODE_ENABLE_OTA
+    _socket.onBinaryMessage([this](const uint8_t *data, size_t length)
+                            { this->handleBinaryMessage(data, length); });
+#endif
+
+    _socket.onConnect([this]()
+                      { 
+                         this->_isConnected = true;
+                         this->_stats.connects++;
+                         this->_credits.reset();
+                         this->_scheduler.restart(Clock::millis());
+                         if (this->_connectCallback) {
+                             this->_connectCallback();
+                         }
+                         if (this->_sessionToken[0] != '\0') {
+                             // Authenticated by the upgrade request: queued data
+                             // drains in this loop() instead of after auth_response
+                             this->_sessionResumed = true;
+                             this->_isAuthenticated = true;
+                             this->onAuthenticated();
+                         } else {
+                             this->_sessionResumed = false;
+                             this->authenticate();
+                         } });
+
+    _socket.onDisconnect([this]()
+                         { 
+                             this->_isConnected = false;
+                             this->_isAuthenticated = false;
+                             if (this->_disconnectCallback) {
+                                 this->_disconnectCallback();
+                             } });
+
+    // Get MAC address if not set
+    if (_macAddress[0] == '\0')
+    {
+        copyField(_macAddress, sizeof(_macAddress), getDefaultMacAddress().c_str());
+    }
+
+#if PARANODE_ENABLE_SESSION_STORE
+    // Start from last boot's device ID and config instead of waiting for the server
+    restoreSession();
+#endif
+
+    // Commands run before a warm reset must not run again when redelivered
+    _commands.restore(Clock::millis());
+
+    // Per-device reconnect jitter (FNV-1a of the MAC address)
+    _reconnectSeed = 2166136261UL;
+    for (const char *p = _macAddress; *p; p++)
+    {
+        _reconnectSeed = (_reconnectSeed ^ (uint8_t)*p) * 16777619UL;
+    }
+
+    return true;
+}
+
+#if PARANODE_ENABLE_SESSION_STORE
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::isSessionRestored() const
+{
+    return _sessionRestored;
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::clearSession()
+{
+    _session.clear();
+    _sessionRestored = false;
+}
+
+PARANODE_TEMPLATE
+const char *PARANODE_CLASS::sessionOwner() const
+{
+    return _useTokenAuth ? _projectToken : _deviceId;
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::restoreSession()
+{
+    ParanodeSessionState state;
+    if (!_session.load(sessionOwner(), state))
+    {
+        return;
+    }
+
+    // Legacy auth uses the device ID it was constructed with
+    if (_useTokenAuth && state.deviceId[0] != '\0')
+    {
+        copyField(_deviceId, sizeof(_deviceId), state.deviceId);
+    }
+    // Tuning is only kept by the build that saved it: another config schema
+    // or firmware may have other fields, bounds or defaults
+    if (state.configSchema == PARANODE_CONFIG_SCHEMA_VERSION && state.tuning.isValid())
+    {
+        _tuning = state.tuning;
+        _tuningRestored = true;
+        _tuningFirmware = state.firmwareHash;
+    }
+    for (uint8_t cls = 0; cls < PARANODE_MSG_CLASS_COUNT; cls++)
+    {
+        if (state.limits[cls].perMinute > 0)
+        {
+            _limiter.setLimit((ParanodeMessageClass)cls, state.limits[cls].perMinute, state.limits[cls].burst);
+        }
+    }
+    _deviceInfoHash = state.deviceInfoHash;
+    setSessionToken(state.sessionToken);
+    _sessionRestored = _tuningRestored;
+
+    // Otherwise setDeviceInfo() checks the firmware version when it is called
+    if (_deviceInfoSet)
+    {
+        checkRestoredTuning();
+    }
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::checkRestoredTuning()
+{
+    const char *firmware = _firmwareVersion.c_str();
+    if (_tuningRestored && _tuningFirmware != ParanodeSessionStore::hash(firmware, strlen(firmware)))
+    {
+        _tuning = ParanodeTuning::defaults();
+        _tuningRestored = false;
+        _sessionRestored = false;
+    }
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::saveSession()
+{
+    ParanodeSessionState state;
+    memset(&state, 0, sizeof(state));
+    if (_useTokenAuth)
+    {
+        copyField(state.deviceId, sizeof(state.deviceId), _deviceId);
+    }
+    state.tuning = _tuning;
+    state.configSchema = PARANODE_CONFIG_SCHEMA_VERSION;
+    state.firmwareHash = _tuningRestored
+                             ? _tuningFirmware
+                             : ParanodeSessionStore::hash(_firmwareVersion.c_str(), _firmwareVersion.length());
+    for (uint8_t cls = 0; cls < PARANODE_MSG_CLASS_COUNT; cls++)
+    {
+        state.limits[cls] = _limiter.getLimit((ParanodeMessageClass)cls);
+    }
+    copyField(state.sessionToken, sizeof(state.sessionToken), _sessionToken);
+    state.deviceInfoHash = _deviceInfoHash;
+    _session.save(sessionOwner(), state);
+}
+#endif
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::connectWifi(const char *ssid, const char *password, unsigned long timeout)
+{
+    return _wifi.connect(ssid, password, timeout);
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::connect()
+{
+    if (!_wifi.isConnected())
+    {
+        return false;
+    }
+
+    return _socket.connect(_serverUrl);
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::isConnected()
+{
+    return _isConnected && _isAuthenticated;
+}
+
+// Backward compatibility wrappers using optimized template
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::sendData(const String &key, float value, const String &unit)
+{
+    return sendData<float>(key.c_str(), value, unit.c_str(), _tuning.batching != 0);
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::sendData(const String &key, int value, const String &unit)
+{
+    return sendData<int>(key.c_str(), value, unit.c_str(), _tuning.batching != 0);
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::sendData(const String &key, const String &value, const String &unit)
+{
+    return sendData<const char*>(key.c_str(), value.c_str(), unit.c_str(), _tuning.batching != 0);
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::sendData(const String &key, bool value, const String &unit)
+{
+    return sendData<bool>(key.c_str(), value, unit.c_str(), _tuning.batching != 0);
+}
+
+#if PARANODE_ENABLE_JSON_OBJECT_API
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::sendData(const JsonObject &json)
+{
+    StaticJsonDocument<512> doc;
+    doc["type"] = "telemetry";
+    doc["seq"] = ++_sequence;
+    doc["timestamp"] = Clock::millis();
+    JsonObject data = doc.createNestedObject("data");
+
+    for (JsonPair kv : json)
+    {
+        data[kv.key()] = kv.value();
+    }
+
+    // Serialize into the (larger) batch buffer instead of a String
+    if (measureJson(doc) >= sizeof(_batchBuffer))
+    {
+        return false;
+    }
+    serializeJson(doc, _batchBuffer, sizeof(_batchBuffer));
+
+    return sendMessage(_batchBuffer, PARANODE_MSG_TELEMETRY);
+}
+#endif
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::sendStatus(const String &status)
+{
+    return sendStatus(status.c_str());
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::sendStatus(const char *status)
+{
+    if (!status)
+    {
+        return false;
+    }
+
+    // Use optimized JSON builder
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease)
+    {
+        return false;
+    }
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "status");
+    builder.addString("status", status);
+    builder.addULong("timestamp", Clock::millis());
+    builder.addULong("uptime", getUptime());
+    builder.endObject();
+
+    return sendMessage(builder.getJson(), PARANODE_MSG_STATUS);
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::sendError(const String &errorMessage, int errorCode)
+{
+    return sendError(errorMessage.c_str(), errorCode);
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::sendError(const char *errorMessage, int errorCode)
+{
+    if (!errorMessage)
+    {
+        return false;
+    }
+
+    // Use optimized JSON builder
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease)
+    {
+        return false;
+    }
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "error");
+    builder.addString("message", errorMessage);
+    if (errorCode != 0)
+    {
+        builder.addInt("code", errorCode);
+    }
+    builder.addULong("timestamp", Clock::millis());
+    builder.endObject();
+
+    return sendMessage(builder.getJson(), PARANODE_MSG_ERROR);
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::sendMetrics(uint32_t freeHeap, int rssi)
+{
+    // Use optimized JSON builder
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease)
+    {
+        return false;
+    }
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "metrics");
+    builder.startNestedObject("data");
+    builder.addULong("freeHeap", freeHeap);
+    builder.addInt("rssi", rssi);
+    builder.addULong("uptime", getUptime());
+    builder.addULong("generated", _stats.generated);
+    builder.addULong("sent", _stats.sent);
+    builder.addULong("failed", _stats.failed);
+    builder.addULong("dropped", _messageQueue.droppedCount());
+    builder.addULong("expired", _messageQueue.expiredCount());
+    builder.addULong("throttled", _stats.throttled);
+    builder.addInt("pressure", _pressure.level());
+    builder.addULong("duplicateCommands", _commands.duplicateCount());
+    builder.addULong("creditOverruns", _credits.overrunCount());
+    builder.endObject(); // end data object
+    builder.addULong("timestamp", Clock::millis());
+    builder.endObject();
+
+    return sendMessage(builder.getJson(), PARANODE_MSG_METRICS);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::setDeviceInfo(const String &firmwareVersion, const String &hardwareVersion)
+{
+    _firmwareVersion = firmwareVersion;
+    _hardwareVersion = hardwareVersion;
+#if PARANODE_ENABLE_SESSION_STORE
+    _deviceInfoSet = true;
+    checkRestoredTuning();
+#endif
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::setMacAddress(const String &macAddress)
+{
+    copyField(_macAddress, sizeof(_macAddress), macAddress.c_str());
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::onCommand(CommandCallback callback)
+{
+    _commandCallback = callback;
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::setCommandBudget(unsigned long budgetMs)
+{
+    _commandBudget = budgetMs;
+}
+
+PARANODE_TEMPLATE
+uint16_t PARANODE_CLASS::receiveCredits() const
+{
+    return _credits.available();
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::onConnect(ConnectionCallback callback)
+{
+    _connectCallback = callback;
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::onDisconnect(ConnectionCallback callback)
+{
+    _disconnectCallback = callback;
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::onPressureChange(PressureCallback callback)
+{
+    _pressureCallback = callback;
+}
+
+#if PARANODE_ENABLE_OTA
+PARANODE_TEMPLATE
+void PARANODE_CLASS::onOTAUpdate(OTACallback callback)
+{
+    _otaCallback = callback;
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::onOTAProgress(OTAProgressCallback callback)
+{
+    _otaProgressCallback = callback;
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::setOTAStreaming(bool enable, bool autoRestart)
+{
+    _otaStreaming = enable;
+    _otaAutoRestart = autoRestart;
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::setOTATarget(ParanodeUpdateTarget *target)
+{
+    _ota.setTarget(target);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::setOTAImageReader(ParanodeImageReader reader)
+{
+    _ota.setImageReader(reader);
+}
+
+PARANODE_TEMPLATE
+ParanodeOTAState PARANODE_CLASS::getOTAState() const
+{
+    return _ota.state();
+}
+#endif
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::requestConfig()
+{
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease)
+    {
+        return false;
+    }
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "config_request");
+    builder.addInt("schemaVersion", PARANODE_CONFIG_SCHEMA_VERSION);
+    builder.endObject();
+
+    return sendMessage(builder.getJson(), PARANODE_MSG_REQUEST);
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::sendCommandResponse(const String &commandId, const String &status, const String &response)
+{
+    return sendCommandResponse(commandId.c_str(), status.c_str(), response.c_str());
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::sendCommandResponse(const char *commandId, const char *status, const char *response)
+{
+    if (!commandId || !status)
+    {
+        return false;
+    }
+
+    // Remembered even if this send fails, so a redelivery gets the answer
+    _commands.complete(commandId, status, response);
+    return writeCommandResponse(commandId, status, response, false);
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::writeCommandResponse(const char *commandId, const char *status, const char *response,
+                                          bool replayed)
+{
+    if (_batchResponse)
+    {
+        // Inside a command_batch: becomes one entry of its response
+        appendBatchResult(commandId, status, response);
+        return isConnected();
+    }
+
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease)
+    {
+        return false;
+    }
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "command_response");
+    builder.addString("commandId", commandId);
+    builder.addString("status", status);
+    if (response && response[0] != '\0')
+    {
+        builder.addString("response", response);
+    }
+    if (replayed)
+    {
+        builder.addBool("replayed", true);
+    }
+    builder.addULong("timestamp", Clock::millis());
+    builder.endObject();
+
+    if (_runningCommands)
+    {
+        return batchCommandResponse(builder.getJson());
+    }
+    return sendMessage(builder.getJson(), PARANODE_MSG_RESPONSE);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::setAutoReconnect(bool enable)
+{
+    _autoReconnect = enable;
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::setReconnectInterval(unsigned long interval)
+{
+    _tuning.set("reconnectInterval", interval);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::setHeartbeatInterval(unsigned long interval)
+{
+    _tuning.set("heartbeatInterval", interval);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::setRateLimit(ParanodeMessageClass cls, uint32_t perMinute, uint32_t burst)
+{
+    _limiter.setLimit(cls, perMinute, burst);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::setClassPolicy(ParanodeMessageClass cls, const ParanodeClassPolicy &policy)
+{
+    _policies.set(cls, policy);
+}
+
+PARANODE_TEMPLATE
+ParanodeClassPolicy PARANODE_CLASS::getClassPolicy(ParanodeMessageClass cls) const
+{
+    return _policies.get(cls);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::setScheduleShares(uint8_t live, uint8_t backlog)
+{
+    _scheduler.setShares(live, backlog);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::setRatePolicy(ParanodeMessageClass cls, ParanodeRatePolicy policy)
+{
+    _limiter.setPolicy(cls, policy);
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::shouldSample(const char* key)
+{
+    return _sampler.shouldSample(key, Clock::millis());
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::setSamplingRule(const char* key, uint32_t minInterval, ParanodeSampleMode mode, uint8_t priority)
+{
+    return _sampler.setRule(key, minInterval, mode, priority);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::clearSamplingRules()
+{
+    _sampler.clear();
+}
+
+PARANODE_TEMPLATE
+unsigned long PARANODE_CLASS::getUptime()
+{
+    return (Clock::millis() - _startTime) / 1000;
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::loop()
+{
+    _scratch.setStackBase();
+    _socket.loop();
+
+    unsigned long currentTime = Clock::millis();
+
+    // Commands received by _socket.loop(), outside the socket's event handler
+    runCommands();
+
+    // Return the credit of what was handled, at most once per loop()
+    if (_isConnected && _isAuthenticated && _credits.shouldAnnounce())
+    {
+        sendCredits();
+    }
+
+    // Process message queue
+    if (_isConnected && _isAuthenticated)
+    {
+        processQueue();
+
+        // Auto-batch send: a full batch at once, a partial one after batchInterval
+        if (_tuning.batching && !_messageQueue.isEmpty() &&
+            (_messageQueue.count() >= _tuning.batchSize || currentTime - _lastBatchTime > _tuning.batchInterval))
+        {
+            flushQueue();
+            _lastBatchTime = currentTime;
+        }
+    }
+
+    // Send heartbeat
+    if (_isConnected && _isAuthenticated && (currentTime - _lastHeartbeatTime > _tuning.heartbeatInterval))
+    {
+        sendHeartbeat();
+        _lastHeartbeatTime = currentTime;
+    }
+
+    // Send automatic metrics
+    if (_isConnected && _isAuthenticated && (currentTime - _lastMetricsTime > _tuning.metricsInterval))
+    {
+#ifdef ESP8266
+        uint32_t freeHeap = ESP.getFreeHeap();
+#elif defined(ESP32)
+        uint32_t freeHeap = ESP.getFreeHeap();
+#endif
+
+        int rssi = WiFi.RSSI();
+        sendMetrics(freeHeap, rssi);
+        _lastMetricsTime = currentTime;
+    }
+
+    // Remove expired messages from queue
+    if (!_messageQueue.isEmpty() && (currentTime - _lastExpiryCheck >= PARANODE_EXPIRY_CHECK_INTERVAL))
+    {
+        _messageQueue.removeExpired([this](uint8_t kind) -> unsigned long {
+            uint32_t ttl = _policies.get(kind).ttl;
+            return ttl > 0 ? ttl : _tuning.messageTtl;
+        }, currentTime);
+        _lastExpiryCheck = currentTime;
+    }
+
+#if PARANODE_ENABLE_OTA
+    serviceOTA(currentTime);
+#endif
+
+    // Backpressure, after this iteration's sends and expiry
+    if (_pressure.update(_messageQueue.count(), _messageQueue.bytes(), _messageQueue.droppedCount(),
+                         _isConnected && _isAuthenticated, currentTime) &&
+        _pressureCallback)
+    {
+        _pressureCallback(_pressure.level());
+    }
+
+    // Auto-reconnect
+    if (_autoReconnect && !_isConnected && _wifi.isConnected())
+    {
+        unsigned long reconnectDelay = _tuning.reconnectInterval + (_reconnectSeed % (_tuning.reconnectInterval / 2 + 1));
+        if (currentTime - _lastReconnectAttempt > reconnectDelay)
+        {
+            _lastReconnectAttempt = currentTime;
+            connect();
+        }
+    }
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::injectMessage(const char *message, size_t length)
+{
+    if (!message || length == 0)
+    {
+        return;
+    }
+
+    _socket.injectMessage(message, length);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::startCapture(Print &out)
+{
+    _capture.begin(out);
+    _socket.setCapture(&_capture);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::stopCapture()
+{
+    _socket.setCapture(nullptr);
+    _capture.end();
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::setTraceSampling(uint16_t everyN)
+{
+    _trace.setSampling(everyN);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::writeTrace(Print &out)
+{
+    _trace.writeChromeTrace(out);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::getTraceSummary(ParanodeTraceSummary &summary)
+{
+    _trace.summarize(summary);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::getStackReport(ParanodeStackReport &report) const
+{
+    _scratch.getReport(report);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::receiveMessage(const char *message, size_t length)
+{
+    // Over the server's grant: rejected before the parser sees it
+    if (!_credits.receive(length))
+    {
+        rejectOverrun(message, length);
+        return;
+    }
+
+    _inboundLength = length;
+    _inboundDeferred = false;
+    handleMessage(message, length);
+
+    // Queued commands keep their credit until they have run
+    if (!_inboundDeferred)
+    {
+        _credits.release(length);
+    }
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::rejectOverrun(const char *message, size_t length)
+{
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease)
+    {
+        return;
+    }
+
+    // The frame is not parsed, so the command id is picked out of the raw
+    // text; the server redelivers that command once it has credit again
+    char type[16];
+    char commandId[PARANODE_MAX_COMMAND_ID_LENGTH];
+    bool isCommand = scanString(message, length, "type", type, sizeof(type)) &&
+                     strncmp(type, "command", 7) == 0 &&
+                     scanString(message, length, "id", commandId, sizeof(commandId));
+
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "credit_overrun");
+    if (isCommand)
+    {
+        builder.addString("commandId", commandId);
+    }
+    builder.addULong("overruns", _credits.overrunCount());
+    builder.endObject();
+
+    sendMessage(builder.getJson(), PARANODE_MSG_CONTROL);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::sendCredits()
+{
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease)
+    {
+        return;
+    }
+
+    uint32_t messages = 0;
+    uint32_t bytes = 0;
+    _credits.announce(&messages, &bytes);
+
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "credits");
+    builder.addULong("messages", messages);
+    builder.addULong("bytes", bytes);
+    builder.endObject();
+
+    // Flow control must not wait behind the data it regulates
+    sendMessage(builder.getJson(), PARANODE_MSG_CONTROL);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::handleMessage(const char *message, size_t length)
+{
+    // The document pool lives in the scratch arena, not on the stack
+    ParanodeScratchScope scratch(_scratch, PARANODE_ENTRY_HANDLE_MESSAGE);
+    ParanodeScratchDocument doc(PARANODE_JSON_DOC_SIZE, ParanodeScratchAllocator(&_scratch));
+    if (doc.capacity() == 0)
+    {
+        return;
+    }
+
+    DeserializationError error = deserializeJson(doc, message, length);
+
+    if (error)
+    {
+        return;
+    }
+
+    const char *type = doc["type"] | "";
+
+    if (strcmp(type, "auth_response") == 0 || strcmp(type, "auth_token_response") == 0)
+    {
+        bool wasAuthenticated = _isAuthenticated;
+        _isAuthenticated = doc["success"];
+        if (_isAuthenticated)
+        {
+            // If using token auth, store assigned device ID
+            if (_useTokenAuth && doc.containsKey("deviceId")) {
+                copyField(_deviceId, sizeof(_deviceId), doc["deviceId"] | "");
+            }
+
+            if (doc.containsKey("sessionToken")) {
+                setSessionToken(doc["sessionToken"] | "");
+            }
+
+            // Plan limits are enforced locally so the server never has to throttle
+            if (doc.containsKey("project")) {
+                applyProjectLimits(doc["project"].template as<JsonObject>());
+            }
+
+            if (!wasAuthenticated) {
+                onAuthenticated();
+            }
+
+#if PARANODE_ENABLE_SESSION_STORE
+            // Confirms the restored ID, or replaces it if the server changed it
+            saveSession();
+#endif
+        }
+        else if (_sessionResumed)
+        {
+            // Token expired or revoked: fall back to a full handshake on this
+            // connection. The server holds frames sent in the meantime until
+            // the device is authenticated again.
+            _sessionResumed = false;
+            setSessionToken("");
+            authenticate();
+        }
+        else
+        {
+            // Authentication failed
+            if (doc.containsKey("error")) {
+                const char *errorMsg = doc["error"] | "";
+                // Could trigger an error callback
+                Serial.print("Auth failed: ");
+                Serial.println(errorMsg);
+            }
+        }
+    }
+    else if (strcmp(type, "session_resumed") == 0)
+    {
+        // Optional confirmation of a token-authenticated connection, may rotate the token
+        if (doc.containsKey("sessionToken"))
+        {
+            setSessionToken(doc["sessionToken"] | "");
+#if PARANODE_ENABLE_SESSION_STORE
+            saveSession();
+#endif
+        }
+    }
+    else if (strcmp(type, "command") == 0 && _commandCallback)
+    {
+        handleCommand(doc["command"].template as<JsonObject>());
+    }
+    else if (strcmp(type, "command_batch") == 0 && _commandCallback)
+    {
+        handleCommandBatch(doc.template as<JsonObject>());
+    }
+    else if (strcmp(type, "wifi_config") == 0 && _wifiConfigCallback)
+    {
+        // Rare and sketch-initiated; the callback's Strings are the only
+        // allocation on the receive path
+        _wifiConfigCallback(String(doc["ssid"] | ""), String(doc["password"] | ""));
+    }
+#if PARANODE_ENABLE_OTA
+    else if (strcmp(type, "ota_update") == 0)
+    {
+        handleOTAUpdate(doc["update"].as<JsonObject>());
+    }
+#endif
+    else if (strcmp(type, "sampling") == 0)
+    {
+        handleSampling(doc.template as<JsonObject>());
+    }
+    else if (strcmp(type, "config") == 0)
+    {
+        handleConfig(doc["config"].as<JsonObject>());
+    }
+#if PARANODE_ENABLE_OTA
+    else if (strcmp(type, "ota_progress") == 0 && _otaProgressCallback)
+    {
+        int progress = doc["progress"];
+        _otaProgressCallback(progress);
+    }
+#endif
+    else if (strcmp(type, "ack") == 0)
+    {
+        // Server acknowledgement of telemetry, used for latency tracing
+        if (doc.containsKey("seq"))
+        {
+            _trace.mark(doc["seq"].as<uint32_t>(), PARANODE_TRACE_ACKED);
+        }
+        for (JsonVariant seq : doc["seqs"].as<JsonArray>())
+        {
+            _trace.mark(seq.as<uint32_t>(), PARANODE_TRACE_ACKED);
+        }
+    }
+    else if (strcmp(type, "project_info") == 0)
+    {
+        // Handle project information response
+        if (doc.containsKey("project")) {
+            applyProjectLimits(doc["project"].template as<JsonObject>());
+#if PARANODE_ENABLE_SESSION_STORE
+            saveSession();
+#endif
+        }
+    }
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::sendHeartbeat()
+{
+    // Use optimized JSON builder
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease)
+    {
+        return;
+    }
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "heartbeat");
+    builder.addULong("uptime", getUptime());
+    builder.addULong("freeHeap", ESP.getFreeHeap());
+    builder.addInt("rssi", WiFi.RSSI());
+    builder.endObject();
+
+    sendMessage(builder.getJson(), PARANODE_MSG_HEARTBEAT);
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::authenticate()
+{
+    char ipAddress[16];
+    _wifi.getIPAddress(ipAddress, sizeof(ipAddress));
+
+    if (_useTokenAuth) {
+        // Token-based authentication (new method)
+        ParanodeBufferLease lease(_bufferPool);
+        if (!lease) {
+            return false;
+        }
+        Encoder builder(lease.data(), lease.size());
+        builder.startObject();
+        builder.addString("type", "auth_token");
+        builder.addInt("configSchema", PARANODE_CONFIG_SCHEMA_VERSION);
+        builder.addString("projectToken", _projectToken);
+        builder.addString("deviceId", _deviceId[0] == '\0' ? _macAddress : _deviceId);
+        builder.addString("macAddress", _macAddress);
+        builder.addString("ipAddress", ipAddress);
+        builder.addString("firmwareVersion", _firmwareVersion.c_str());
+        builder.addString("hardwareVersion", _hardwareVersion.c_str());
+        builder.addString("platform",
+#ifdef ESP32
+            "ESP32"
+#else
+            "ESP8266"
+#endif
+        );
+        builder.endObject();
+
+        return sendMessage(builder.getJson(), PARANODE_MSG_CONTROL);
+    } else {
+#if PARANODE_ENABLE_LEGACY_AUTH
+        // Legacy device ID + secret key authentication
+        ParanodeBufferLease lease(_bufferPool);
+        if (!lease) {
+            return false;
+        }
+        Encoder builder(lease.data(), lease.size());
+        builder.startObject();
+        builder.addString("type", "auth");
+        builder.addString("deviceId", _deviceId);
+        builder.addString("secretKey", _secretKey.c_str());
+        builder.addString("macAddress", _macAddress);
+        builder.addString("ipAddress", ipAddress);
+        builder.addString("firmwareVersion", _firmwareVersion.c_str());
+        builder.addString("hardwareVersion", _hardwareVersion.c_str());
+        builder.endObject();
+
+        return sendMessage(builder.getJson(), PARANODE_MSG_CONTROL);
+#else
+        return false;
+#endif
+    }
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::onAuthenticated()
+{
+    // device_info only goes out when it differs from what the server has
+    uint32_t infoHash = deviceInfoHash();
+    if (infoHash != _deviceInfoHash && sendDeviceInfo())
+    {
+        _deviceInfoHash = infoHash;
+#if PARANODE_ENABLE_SESSION_STORE
+        saveSession();
+#endif
+    }
+
+#if PARANODE_ENABLE_OTA
+    // Resume an interrupted download from the last written offset
+    if (_ota.isActive())
+    {
+        requestOTAChunk();
+    }
+#endif
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::setSessionToken(const char *token)
+{
+    // The token ends up in an HTTP header, so anything but visible ASCII is refused
+    for (const char *p = token; p && *p; p++)
+    {
+        if (*p <= ' ' || *p > '~')
+        {
+            token = "";
+            break;
+        }
+    }
+
+    copyField(_sessionToken, sizeof(_sessionToken), token);
+
+    if (_sessionToken[0] == '\0')
+    {
+        _socket.setExtraHeaders(nullptr);
+        return;
+    }
+
+    char header[PARANODE_EXTRA_HEADERS_SIZE];
+    snprintf(header, sizeof(header), "X-Paranode-Session: %s", _sessionToken);
+    _socket.setExtraHeaders(header);
+}
+
+PARANODE_TEMPLATE
+uint32_t PARANODE_CLASS::deviceInfoHash()
+{
+    char ipAddress[16];
+    _wifi.getIPAddress(ipAddress, sizeof(ipAddress));
+
+    // FNV-1a over the device_info fields, NUL-separated
+    const char *fields[] = {_firmwareVersion.c_str(), _hardwareVersion.c_str(), _macAddress, ipAddress};
+    uint32_t hash = 2166136261UL;
+    for (const char *field : fields)
+    {
+        for (const char *p = field; ; p++)
+        {
+            hash = (hash ^ (uint8_t)*p) * 16777619UL;
+            if (*p == '\0')
+            {
+                break;
+            }
+        }
+    }
+    return hash;
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::sendDeviceInfo()
+{
+    char ipAddress[16];
+    _wifi.getIPAddress(ipAddress, sizeof(ipAddress));
+
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease)
+    {
+        return false;
+    }
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "device_info");
+    builder.addString("firmwareVersion", _firmwareVersion.c_str());
+    builder.addString("hardwareVersion", _hardwareVersion.c_str());
+    builder.addString("macAddress", _macAddress);
+    builder.addString("ipAddress", ipAddress);
+    builder.endObject();
+
+    return sendMessage(builder.getJson(), PARANODE_MSG_CONTROL);
+}
+
+#if PARANODE_ENABLE_OTA
+PARANODE_TEMPLATE
+void PARANODE_CLASS::handleOTAUpdate(const JsonObject &update)
+{
+    if (_otaStreaming && update.containsKey("size") && update.containsKey("sha256"))
+    {
+        const char *id = update["id"] | "";
+        uint32_t size = update["size"].template as<uint32_t>();
+        const char *sha256 = update["sha256"] | "";
+
+        // Delta updates: size/sha256 describe the patch, imageSize/imageSha256
+        // the firmware it produces
+        bool started = (update["delta"] | false)
+                           ? _ota.startDelta(id, size, sha256,
+                                             update["imageSize"].template as<uint32_t>(),
+                                             update["imageSha256"] | "")
+                           : _ota.start(id, size, sha256);
+        if (started)
+        {
+            _otaRequestedEnd = _ota.offset();
+            _otaLastProgress = _ota.progress();
+            requestOTAChunk();
+        }
+        else
+        {
+            sendOTAStatus("failed", _ota.error());
+        }
+        return;
+    }
+
+    if (_otaCallback)
+    {
+        String url = update["url"];
+        _otaCallback(url);
+    }
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::handleBinaryMessage(const uint8_t *data, size_t length)
+{
+    if (!_ota.isActive())
+    {
+        return;
+    }
+
+    if (!_ota.handleFrame(data, length))
+    {
+        if (_ota.state() == PARANODE_OTA_FAILED)
+        {
+            sendOTAStatus("failed", _ota.error());
+        }
+        return;
+    }
+
+    uint8_t progress = _ota.progress();
+    if (progress != _otaLastProgress)
+    {
+        _otaLastProgress = progress;
+        if (_otaProgressCallback)
+        {
+            _otaProgressCallback(progress);
+        }
+    }
+
+    if (_ota.state() == PARANODE_OTA_COMPLETE)
+    {
+        sendOTAStatus("success", "");
+        _otaCompletedAt = Clock::millis();
+    }
+    else if (_ota.offset() >= _otaRequestedEnd)
+    {
+        requestOTAChunk();
+    }
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::requestOTAChunk()
+{
+    if (!_isConnected || !_ota.isActive())
+    {
+        return;
+    }
+
+    uint32_t remaining = _ota.size() - _ota.offset();
+    uint32_t length = remaining < PARANODE_OTA_WINDOW_SIZE ? remaining : PARANODE_OTA_WINDOW_SIZE;
+
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease)
+    {
+        return;
+    }
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "ota_chunk_request");
+    builder.addString("id", _ota.id());
+    builder.addULong("offset", _ota.offset());
+    builder.addULong("length", length);
+    builder.addInt("chunkSize", PARANODE_OTA_CHUNK_SIZE);
+    builder.endObject();
+
+    // The window start is remembered even if the send fails, so the timeout
+    // in serviceOTA() retries it
+    _otaRequestedEnd = _ota.offset() + length;
+    _otaLastRequest = Clock::millis();
+    sendMessage(builder.getJson(), PARANODE_MSG_CONTROL);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::sendOTAStatus(const char *status, const char *error)
+{
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease || !_isConnected)
+    {
+        return;
+    }
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "ota_status");
+    builder.addString("id", _ota.id());
+    builder.addString("status", status);
+    if (error && error[0] != '\0')
+    {
+        builder.addString("error", error);
+    }
+    builder.endObject();
+
+    sendMessage(builder.getJson(), PARANODE_MSG_CONTROL);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::serviceOTA(unsigned long currentTime)
+{
+    // Frames lost (or the request never sent): ask again from the last
+    // written offset
+    if (_ota.isActive() && _isConnected && _isAuthenticated &&
+        currentTime - _otaLastRequest > PARANODE_OTA_CHUNK_TIMEOUT)
+    {
+        requestOTAChunk();
+    }
+
+    // Give the ota_status message a moment to leave before rebooting
+    if (_ota.state() == PARANODE_OTA_COMPLETE && _otaAutoRestart &&
+        currentTime - _otaCompletedAt > 1000)
+    {
+        ESP.restart();
+    }
+}
+#endif
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::applyProjectLimits(const JsonObject &project)
+{
+    if (!project.containsKey("limits"))
+    {
+        return;
+    }
+
+    // "limits": { "telemetry": 60, "status": { "perMinute": 6, "burst": 2 } }
+    // A class the plan leaves out is unlimited
+    static const char *const names[PARANODE_MSG_CLASS_COUNT] = {"telemetry", "status", "error", "metrics"};
+    JsonObject limits = project["limits"];
+    for (uint8_t cls = 0; cls < PARANODE_MSG_CLASS_COUNT; cls++)
+    {
+        JsonVariant entry = limits[names[cls]];
+        uint32_t perMinute = 0;
+        uint32_t burst = 0;
+        if (entry.template is<JsonObject>())
+        {
+            perMinute = entry["perMinute"] | 0;
+            burst = entry["burst"] | 0;
+        }
+        else if (!entry.isNull())
+        {
+            perMinute = entry.template as<uint32_t>();
+        }
+        _limiter.setLimit((ParanodeMessageClass)cls, perMinute, burst);
+    }
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::handleCommand(const JsonObject &command)
+{
+    // Commands without an ID cannot be matched and always run
+    const char *commandId = command["id"] | "";
+    if (commandId[0] != '\0')
+    {
+        const char *status = nullptr;
+        const char *response = nullptr;
+        switch (_commands.check(commandId, Clock::millis(), &status, &response))
+        {
+        case PARANODE_COMMAND_ANSWERED:
+            writeCommandResponse(commandId, status, response, true);
+            return;
+        case PARANODE_COMMAND_PENDING:
+            // Still running; the original response will follow
+            return;
+        default:
+            break;
+        }
+    }
+
+    // Queue a compact copy for loop(); run inline if it does not fit
+    if (deferCommand(command, PARANODE_COMMAND_SINGLE))
+    {
+        return;
+    }
+
+    _scratch.probeStack(PARANODE_ENTRY_CALLBACK);
+    _commandCallback(command);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::handleCommandBatch(const JsonObject &batch)
+{
+    // Queued whole, so the batch runs in order and answers in one frame
+    if (deferCommand(batch, PARANODE_COMMAND_BATCH))
+    {
+        return;
+    }
+    runCommandBatch(batch);
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::deferCommand(const JsonObject &command, ParanodeCommandKind kind)
+{
+    if (_commandBudget == 0)
+    {
+        return false;
+    }
+
+    size_t capacity = 0;
+    uint8_t *slot = _commandQueue.reserve(&capacity);
+    if (!slot || measureMsgPack(command) > capacity)
+    {
+        return false;
+    }
+
+    size_t length = serializeMsgPack(command, slot, capacity);
+    if (length == 0)
+    {
+        return false;
+    }
+    _commandQueue.commit(length, kind, Clock::millis(),
+                         _inboundLength < 0xFFFF ? (uint16_t)_inboundLength : 0xFFFF);
+    _inboundDeferred = true;
+    return true;
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::runCommandBatch(const JsonObject &batch)
+{
+    // The shared response buffer holds this batch's results
+    flushCommandResponses();
+
+    Encoder builder(_responseBatch, sizeof(_responseBatch));
+    _batchResponse = &builder;
+    _batchResponseId = batch["batchId"] | "";
+    startBatchResponse();
+
+    JsonArray commands = batch["commands"];
+    for (JsonObject command : commands)
+    {
+        const char *commandId = command["id"] | "";
+        if (commandId[0] != '\0')
+        {
+            const char *status = nullptr;
+            const char *response = nullptr;
+            ParanodeCommandSeen seen = _commands.check(commandId, Clock::millis(), &status, &response);
+            if (seen == PARANODE_COMMAND_ANSWERED)
+            {
+                appendBatchResult(commandId, status, response);
+                continue;
+            }
+            if (seen == PARANODE_COMMAND_PENDING)
+            {
+                appendBatchResult(commandId, "PENDING", nullptr);
+                continue;
+            }
+        }
+
+        _batchResultAdded = false;
+        _scratch.probeStack(PARANODE_ENTRY_CALLBACK);
+        _commandCallback(command);
+
+        // Not answered from the callback; a command_response follows later
+        if (!_batchResultAdded && commandId[0] != '\0')
+        {
+            appendBatchResult(commandId, "PENDING", nullptr);
+        }
+    }
+
+    sendBatchResponse(false);
+    _batchResponse = nullptr;
+    _batchResponseId = nullptr;
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::startBatchResponse()
+{
+    _batchResponse->reset();
+    _batchResponse->startObject();
+    _batchResponse->addString("type", "command_batch_response");
+    if (_batchResponseId[0] != '\0')
+    {
+        _batchResponse->addString("batchId", _batchResponseId);
+    }
+    _batchResponse->startNestedArray("results");
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::appendBatchResult(const char *commandId, const char *status, const char *response)
+{
+    if (!response)
+    {
+        response = "";
+    }
+
+    // Keys, quotes and the closing "],"more":true}"
+    size_t needed = strlen(commandId) + strlen(status) + strlen(response) + 64;
+    if (!_batchResponse->hasSpace(needed))
+    {
+        // Full: send what we have and continue in another frame
+        sendBatchResponse(true);
+        startBatchResponse();
+    }
+
+    _batchResponse->startObject();
+    _batchResponse->addString("commandId", commandId);
+    _batchResponse->addString("status", status);
+    if (response[0] != '\0')
+    {
+        _batchResponse->addString("response", response);
+    }
+    _batchResponse->endObject();
+    _batchResultAdded = true;
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::sendBatchResponse(bool more)
+{
+    _batchResponse->endArray();
+    if (more)
+    {
+        _batchResponse->addBool("more", true);
+    }
+    _batchResponse->addULong("timestamp", Clock::millis());
+    _batchResponse->endObject();
+    sendMessage(_batchResponse->getJson(), PARANODE_MSG_RESPONSE);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::runCommands()
+{
+    if (_commandQueue.isEmpty())
+    {
+        return;
+    }
+
+    ParanodeScratchScope scratch(_scratch, PARANODE_ENTRY_RUN_COMMANDS);
+    ParanodeScratchDocument doc(PARANODE_JSON_DOC_SIZE, ParanodeScratchAllocator(&_scratch));
+    if (doc.capacity() == 0)
+    {
+        return;
+    }
+
+    // At least one command per loop(), then as many as the budget allows
+    unsigned long start = Clock::millis();
+    _runningCommands = true;
+    do
+    {
+        ParanodeCommandRecord record;
+        _commandQueue.front(record);
+        doc.clear();
+        DeserializationError error = deserializeMsgPack(doc, (const char *)record.data, record.length);
+        if (!error && _commandCallback)
+        {
+            if (record.kind == PARANODE_COMMAND_BATCH)
+            {
+                runCommandBatch(doc.template as<JsonObject>());
+            }
+            else
+            {
+                _scratch.probeStack(PARANODE_ENTRY_CALLBACK);
+                _commandCallback(doc.template as<JsonObject>());
+            }
+        }
+        _commandQueue.pop();
+        _credits.release(record.frameLength);
+    } while (!_commandQueue.isEmpty() && Clock::millis() - start < _commandBudget);
+    _runningCommands = false;
+
+    flushCommandResponses();
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::batchCommandResponse(const char *response)
+{
+    size_t length = strlen(response);
+    if (length + 2 >= sizeof(_responseBatch))
+    {
+        // Too large to share a frame
+        return sendMessage(response, PARANODE_MSG_RESPONSE);
+    }
+    if (_responseBatchLength + length + 2 >= sizeof(_responseBatch))
+    {
+        flushCommandResponses();
+    }
+
+    _responseBatch[_responseBatchLength++] = _responseBatchCount == 0 ? '[' : ',';
+    memcpy(_responseBatch + _responseBatchLength, response, length);
+    _responseBatchLength += length;
+    _responseBatchCount++;
+    return isConnected();
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::flushCommandResponses()
+{
+    if (_responseBatchCount == 0)
+    {
+        return;
+    }
+
+    if (_responseBatchCount == 1)
+    {
+        // A lone response goes out as a plain object
+        _responseBatch[_responseBatchLength] = '\0';
+        sendMessage(_responseBatch + 1, PARANODE_MSG_RESPONSE);
+    }
+    else
+    {
+        _responseBatch[_responseBatchLength++] = ']';
+        _responseBatch[_responseBatchLength] = '\0';
+        sendMessage(_responseBatch, PARANODE_MSG_RESPONSE);
+    }
+    _responseBatchLength = 0;
+    _responseBatchCount = 0;
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::handleSampling(const JsonObject &doc)
+{
+    // The message replaces every rule; an empty "rules" lifts all shedding
+    _sampler.clear();
+
+    uint8_t applied = 0;
+    uint8_t rejected = 0;
+    JsonArray rules = doc["rules"];
+    for (JsonObject rule : rules)
+    {
+        const char *key = rule["key"];
+        const char *mode = rule["mode"] | "interval";
+        ParanodeSampleMode sampleMode = PARANODE_SAMPLE_INTERVAL;
+        if (strcmp(mode, "aggregate") == 0)
+        {
+            sampleMode = PARANODE_SAMPLE_AGGREGATE;
+        }
+        else if (strcmp(mode, "drop") == 0)
+        {
+            sampleMode = PARANODE_SAMPLE_DROP;
+        }
+
+        if (_sampler.setRule(key, rule["minInterval"] | 0UL, sampleMode, rule["priority"] | 1))
+        {
+            applied++;
+        }
+        else
+        {
+            rejected++;
+        }
+    }
+
+    // Rules with a ttl lapse on their own if the server never lifts them
+    unsigned long ttl = doc["ttl"] | 0UL;
+    if (ttl > 0)
+    {
+        _sampler.expireAt(Clock::millis() + ttl);
+    }
+
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease)
+    {
+        return;
+    }
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "sampling_ack");
+    builder.addInt("applied", applied);
+    if (rejected > 0)
+    {
+        builder.addInt("rejected", rejected);
+    }
+    builder.endObject();
+    sendMessage(builder.getJson(), PARANODE_MSG_RESPONSE);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::handleConfig(const JsonObject &config)
+{
+    // Validate everything into a copy first, so a config with one bad value
+    // leaves the running parameters untouched
+    ParanodeTuning next = _tuning;
+    const char *rejected = nullptr;
+    uint8_t ignored = 0;
+
+    for (JsonPair field : config)
+    {
+        const char *name = field.key().c_str();
+        if (strcmp(name, "schemaVersion") == 0)
+        {
+            continue;
+        }
+        if (!ParanodeTuning::isField(name))
+        {
+            // Newer schema or another subsystem's setting
+            ignored++;
+            continue;
+        }
+
+        JsonVariant value = field.value();
+        if ((!value.is<uint32_t>() && !value.is<bool>()) ||
+            next.set(name, value.as<uint32_t>()) != PARANODE_TUNING_OK)
+        {
+            rejected = name;
+            break;
+        }
+    }
+
+    if (!rejected)
+    {
+        _tuning = next;
+#if PARANODE_ENABLE_SESSION_STORE
+        _tuningRestored = false;
+        saveSession();
+#endif
+    }
+
+    sendConfigAck(rejected == nullptr, rejected, ignored);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::sendConfigAck(bool applied, const char *rejected, uint8_t ignored)
+{
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease)
+    {
+        return;
+    }
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "config_ack");
+    builder.addInt("schemaVersion", PARANODE_CONFIG_SCHEMA_VERSION);
+    builder.addBool("applied", applied);
+    if (rejected)
+    {
+        builder.addString("rejected", rejected);
+    }
+    if (ignored > 0)
+    {
+        builder.addInt("ignored", ignored);
+    }
+    builder.endObject();
+
+    sendMessage(builder.getJson(), PARANODE_MSG_RESPONSE);
+}
+
+PARANODE_TEMPLATE
+ParanodeTuning PARANODE_CLASS::getTuning() const
+{
+    return _tuning;
+}
+
+PARANODE_TEMPLATE
+const char *PARANODE_CLASS::getDeviceId() const
+{
+    return _deviceId;
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::scanString(const char *json, size_t length, const char *key, char *dest, size_t size)
+{
+    // First "key":"value" pair at any depth; enough for ids, which have no escapes
+    size_t keyLength = strlen(key);
+    dest[0] = '\0';
+    for (size_t i = 0; i + keyLength + 2 < length; i++)
+    {
+        if (json[i] != '"' || strncmp(json + i + 1, key, keyLength) != 0 || json[i + keyLength + 1] != '"')
+        {
+            continue;
+        }
+        size_t j = i + keyLength + 2;
+        while (j < length && (json[j] == ' ' || json[j] == ':'))
+        {
+            j++;
+        }
+        if (j >= length || json[j] != '"')
+        {
+            return false;
+        }
+        size_t n = 0;
+        for (j++; j < length && json[j] != '"' && n + 1 < size; j++)
+        {
+            dest[n++] = json[j];
+        }
+        dest[n] = '\0';
+        return n > 0;
+    }
+    return false;
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::copyField(char *dest, size_t size, const char *src)
+{
+    if (!src)
+    {
+        src = "";
+    }
+    size_t length = strnlen(src, size - 1);
+    memcpy(dest, src, length);
+    dest[length] = '\0';
+}
+
+PARANODE_TEMPLATE
+String PARANODE_CLASS::getDefaultMacAddress()
+{
+#ifdef ESP8266
+    return WiFi.macAddress();
+#elif defined(ESP32)
+    return WiFi.macAddress();
+#endif
+}
+
+// Outbound pipeline. Callers build the message; here it is classified,
+// rate limited, then written now or queued for a batch frame / the link.
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::sendMessage(const char* message, uint8_t cls, uint32_t seq, int priority, bool batchable)
+{
+    if (!message) {
+        return false;
+    }
+
+    _stats.generated++;
+
+    const ParanodeClassPolicy& policy = _policies.get(cls);
+    uint8_t queuePriority = policy.urgent ? 3 : priority >= 0 ? (uint8_t)priority : policy.priority;
+    // Control traffic belongs to the connection and includes the handshake
+    bool online = _isConnected && (_isAuthenticated || cls == PARANODE_MSG_CONTROL);
+    bool sendNow = online && (policy.urgent || !(batchable && policy.batch && _tuning.batching));
+
+    if (sendNow) {
+        if (!_limiter.tryConsume(cls, Clock::millis())) {
+            return throttleMessage(message, queuePriority, seq, cls);
+        }
+        if (writeMessage(message, seq)) {
+            return true;
+        }
+        // Queued below; the token is taken again when it drains
+        _limiter.refund(cls);
+    }
+
+    // Waiting for a batch frame, or for the link if the class is kept offline;
+    // the limiter is applied when the queue drains
+    bool batchWait = online && !sendNow;
+    if (!batchWait && !policy.offline) {
+        _stats.failed++;
+        return false;
+    }
+
+    uint32_t dropped = _messageQueue.droppedCount();
+    if (!_messageQueue.enqueue(message, strlen(message), queuePriority, seq, cls,
+                               policy.drop == PARANODE_DROP_OLDEST, Clock::millis())) {
+        // A full queue refusing it already counts as dropped
+        if (_messageQueue.droppedCount() == dropped) {
+            _stats.failed++;
+        }
+        return false;
+    }
+    _stats.queued++;
+    _trace.mark(seq, PARANODE_TRACE_ENQUEUED);
+    return true;
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::throttleMessage(const char* message, uint8_t priority, uint32_t seq, uint8_t cls)
+{
+    _limiter.recordThrottled(cls);
+
+    switch (_limiter.getPolicy((ParanodeMessageClass)cls)) {
+        case PARANODE_RATE_DROP:
+            _stats.throttled++;
+            return false;
+
+        case PARANODE_RATE_COALESCE: {
+            // Only the latest value matters, so overwrite the one still waiting
+            bool replaced = false;
+            if (!_messageQueue.coalesce(message, strlen(message), priority, seq, cls, Clock::millis(), &replaced)) {
+                _stats.failed++;
+                return false;
+            }
+            if (replaced) {
+                _stats.throttled++;
+            } else {
+                _stats.queued++;
+            }
+            _trace.mark(seq, PARANODE_TRACE_ENQUEUED);
+            return true;
+        }
+
+        case PARANODE_RATE_QUEUE:
+        default:
+            if (!_messageQueue.enqueue(message, strlen(message), priority, seq, cls, true, Clock::millis())) {
+                _stats.failed++;
+                return false;
+            }
+            _stats.queued++;
+            _trace.mark(seq, PARANODE_TRACE_ENQUEUED);
+            return true;
+    }
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::writeMessage(const char* message, uint32_t seq)
+{
+    if (_isConnected && _socket.send(message)) {
+        _stats.sent++;
+        _trace.mark(seq, PARANODE_TRACE_WRITTEN);
+        return true;
+    }
+    return false;
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::processQueue()
+{
+    if (_messageQueue.isEmpty() || !_isConnected) {
+        return;
+    }
+
+    ParanodeScratchScope scratch(_scratch, PARANODE_ENTRY_PROCESS_QUEUE);
+    char *buffer = (char *)scratch.allocate(PARANODE_MAX_MESSAGE_SIZE);
+    if (!buffer) {
+        return;
+    }
+
+    // Send a few queued messages per loop iteration; don't flood the connection
+    sendQueued(buffer, _tuning.maxSendPerLoop, false);
+}
+
+PARANODE_TEMPLATE
+int PARANODE_CLASS::sendQueued(char *buffer, int maxFrames, bool batchLive)
+{
+    int frames = 0;
+    int sent = 0;
+
+    // Urgent lane first, ahead of older backlog
+    while (frames < maxFrames)
+    {
+        unsigned long now = Clock::millis();
+        int urgent = _messageQueue.peekKind(3);
+        if (urgent < 0 || !_limiter.tryConsume((uint8_t)urgent, now)) {
+            break;
+        }
+
+        // Removed only once written, so a failed write leaves it in place
+        uint32_t seq = 0;
+        uint8_t kind = 0;
+        _messageQueue.peek(buffer, PARANODE_MAX_MESSAGE_SIZE, &seq, &kind, 3);
+        _trace.mark(seq, PARANODE_TRACE_DEQUEUED);
+        if (!_socket.send(buffer)) {
+            _limiter.refund(kind);
+            _stats.requeued++;
+            return sent;
+        }
+        _messageQueue.discardNext(3);
+        frames++;
+        sent++;
+        _stats.sent++;
+        _trace.mark(seq, PARANODE_TRACE_WRITTEN);
+    }
+
+    // Live data (queued since the connection opened) and the outage backlog
+    // share the remaining frames; the backlog goes out as bulk frames. While
+    // batching, batch-class live data waits for flushQueue's batch frame.
+    unsigned long since = _scheduler.liveSince();
+    ParanodeKindFilter alone = _tuning.batching && !batchLive ? &PARANODE_CLASS::sendsAlone : nullptr;
+    while (frames < maxFrames)
+    {
+        unsigned long now = Clock::millis();
+        int live = _messageQueue.peekKindSince(since, alone, this);
+        size_t backlog = _messageQueue.countBefore(since);
+        ParanodeLane lane = _scheduler.next(live >= 0, backlog > 0, now);
+
+        if (lane == PARANODE_LANE_LIVE && !batchLive) {
+            if (!_limiter.tryConsume((uint8_t)live, now)) {
+                break;
+            }
+
+            uint32_t seq = 0;
+            uint8_t kind = 0;
+            _messageQueue.peekSince(since, buffer, PARANODE_MAX_MESSAGE_SIZE, &seq, &kind, alone, this);
+            _trace.mark(seq, PARANODE_TRACE_DEQUEUED);
+            if (!_socket.send(buffer)) {
+                // Left queued with its priority and timestamp for the next try
+                _limiter.refund(kind);
+                _stats.requeued++;
+                break;
+            }
+            _messageQueue.discardNextSince(since, alone, this);
+            sent++;
+            _stats.sent++;
+            _trace.mark(seq, PARANODE_TRACE_WRITTEN);
+            _scheduler.sent(PARANODE_LANE_LIVE);
+        } else if (lane != PARANODE_LANE_NONE) {
+            int batched = sendBatch(lane, lane == PARANODE_LANE_BACKLOG ? PARANODE_MAX_BATCH_SIZE
+                                                                        : (int)_tuning.batchSize);
+            if (batched <= 0) {
+                break;
+            }
+            sent += batched;
+        } else {
+            break;
+        }
+        frames++;
+    }
+    return sent;
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::sendsAlone(void *context, uint8_t kind)
+{
+    return !static_cast<PARANODE_CLASS *>(context)->_policies.get(kind).batch;
+}
+
+PARANODE_TEMPLATE
+int PARANODE_CLASS::sendBatch(ParanodeLane lane, int maxMessages)
+{
+    // Batches select by queue time, so each frame holds only its lane
+    unsigned long since = _scheduler.liveSince();
+    unsigned long now = Clock::millis();
+    bool backlog = lane == PARANODE_LANE_BACKLOG;
+    uint32_t seqs[PARANODE_MAX_BATCH_SIZE];
+    int limit = maxMessages < PARANODE_MAX_BATCH_SIZE ? maxMessages : PARANODE_MAX_BATCH_SIZE;
+
+    // Every admitted message is batched; remember its class for a refund.
+    // A plain function and context, so building a frame never allocates.
+    struct Admission {
+        PARANODE_CLASS *self;
+        unsigned long now;
+        uint8_t kinds[PARANODE_MAX_BATCH_SIZE];
+        int admitted;
+
+        static bool admit(void *context, uint8_t kind) {
+            Admission *admission = static_cast<Admission *>(context);
+            if (!admission->self->_limiter.tryConsume(kind, admission->now)) {
+                return false;
+            }
+            admission->kinds[admission->admitted++] = kind;
+            return true;
+        }
+    };
+    Admission admission = {this, now, {}, 0};
+
+    int batched = backlog ? _messageQueue.batchBefore(since, _batchBuffer, sizeof(_batchBuffer), limit, seqs,
+                                                      &Admission::admit, &admission)
+                          : _messageQueue.batchSince(since, _batchBuffer, sizeof(_batchBuffer), limit, seqs,
+                                                     &Admission::admit, &admission);
+    if (batched <= 0) {
+        return 0;
+    }
+    for (int i = 0; i < batched; i++) {
+        _trace.mark(seqs[i], PARANODE_TRACE_DEQUEUED);
+    }
+
+    if (!_socket.send(_batchBuffer)) {
+        // Still queued, so the tokens are taken again on the retry
+        for (int i = 0; i < admission.admitted; i++) {
+            _limiter.refund(admission.kinds[i]);
+        }
+        _scheduler.failed();
+        return 0;
+    }
+
+    if (backlog) {
+        _messageQueue.discardBefore(since, batched);
+    } else {
+        _messageQueue.discardSince(since, batched);
+    }
+    for (int i = 0; i < batched; i++) {
+        _trace.mark(seqs[i], PARANODE_TRACE_WRITTEN);
+    }
+    _stats.sent += batched;
+    _scheduler.sent(lane);
+    return batched;
+}
+
+PARANODE_TEMPLATE
+int PARANODE_CLASS::flushQueue()
+{
+    if (!_isConnected || _messageQueue.isEmpty()) {
+        return 0;
+    }
+
+    ParanodeScratchScope scratch(_scratch, PARANODE_ENTRY_FLUSH_QUEUE);
+    char *buffer = (char *)scratch.allocate(PARANODE_MAX_MESSAGE_SIZE);
+    if (!buffer) {
+        return 0;
+    }
+
+    // Same lanes, shares and slow start as processQueue: one batch frame
+    // when batching, otherwise whatever the scheduler and limits allow
+    return sendQueued(buffer, _tuning.batching ? 1 : PARANODE_QUEUE_SIZE, _tuning.batching);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::setBatching(bool enable, int batchSize)
+{
+    _tuning.batching = enable ? 1 : 0;
+    if (batchSize > 0) {
+        _tuning.set("batchSize", batchSize);
+    }
+}
+
+PARANODE_TEMPLATE
+size_t PARANODE_CLASS::getQueuedCount() const
+{
+    return _messageQueue.count();
+}
+
+PARANODE_TEMPLATE
+ParanodePressureLevel PARANODE_CLASS::pressure() const
+{
+    return _pressure.level();
+}
+
+PARANODE_TEMPLATE
+ParanodeStats PARANODE_CLASS::getStats() const
+{
+    ParanodeStats stats = _stats;
+    stats.dropped = _messageQueue.droppedCount();
+    stats.expired = _messageQueue.expiredCount();
+    stats.bufferExhausted = _bufferPool.exhaustedCount();
+    stats.throttled = _stats.throttled;
+    stats.shed = _sampler.shedCount();
+    for (uint8_t priority = 0; priority < 4; priority++) {
+        stats.droppedByPriority[priority] = _messageQueue.droppedCount(priority);
+    }
+    return stats;
+}
+
+// Web Integration Features
+
+#if PARANODE_ENABLE_GEOLOCATION
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::sendGeolocation(double latitude, double longitude, float accuracy)
+{
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease) {
+        return false;
+    }
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "geolocation");
+    builder.addDouble("latitude", latitude, 6);
+    builder.addDouble("longitude", longitude, 6);
+    if (accuracy > 0) {
+        builder.addFloat("accuracy", accuracy);
+    }
+    builder.addULong("timestamp", Clock::millis());
+    builder.endObject();
+
+    return sendMessage(builder.getJson(), PARANODE_MSG_TELEMETRY);
+}
+#endif
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::requestWiFiConfig()
+{
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease) {
+        return false;
+    }
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "wifi_config_request");
+    builder.addString("currentSSID", WiFi.SSID().c_str());
+    builder.addInt("currentRSSI", WiFi.RSSI());
+    builder.endObject();
+
+    return sendMessage(builder.getJson(), PARANODE_MSG_REQUEST);
+}
+
+PARANODE_TEMPLATE
+void PARANODE_CLASS::onWiFiConfig(std::function<void(const String &, const String &)> callback)
+{
+    _wifiConfigCallback = callback;
+}
+
+#if PARANODE_ENABLE_JSON_OBJECT_API
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::updateDeviceStatus(const JsonObject &metadata)
+{
+    StaticJsonDocument<512> doc;
+    doc["type"] = "device_status_update";
+    doc["timestamp"] = Clock::millis();
+    doc["uptime"] = getUptime();
+
+    JsonObject meta = doc.createNestedObject("metadata");
+    for (JsonPair kv : metadata) {
+        meta[kv.key()] = kv.value();
+    }
+
+    if (measureJson(doc) >= sizeof(_batchBuffer)) {
+        return false;
+    }
+    serializeJson(doc, _batchBuffer, sizeof(_batchBuffer));
+
+    return sendMessage(_batchBuffer, PARANODE_MSG_STATUS);
+}
+#endif
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::requestProjectInfo()
+{
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease) {
+        return false;
+    }
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "project_info_request");
+    builder.endObject();
+
+    return sendMessage(builder.getJson(), PARANODE_MSG_REQUEST);
+}
+
+// Telemetry builders
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::buildAndSendMessage(const char* key, int value, const char* unit, bool useQueue) {
+    uint8_t priority = _policies.get(PARANODE_MSG_TELEMETRY).priority;
+    ParanodeSampleSummary summary;
+    switch (_sampler.admit(key, (float)value, Clock::millis(), &priority, &summary)) {
+        case PARANODE_SAMPLE_SKIP:
+            return true;
+        case PARANODE_SAMPLE_SUMMARY:
+            return sendSummary(key, summary, unit, useQueue, priority);
+        default:
+            break;
+    }
+
+    uint32_t seq = ++_sequence;
+    _trace.begin(seq);
+
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease) {
+        return false;
+    }
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "telemetry");
+    builder.addULong("seq", seq);
+    builder.addString("key", key);
+    builder.addInt("value", value);
+    if (unit && unit[0] != '\0') {
+        builder.addString("unit", unit);
+    }
+    builder.addULong("timestamp", Clock::millis());
+    builder.endObject();
+
+    return sendMessage(builder.getJson(), PARANODE_MSG_TELEMETRY, seq, priority, useQueue);
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::buildAndSendMessage(const char* key, float value, const char* unit, bool useQueue) {
+    uint8_t priority = _policies.get(PARANODE_MSG_TELEMETRY).priority;
+    ParanodeSampleSummary summary;
+    switch (_sampler.admit(key, (float)value, Clock::millis(), &priority, &summary)) {
+        case PARANODE_SAMPLE_SKIP:
+            return true;
+        case PARANODE_SAMPLE_SUMMARY:
+            return sendSummary(key, summary, unit, useQueue, priority);
+        default:
+            break;
+    }
+
+    uint32_t seq = ++_sequence;
+    _trace.begin(seq);
+
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease) {
+        return false;
+    }
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "telemetry");
+    builder.addULong("seq", seq);
+    builder.addString("key", key);
+    builder.addFloat("value", value);
+    if (unit && unit[0] != '\0') {
+        builder.addString("unit", unit);
+    }
+    builder.addULong("timestamp", Clock::millis());
+    builder.endObject();
+
+    return sendMessage(builder.getJson(), PARANODE_MSG_TELEMETRY, seq, priority, useQueue);
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::buildAndSendMessage(const char* key, bool value, const char* unit, bool useQueue) {
+    uint8_t priority = _policies.get(PARANODE_MSG_TELEMETRY).priority;
+    if (_sampler.admit(key, Clock::millis(), &priority) == PARANODE_SAMPLE_SKIP) {
+        return true;
+    }
+
+    uint32_t seq = ++_sequence;
+    _trace.begin(seq);
+
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease) {
+        return false;
+    }
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "telemetry");
+    builder.addULong("seq", seq);
+    builder.addString("key", key);
+    builder.addBool("value", value);
+    if (unit && unit[0] != '\0') {
+        builder.addString("unit", unit);
+    }
+    builder.addULong("timestamp", Clock::millis());
+    builder.endObject();
+
+    return sendMessage(builder.getJson(), PARANODE_MSG_TELEMETRY, seq, priority, useQueue);
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::buildAndSendMessage(const char* key, const char* value, const char* unit, bool useQueue) {
+    uint8_t priority = _policies.get(PARANODE_MSG_TELEMETRY).priority;
+    if (_sampler.admit(key, Clock::millis(), &priority) == PARANODE_SAMPLE_SKIP) {
+        return true;
+    }
+
+    uint32_t seq = ++_sequence;
+    _trace.begin(seq);
+
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease) {
+        return false;
+    }
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "telemetry");
+    builder.addULong("seq", seq);
+    builder.addString("key", key);
+    builder.addString("value", value);
+    if (unit && unit[0] != '\0') {
+        builder.addString("unit", unit);
+    }
+    builder.addULong("timestamp", Clock::millis());
+    builder.endObject();
+
+    return sendMessage(builder.getJson(), PARANODE_MSG_TELEMETRY, seq, priority, useQueue);
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::buildAndSendMessage(const char* key, const String& value, const char* unit, bool useQueue) {
+    return buildAndSendMessage(key, value.c_str(), unit, useQueue);
+}
+
+PARANODE_TEMPLATE
+bool PARANODE_CLASS::sendSummary(const char* key, const ParanodeSampleSummary& summary, const char* unit,
+                                 bool useQueue, uint8_t priority) {
+    uint32_t seq = ++_sequence;
+    _trace.begin(seq);
+
+    ParanodeBufferLease lease(_bufferPool);
+    if (!lease) {
+        return false;
+    }
+    Encoder builder(lease.data(), lease.size());
+    builder.startObject();
+    builder.addString("type", "telemetry");
+    builder.addULong("seq", seq);
+    builder.addString("key", key);
+    builder.addFloat("value", summary.mean);
+    builder.addFloat("min", summary.min);
+    builder.addFloat("max", summary.max);
+    builder.addULong("count", summary.count);
+    if (unit && unit[0] != '\0') {
+        builder.addString("unit", unit);
+    }
+    builder.addULong("timestamp", Clock::millis());
+    builder.endObject();
+
+    return sendMessage(builder.getJson(), PARANODE_MSG_TELEMETRY, seq, priority, useQueue);
+}
+
+#undef PARANODE_TEMPLATE
+#undef PARANODE_CLASS
+
+#endif
@@ -8,10 +8,14 @@
 #include "ParanodeSocket.h"
 
 ParanodeSocket::ParanodeSocket() : _isConnected(false),
+                                   _capture(nullptr),
                                    _messageCallback(nullptr),
+                                   _rawMessageCallback(nullptr),
+                                   _binaryMessageCallback(nullptr),
                                    _connectCallback(nullptr),
                                    _disconnectCallback(nullptr)
 {
+    _extraHeaders[0] = '\0';
 }
 
 bool ParanodeSocket::connect(const String &url)
@@ -60,6 +64,11 @@ bool ParanodeSocket::connect(const String &url)
     }
 
     _socket.begin(host, port, path, isSecure ? "wss" : "ws");
+    // begin() resets the extra headers to its default
+    if (_extraHeaders[0] != '\0')
+    {
+        _socket.setExtraHeaders(_extraHeaders);
+    }
     _socket.onEvent([this](WStype_t type, uint8_t *payload, size_t length)
                     { this->handleWebSocketEvent(type, payload, length); });
     _socket.setReconnectInterval(5000);
@@ -67,6 +76,16 @@ bool ParanodeSocket::connect(const String &url)
     return true;
 }
 
+void ParanodeSocket::setExtraHeaders(const char *headers)
+{
+    _extraHeaders[0] = '\0';
+    if (headers && strlen(headers) < sizeof(_extraHeaders))
+    {
+        strcpy(_extraHeaders, headers);
+    }
+    _socket.setExtraHeaders(_extraHeaders[0] != '\0' ? _extraHeaders : nullptr);
+}
+
 void ParanodeSocket::disconnect()
 {
     _socket.disconnect();
@@ -80,12 +99,37 @@ bool ParanodeSocket::isConnected()
 
 bool ParanodeSocket::send(const String &message)
 {
-    if (!_isConnected)
+    return send(message.c_str(), message.length());
+}
+
+bool ParanodeSocket::send(const char *message)
+{
+    return message ? send(message, strlen(message)) : false;
+}
+
+bool ParanodeSocket::send(const char *message, size_t length)
+{
+    if (!_isConnected || !message)
     {
         return false;
     }
 
-    return _socket.sendTXT(message.c_str());
+    if (_capture)
+    {
+        _capture->record(PARANODE_CAPTURE_OUTBOUND, message, length);
+    }
+
+#ifdef PARANODE_ALLOCATION_FREE
+    if (length <= PARANODE_TX_BUFFER_SIZE)
+    {
+        // The header is written into the reserved space and the payload is
+        // masked in place, so work on a copy and leave the caller's buffer intact
+        memcpy(_txBuffer + WEBSOCKETS_MAX_HEADER_SIZE, message, length);
+        return _socket.sendTXT(_txBuffer, length, true);
+    }
+#endif
+
+    return _socket.sendTXT(message, length);
 }
 
 void ParanodeSocket::onMessage(MessageCallback callback)
@@ -93,6 +137,16 @@ void ParanodeSocket::onMessage(MessageCallback callback)
     _messageCallback = callback;
 }
 
+void ParanodeSocket::onRawMessage(RawMessageCallback callback)
+{
+    _rawMessageCallback = callback;
+}
+
+void ParanodeSocket::onBinaryMessage(BinaryMessageCallback callback)
+{
+    _binaryMessageCallback = callback;
+}
+
 void ParanodeSocket::onConnect(ConnectionCallback callback)
 {
     _connectCallback = callback;
@@ -108,6 +162,16 @@ void ParanodeSocket::loop()
     _socket.loop();
 }
 
+void ParanodeSocket::injectMessage(const char *payload, size_t length)
+{
+    dispatchText(payload, length);
+}
+
+void ParanodeSocket::setCapture(ParanodeCapture *capture)
+{
+    _capture = capture;
+}
+
 void ParanodeSocket::handleWebSocketEvent(WStype_t type, uint8_t *payload, size_t length)
 {
     switch (type)
@@ -128,13 +192,33 @@ void ParanodeSocket::handleWebSocketEvent(WStype_t type, uint8_t *payload, size_
         }
         break;
     case WStype_TEXT:
-        if (_messageCallback)
+        dispatchText((const char *)payload, length);
+        break;
+    case WStype_BIN:
+        if (_binaryMessageCallback)
         {
-            String message((char *)payload, length);
-            _messageCallback(message);
+            _binaryMessageCallback(payload, length);
         }
         break;
     default:
         break;
     }
+}
+
+void ParanodeSocket::dispatchText(const char *payload, size_t length)
+{
+    if (_capture)
+    {
+        _capture->record(PARANODE_CAPTURE_INBOUND, payload, length);
+    }
+
+    if (_rawMessageCallback)
+    {
+        _rawMessageCallback(payload, length);
+    }
+    else if (_messageCallback)
+    {
+        String message(payload, length);
+        _messageCallback(message);
+    }
 }
\ No newline at end of file
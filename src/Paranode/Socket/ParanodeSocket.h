@@ -10,6 +10,8 @@
 
 #include <Arduino.h>
 #include <functional>
+#include "Paranode/ParanodeConfig.h"
+#include "Paranode/Utils/ParanodeCapture.h"
 
 #ifdef ESP8266
 #include <ESP8266WiFi.h>
@@ -21,7 +23,18 @@
 #error "This library only supports ESP8266 and ESP32 boards"
 #endif
 
+#ifndef PARANODE_TX_BUFFER_SIZE
+#define PARANODE_TX_BUFFER_SIZE 1024
+#endif
+
+// Upgrade request headers: "X-Paranode-Session: " and a session token
+#ifndef PARANODE_EXTRA_HEADERS_SIZE
+#define PARANODE_EXTRA_HEADERS_SIZE (PARANODE_MAX_TOKEN_LENGTH + 24)
+#endif
+
 typedef std::function<void(const String &)> MessageCallback;
+typedef std::function<void(const char *, size_t)> RawMessageCallback;
+typedef std::function<void(const uint8_t *, size_t)> BinaryMessageCallback;
 typedef std::function<void(void)> ConnectionCallback;
 
 /**
@@ -43,6 +56,16 @@ public:
      */
     bool connect(const String &url);
 
+    /**
+     * @brief Extra HTTP headers for the upgrade request
+     * @param headers "Name: value" lines separated by "\r\n" (no trailing
+     *        newline), or nullptr for none
+     * @note Kept across connect() calls and the client's own reconnects.
+     *       Headers that don't fit PARANODE_EXTRA_HEADERS_SIZE are dropped
+     *       rather than sent truncated.
+     */
+    void setExtraHeaders(const char *headers);
+
     /**
      * @brief Disconnect from the WebSocket server
      */
@@ -61,12 +84,39 @@ public:
      */
     bool send(const String &message);
 
+    /**
+     * @brief Send a message without going through String
+     * @param message Message to send
+     * @param length Message length
+     * @return True if message is sent successfully, false otherwise
+     * @note With PARANODE_ALLOCATION_FREE defined, frames up to
+     *       PARANODE_TX_BUFFER_SIZE bytes are framed in a static buffer
+     *       instead of a temporary heap buffer inside WebSocketsClient.
+     */
+    bool send(const char *message, size_t length);
+    bool send(const char *message);
+
     /**
      * @brief Set callback for received messages
      * @param callback Function to be called when a message is received
      */
     void onMessage(MessageCallback callback);
 
+    /**
+     * @brief Set callback for received messages without a String copy
+     * @param callback Function called with the frame payload and length
+     * @note Takes precedence over onMessage()
+     */
+    void onRawMessage(RawMessageCallback callback);
+
+    /**
+     * @brief Set callback for received binary frames
+     * @param callback Function called with the frame payload and length
+     * @note The payload points into WebSocketsClient's receive buffer and is
+     *       only valid during the call
+     */
+    void onBinaryMessage(BinaryMessageCallback callback);
+
     /**
      * @brief Set callback for successful connection
      * @param callback Function to be called when connection is established
@@ -85,15 +135,38 @@ public:
      */
     void loop();
 
+    /**
+     * @brief Feed a frame through the receive path as if it came from the server
+     * @param payload Frame payload
+     * @param length Payload length
+     */
+    void injectMessage(const char *payload, size_t length);
+
+    /**
+     * @brief Record inbound and outbound frames
+     * @param capture Capture sink, or nullptr to stop recording
+     */
+    void setCapture(ParanodeCapture *capture);
+
 private:
     WebSocketsClient _socket;
     bool _isConnected;
+    ParanodeCapture *_capture;
+    char _extraHeaders[PARANODE_EXTRA_HEADERS_SIZE];
+
+#ifdef PARANODE_ALLOCATION_FREE
+    // Room for the WebSocket header in front of the payload
+    uint8_t _txBuffer[WEBSOCKETS_MAX_HEADER_SIZE + PARANODE_TX_BUFFER_SIZE];
+#endif
 
     MessageCallback _messageCallback;
+    RawMessageCallback _rawMessageCallback;
+    BinaryMessageCallback _binaryMessageCallback;
     ConnectionCallback _connectCallback;
     ConnectionCallback _disconnectCallback;
 
     void handleWebSocketEvent(WStype_t type, uint8_t *payload, size_t length);
+    void dispatchText(const char *payload, size_t length);
 };
 
 #endif
\ No newline at end of file
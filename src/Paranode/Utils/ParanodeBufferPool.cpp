@@ -0,0 +1,78 @@
+/**
+ * @file ParanodeBufferPool.cpp
+ * @brief Implementation of the message buffer pool
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "ParanodeBufferPool.h"
+
+#if PARANODE_BUFFER_POOL_SIZE < 1 || PARANODE_BUFFER_POOL_SIZE > 8
+#error "PARANODE_BUFFER_POOL_SIZE must be between 1 and 8"
+#endif
+
+// Leases can be taken from another task, so the bitmask update is atomic
+#ifdef ESP32
+static portMUX_TYPE poolMux = portMUX_INITIALIZER_UNLOCKED;
+#define POOL_LOCK() portENTER_CRITICAL(&poolMux)
+#define POOL_UNLOCK() portEXIT_CRITICAL(&poolMux)
+#else
+#define POOL_LOCK() noInterrupts()
+#define POOL_UNLOCK() interrupts()
+#endif
+
+static uint8_t countBits(uint8_t mask) {
+    uint8_t count = 0;
+    while (mask) {
+        mask &= mask - 1;
+        count++;
+    }
+    return count;
+}
+
+ParanodeBufferPool::ParanodeBufferPool()
+    : _leased(0), _peak(0), _exhausted(0) {
+}
+
+char* ParanodeBufferPool::acquire() {
+    int slot = -1;
+
+    POOL_LOCK();
+    for (int i = 0; i < PARANODE_BUFFER_POOL_SIZE; i++) {
+        if (!(_leased & (1 << i))) {
+            _leased |= (1 << i);
+            slot = i;
+            break;
+        }
+    }
+    uint8_t leased = _leased;
+    POOL_UNLOCK();
+
+    if (slot < 0) {
+        _exhausted++;
+        return nullptr;
+    }
+
+    uint8_t count = countBits(leased);
+    if (count > _peak) {
+        _peak = count;
+    }
+
+    _buffers[slot][0] = '\0';
+    return _buffers[slot];
+}
+
+void ParanodeBufferPool::release(char* buffer) {
+    for (int i = 0; i < PARANODE_BUFFER_POOL_SIZE; i++) {
+        if (buffer == _buffers[i]) {
+            POOL_LOCK();
+            _leased &= ~(1 << i);
+            POOL_UNLOCK();
+            return;
+        }
+    }
+}
+
+uint8_t ParanodeBufferPool::inUse() const {
+    return countBits(_leased);
+}
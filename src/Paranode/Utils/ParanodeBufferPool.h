@@ -0,0 +1,102 @@
+/**
+ * @file ParanodeBufferPool.h
+ * @brief Fixed pool of message buffers handed out as RAII leases
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Every outbound message is built in a leased buffer instead of one shared
+ * buffer, so a send made from inside a callback can't overwrite a message
+ * that is still being built or written. Only taking and returning a lease
+ * is locked; the send path behind it is not, so Paranode must still be
+ * called from a single task.
+ */
+
+#ifndef PARANODE_BUFFER_POOL_H
+#define PARANODE_BUFFER_POOL_H
+
+#include <Arduino.h>
+#include "ParanodeMessageQueue.h"
+
+// Concurrent builds (loop + one send nested in a callback); max 8
+#ifndef PARANODE_BUFFER_POOL_SIZE
+#define PARANODE_BUFFER_POOL_SIZE 2
+#endif
+
+/**
+ * @class ParanodeBufferPool
+ * @brief PARANODE_BUFFER_POOL_SIZE buffers of PARANODE_MAX_MESSAGE_SIZE bytes
+ */
+class ParanodeBufferPool {
+public:
+    /**
+     * @brief Constructor
+     */
+    ParanodeBufferPool();
+
+    /**
+     * @brief Take a free buffer
+     * @return Buffer of PARANODE_MAX_MESSAGE_SIZE bytes, or nullptr if all are leased
+     */
+    char* acquire();
+
+    /**
+     * @brief Return a buffer taken with acquire()
+     */
+    void release(char* buffer);
+
+    /**
+     * @brief Buffers currently leased
+     */
+    uint8_t inUse() const;
+
+    /**
+     * @brief Most buffers leased at once since startup
+     */
+    uint8_t peakInUse() const { return _peak; }
+
+    /**
+     * @brief Sends refused because every buffer was leased
+     */
+    uint32_t exhaustedCount() const { return _exhausted; }
+
+private:
+    char _buffers[PARANODE_BUFFER_POOL_SIZE][PARANODE_MAX_MESSAGE_SIZE];
+    volatile uint8_t _leased; // Bit i set = buffer i in use
+    uint8_t _peak;
+    uint32_t _exhausted;
+};
+
+/**
+ * @class ParanodeBufferLease
+ * @brief Holds a pool buffer until it goes out of scope
+ *
+ * @code
+ * ParanodeBufferLease lease(_bufferPool);
+ * if (!lease) return false;
+ * ParanodeJsonBuilder builder(lease.data(), lease.size());
+ * @endcode
+ */
+class ParanodeBufferLease {
+public:
+    explicit ParanodeBufferLease(ParanodeBufferPool& pool)
+        : _pool(pool), _buffer(pool.acquire()) {}
+
+    ~ParanodeBufferLease() {
+        if (_buffer) {
+            _pool.release(_buffer);
+        }
+    }
+
+    char* data() { return _buffer; }
+    size_t size() const { return PARANODE_MAX_MESSAGE_SIZE; }
+    explicit operator bool() const { return _buffer != nullptr; }
+
+private:
+    ParanodeBufferPool& _pool;
+    char* _buffer;
+
+    ParanodeBufferLease(const ParanodeBufferLease&);
+    ParanodeBufferLease& operator=(const ParanodeBufferLease&);
+};
+
+#endif
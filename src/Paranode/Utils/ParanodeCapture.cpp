@@ -0,0 +1,88 @@
+/**
+ * @file ParanodeCapture.cpp
+ * @brief Implementation of frame capture and replay
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "ParanodeCapture.h"
+
+static const char CAPTURE_MAGIC[4] = {'P', 'N', 'C', '1'};
+
+ParanodeCapture::ParanodeCapture() : _out(nullptr), _frames(0) {}
+
+void ParanodeCapture::begin(Print& out) {
+    _out = &out;
+    _frames = 0;
+    _out->write((const uint8_t*)CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+}
+
+void ParanodeCapture::end() {
+    _out = nullptr;
+}
+
+void ParanodeCapture::record(uint8_t direction, const char* data, size_t length) {
+    if (!_out || !data) {
+        return;
+    }
+
+    if (length > 0xFFFF) {
+        length = 0xFFFF;
+    }
+
+    uint32_t timestamp = millis();
+    uint8_t header[7];
+    header[0] = direction;
+    header[1] = timestamp & 0xFF;
+    header[2] = (timestamp >> 8) & 0xFF;
+    header[3] = (timestamp >> 16) & 0xFF;
+    header[4] = (timestamp >> 24) & 0xFF;
+    header[5] = length & 0xFF;
+    header[6] = (length >> 8) & 0xFF;
+
+    _out->write(header, sizeof(header));
+    _out->write((const uint8_t*)data, length);
+    _frames++;
+}
+
+ParanodeCaptureReader::ParanodeCaptureReader(Stream& in) : _in(in) {}
+
+bool ParanodeCaptureReader::begin() {
+    uint8_t magic[4];
+    if (!readExact(magic, sizeof(magic))) {
+        return false;
+    }
+    return memcmp(magic, CAPTURE_MAGIC, sizeof(magic)) == 0;
+}
+
+int ParanodeCaptureReader::next(ParanodeCaptureRecord& record, char* buffer, size_t bufferSize) {
+    uint8_t header[7];
+    if (!buffer || bufferSize == 0 || !readExact(header, sizeof(header))) {
+        return -1;
+    }
+
+    record.direction = header[0];
+    record.timestamp = (uint32_t)header[1] | ((uint32_t)header[2] << 8) |
+                       ((uint32_t)header[3] << 16) | ((uint32_t)header[4] << 24);
+    record.length = (uint16_t)header[5] | ((uint16_t)header[6] << 8);
+
+    size_t stored = record.length < bufferSize ? record.length : bufferSize - 1;
+    if (!readExact((uint8_t*)buffer, stored)) {
+        return -1;
+    }
+    buffer[stored] = '\0';
+
+    // Skip what didn't fit
+    for (size_t i = stored; i < record.length; i++) {
+        uint8_t discard;
+        if (!readExact(&discard, 1)) {
+            return -1;
+        }
+    }
+
+    return (int)stored;
+}
+
+bool ParanodeCaptureReader::readExact(uint8_t* data, size_t length) {
+    return _in.readBytes(data, length) == length;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file ParanodeCapture.h
+ * @brief Compact recording and replay of WebSocket frames
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Capture format (little endian):
+ * - File header: "PNC1"
+ * - Per frame:   direction (1 byte), timestamp ms (4 bytes),
+ *                length (2 bytes), payload (length bytes)
+ *
+ * The writer works with any Print (File, Serial, ...) and the reader with
+ * any Stream, so captures can be stored on LittleFS/SPIFFS or streamed to
+ * a host for later replay.
+ */
+
+#ifndef PARANODE_CAPTURE_H
+#define PARANODE_CAPTURE_H
+
+#include <Arduino.h>
+
+#define PARANODE_CAPTURE_INBOUND 0
+#define PARANODE_CAPTURE_OUTBOUND 1
+
+/**
+ * @struct ParanodeCaptureRecord
+ * @brief Header of a single captured frame
+ */
+struct ParanodeCaptureRecord {
+    uint8_t direction;       // PARANODE_CAPTURE_INBOUND or PARANODE_CAPTURE_OUTBOUND
+    uint32_t timestamp;      // millis() when the frame was seen
+    uint16_t length;         // Full payload length
+};
+
+/**
+ * @class ParanodeCapture
+ * @brief Writes captured frames to a Print
+ */
+class ParanodeCapture {
+public:
+    /**
+     * @brief Constructor
+     */
+    ParanodeCapture();
+
+    /**
+     * @brief Start a capture and write the file header
+     * @param out Destination (File, Serial, ...)
+     */
+    void begin(Print& out);
+
+    /**
+     * @brief Stop capturing
+     */
+    void end();
+
+    /**
+     * @brief Check if a capture is running
+     */
+    bool isActive() const { return _out != nullptr; }
+
+    /**
+     * @brief Record a frame
+     * @param direction PARANODE_CAPTURE_INBOUND or PARANODE_CAPTURE_OUTBOUND
+     * @param data Frame payload
+     * @param length Payload length (frames over 65535 bytes are truncated)
+     */
+    void record(uint8_t direction, const char* data, size_t length);
+
+    /**
+     * @brief Number of frames recorded since begin()
+     */
+    uint32_t frameCount() const { return _frames; }
+
+private:
+    Print* _out;
+    uint32_t _frames;
+};
+
+/**
+ * @class ParanodeCaptureReader
+ * @brief Reads frames back from a capture
+ */
+class ParanodeCaptureReader {
+public:
+    /**
+     * @brief Constructor
+     * @param in Source stream positioned at the file header
+     */
+    explicit ParanodeCaptureReader(Stream& in);
+
+    /**
+     * @brief Read and validate the file header
+     * @return True if the stream is a Paranode capture
+     */
+    bool begin();
+
+    /**
+     * @brief Read the next frame
+     * @param record Output frame header
+     * @param buffer Output payload buffer (null-terminated)
+     * @param bufferSize Buffer size
+     * @return Number of payload bytes stored in buffer, -1 at end of capture
+     * @note Payload bytes that don't fit in the buffer are skipped.
+     */
+    int next(ParanodeCaptureRecord& record, char* buffer, size_t bufferSize);
+
+private:
+    Stream& _in;
+
+    bool readExact(uint8_t* data, size_t length);
+};
+
+#endif
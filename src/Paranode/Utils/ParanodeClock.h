@@ -0,0 +1,23 @@
+/**
+ * @file ParanodeClock.h
+ * @brief Default clock policy for BasicParanode
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#ifndef PARANODE_CLOCK_H
+#define PARANODE_CLOCK_H
+
+#include <Arduino.h>
+
+/**
+ * @struct ParanodeClock
+ * @brief Arduino millis()/micros(); substitute a struct with the same static
+ *        functions to drive BasicParanode from a fake clock
+ */
+struct ParanodeClock {
+    static unsigned long millis() { return ::millis(); }
+    static unsigned long micros() { return ::micros(); }
+};
+
+#endif
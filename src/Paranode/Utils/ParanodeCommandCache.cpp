@@ -0,0 +1,236 @@
+/**
+ * @file ParanodeCommandCache.cpp
+ * @brief Implementation of the recent-command cache
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "ParanodeCommandCache.h"
+#include <stddef.h>
+
+enum {
+    ENTRY_FREE = 0,
+    ENTRY_PENDING = 1,
+    ENTRY_ANSWERED = 2
+};
+
+static void copyText(char* dest, size_t size, const char* src) {
+    if (!src) {
+        src = "";
+    }
+    size_t length = strnlen(src, size - 1);
+    memcpy(dest, src, length);
+    dest[length] = '\0';
+}
+
+#if PARANODE_COMMAND_CACHE_PERSIST
+
+static const uint32_t COMMAND_CACHE_MAGIC = 0x32434350; // "PCC2"
+
+#ifdef ESP8266
+// 512 bytes of RTC user memory, shared with the sketch
+static const size_t RTC_BYTES = 512 - PARANODE_COMMAND_RTC_OFFSET * 4;
+#endif
+
+struct ParanodeCommandCache::Record {
+#ifdef ESP8266
+    // The newest entries that fit
+    static const size_t CAPACITY = (RTC_BYTES - 3 * sizeof(uint32_t)) / sizeof(Entry) < PARANODE_COMMAND_CACHE_SIZE
+                                       ? (RTC_BYTES - 3 * sizeof(uint32_t)) / sizeof(Entry)
+                                       : PARANODE_COMMAND_CACHE_SIZE;
+#else
+    static const size_t CAPACITY = PARANODE_COMMAND_CACHE_SIZE;
+#endif
+
+    uint32_t magic;
+    uint32_t count;
+    uint32_t checksum; // Of magic, count and the first count entries
+    Entry entries[CAPACITY];
+    static_assert(sizeof(Entry) % 4 == 0, "RTC user memory is written in 4-byte blocks");
+};
+
+#ifdef ESP32
+// Survives ESP.restart() and watchdog resets, not power loss
+RTC_NOINIT_ATTR ParanodeCommandCache::Record ParanodeCommandCache::_rtcRecord;
+#endif
+
+static uint32_t recordChecksum(const void* data, size_t length, uint32_t h = 2166136261UL) {
+    // FNV-1a, continued from h
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < length; i++) {
+        h = (h ^ bytes[i]) * 16777619UL;
+    }
+    return h;
+}
+
+// The record is read and written a piece at a time, so ESP8266 needs no
+// Record-sized copy on the stack
+bool ParanodeCommandCache::readRtc(size_t offset, void* data, size_t size) {
+#ifdef ESP8266
+    return ESP.rtcUserMemoryRead(PARANODE_COMMAND_RTC_OFFSET + offset / 4, (uint32_t*)data, size);
+#else
+    memcpy(data, (const uint8_t*)&_rtcRecord + offset, size);
+    return true;
+#endif
+}
+
+void ParanodeCommandCache::writeRtc(size_t offset, const void* data, size_t size) {
+#ifdef ESP8266
+    ESP.rtcUserMemoryWrite(PARANODE_COMMAND_RTC_OFFSET + offset / 4, (uint32_t*)data, size);
+#else
+    memcpy((uint8_t*)&_rtcRecord + offset, data, size);
+#endif
+}
+
+#endif
+
+ParanodeCommandCache::ParanodeCommandCache() : _next(0), _duplicates(0) {
+    for (size_t i = 0; i < PARANODE_COMMAND_CACHE_SIZE; i++) {
+        _entries[i].state = ENTRY_FREE;
+    }
+}
+
+ParanodeCommandSeen ParanodeCommandCache::check(const char* id, unsigned long now, const char** status,
+                                                const char** response) {
+    Entry* entry = find(id, now);
+    if (entry && entry->state == ENTRY_PENDING && now - entry->seenAt > PARANODE_COMMAND_PENDING_TIMEOUT) {
+        // Never answered: run it again rather than ignore it until the TTL
+        entry->seenAt = now;
+        persist();
+        return PARANODE_COMMAND_NEW;
+    }
+    if (entry) {
+        _duplicates++;
+        if (entry->state == ENTRY_PENDING) {
+            return PARANODE_COMMAND_PENDING;
+        }
+        if (status) {
+            *status = entry->status;
+        }
+        if (response) {
+            *response = entry->response;
+        }
+        return PARANODE_COMMAND_ANSWERED;
+    }
+
+    // Overwrite the oldest
+    entry = &_entries[_next];
+    _next = (_next + 1) % PARANODE_COMMAND_CACHE_SIZE;
+    copyText(entry->id, sizeof(entry->id), id);
+    entry->status[0] = '\0';
+    entry->response[0] = '\0';
+    entry->seenAt = now;
+    entry->state = ENTRY_PENDING;
+    persist();
+    return PARANODE_COMMAND_NEW;
+}
+
+void ParanodeCommandCache::complete(const char* id, const char* status, const char* response) {
+    if (!id || id[0] == '\0') {
+        return;
+    }
+
+    for (size_t i = 0; i < PARANODE_COMMAND_CACHE_SIZE; i++) {
+        Entry& entry = _entries[i];
+        if (entry.state != ENTRY_FREE && strcmp(entry.id, id) == 0) {
+            copyText(entry.status, sizeof(entry.status), status);
+            copyText(entry.response, sizeof(entry.response), response);
+            entry.state = ENTRY_ANSWERED;
+            persist();
+            return;
+        }
+    }
+}
+
+size_t ParanodeCommandCache::restore(unsigned long now) {
+#if PARANODE_COMMAND_CACHE_PERSIST
+    uint32_t header[3]; // magic, count, checksum
+    if (!readRtc(0, header, sizeof(header)) || header[0] != COMMAND_CACHE_MAGIC || header[1] > Record::CAPACITY) {
+        return 0;
+    }
+
+    // Straight into the ring, which is cleared again if the checksum fails
+    clear();
+    size_t count = header[1];
+    uint32_t checksum = recordChecksum(header, 2 * sizeof(uint32_t));
+    for (size_t i = 0; i < count; i++) {
+        readRtc(offsetof(Record, entries) + i * sizeof(Entry), &_entries[i], sizeof(Entry));
+        checksum = recordChecksum(&_entries[i], sizeof(Entry), checksum);
+    }
+    if (checksum != header[2]) {
+        clear();
+        return 0;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        _entries[i].id[sizeof(_entries[i].id) - 1] = '\0';
+        _entries[i].seenAt = now;
+        if (_entries[i].state == ENTRY_PENDING) {
+            // The reset cut it short; it may have been the cause
+            copyText(_entries[i].status, sizeof(_entries[i].status), "interrupted");
+            _entries[i].response[0] = '\0';
+            _entries[i].state = ENTRY_ANSWERED;
+        }
+    }
+    _next = count % PARANODE_COMMAND_CACHE_SIZE;
+    return count;
+#else
+    (void)now;
+    return 0;
+#endif
+}
+
+void ParanodeCommandCache::clear() {
+    for (size_t i = 0; i < PARANODE_COMMAND_CACHE_SIZE; i++) {
+        _entries[i].state = ENTRY_FREE;
+    }
+    _next = 0;
+}
+
+ParanodeCommandCache::Entry* ParanodeCommandCache::find(const char* id, unsigned long now) {
+    for (size_t i = 0; i < PARANODE_COMMAND_CACHE_SIZE; i++) {
+        Entry& entry = _entries[i];
+        if (entry.state != ENTRY_FREE && now - entry.seenAt <= PARANODE_COMMAND_CACHE_TTL &&
+            strcmp(entry.id, id) == 0) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void ParanodeCommandCache::persist() {
+#if PARANODE_COMMAND_CACHE_PERSIST
+    // Oldest to newest, keeping the newest CAPACITY entries
+    size_t index = _next;
+    size_t used = 0;
+    for (size_t i = 0; i < PARANODE_COMMAND_CACHE_SIZE; i++) {
+        if (_entries[index].state != ENTRY_FREE) {
+            used++;
+        }
+        index = (index + 1) % PARANODE_COMMAND_CACHE_SIZE;
+    }
+    size_t skip = used > Record::CAPACITY ? used - Record::CAPACITY : 0;
+
+    uint32_t header[3] = {COMMAND_CACHE_MAGIC, (uint32_t)(used - skip), 0};
+    uint32_t checksum = recordChecksum(header, 2 * sizeof(uint32_t));
+    size_t count = 0;
+    for (size_t i = 0; i < PARANODE_COMMAND_CACHE_SIZE; i++) {
+        const Entry& entry = _entries[index];
+        index = (index + 1) % PARANODE_COMMAND_CACHE_SIZE;
+        if (entry.state == ENTRY_FREE) {
+            continue;
+        }
+        if (skip > 0) {
+            skip--;
+            continue;
+        }
+        writeRtc(offsetof(Record, entries) + count * sizeof(Entry), &entry, sizeof(Entry));
+        checksum = recordChecksum(&entry, sizeof(Entry), checksum);
+        count++;
+    }
+
+    // Header last: a reset part way through leaves a checksum that fails
+    header[2] = checksum;
+    writeRtc(0, header, sizeof(header));
+#endif
+}
@@ -0,0 +1,118 @@
+/**
+ * @file ParanodeCommandCache.h
+ * @brief Recently seen command IDs and their responses, for idempotent commands
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#ifndef PARANODE_COMMAND_CACHE_H
+#define PARANODE_COMMAND_CACHE_H
+
+#include <Arduino.h>
+#include "Paranode/ParanodeConfig.h"
+
+// How long a command ID is remembered
+#ifndef PARANODE_COMMAND_CACHE_TTL
+#define PARANODE_COMMAND_CACHE_TTL 600000
+#endif
+
+// How long a command stays pending without a response before a redelivery
+// runs it again
+#ifndef PARANODE_COMMAND_PENDING_TIMEOUT
+#define PARANODE_COMMAND_PENDING_TIMEOUT 60000
+#endif
+
+#ifndef PARANODE_MAX_COMMAND_ID_LENGTH
+#define PARANODE_MAX_COMMAND_ID_LENGTH 40
+#endif
+
+// Cached response text; longer responses are replayed truncated
+#ifndef PARANODE_COMMAND_RESPONSE_SIZE
+#define PARANODE_COMMAND_RESPONSE_SIZE 48
+#endif
+
+// Keep the cache in RTC memory across warm resets (1 = on)
+#ifndef PARANODE_COMMAND_CACHE_PERSIST
+#define PARANODE_COMMAND_CACHE_PERSIST 1
+#endif
+
+// ESP8266: first 4-byte block of the RTC user memory used by the cache
+#ifndef PARANODE_COMMAND_RTC_OFFSET
+#define PARANODE_COMMAND_RTC_OFFSET 0
+#endif
+
+enum ParanodeCommandSeen : uint8_t {
+    PARANODE_COMMAND_NEW,      // First delivery: run it
+    PARANODE_COMMAND_PENDING,  // Redelivered before the sketch answered (within the timeout): ignore
+    PARANODE_COMMAND_ANSWERED  // Redelivered after the answer: replay it
+};
+
+/**
+ * @class ParanodeCommandCache
+ * @brief Fixed ring of command IDs with the response sent for each
+ *
+ * The oldest entry is overwritten when the ring is full. After a warm reset
+ * (ESP.restart(), watchdog) the entries are restored from RTC memory and
+ * their TTL starts again, since millis() restarts from zero. A command that
+ * was still pending when the device reset is restored as answered with
+ * status "interrupted", so its redelivery is reported rather than run again.
+ */
+class ParanodeCommandCache {
+public:
+    ParanodeCommandCache();
+
+    /**
+     * @brief Look up a command ID, remembering it as pending if it is new
+     * @param status Set to the cached status when PARANODE_COMMAND_ANSWERED
+     * @param response Set to the cached response when PARANODE_COMMAND_ANSWERED
+     */
+    ParanodeCommandSeen check(const char* id, unsigned long now, const char** status, const char** response);
+
+    /**
+     * @brief Remember the response sent for a command
+     */
+    void complete(const char* id, const char* status, const char* response);
+
+    /**
+     * @brief Reload entries kept in RTC memory by the previous boot
+     * @return Number of entries restored
+     */
+    size_t restore(unsigned long now);
+
+    /**
+     * @brief Forget every command
+     */
+    void clear();
+
+    /**
+     * @brief Redelivered commands that were not run again
+     */
+    uint32_t duplicateCount() const { return _duplicates; }
+
+private:
+    struct Entry {
+        char id[PARANODE_MAX_COMMAND_ID_LENGTH];
+        char status[12];
+        char response[PARANODE_COMMAND_RESPONSE_SIZE];
+        uint32_t seenAt;
+        uint8_t state; // 0 = free, 1 = pending, 2 = answered
+    };
+
+    struct Record; // RTC memory image, defined in the .cpp
+#if PARANODE_COMMAND_CACHE_PERSIST && defined(ESP32)
+    static Record _rtcRecord;
+#endif
+#if PARANODE_COMMAND_CACHE_PERSIST
+    static bool readRtc(size_t offset, void* data, size_t size);
+    static void writeRtc(size_t offset, const void* data, size_t size);
+#endif
+
+    Entry _entries[PARANODE_COMMAND_CACHE_SIZE];
+    size_t _next;
+    uint32_t _duplicates;
+
+    Entry* find(const char* id, unsigned long now);
+    void persist();
+};
+
+#endif
@@ -0,0 +1,70 @@
+/**
+ * @file ParanodeCommandQueue.cpp
+ * @brief Implementation of the inbound command queue
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "ParanodeCommandQueue.h"
+
+ParanodeCommandQueue::ParanodeCommandQueue() : _used(0), _count(0) {
+}
+
+uint8_t* ParanodeCommandQueue::reserve(size_t* capacity) {
+    size_t free = sizeof(_buffer) - _used;
+    if (free <= sizeof(Header)) {
+        if (capacity) {
+            *capacity = 0;
+        }
+        return nullptr;
+    }
+    if (capacity) {
+        *capacity = free - sizeof(Header);
+    }
+    return _buffer + _used + sizeof(Header);
+}
+
+void ParanodeCommandQueue::commit(uint16_t length, ParanodeCommandKind kind, unsigned long now,
+                                  uint16_t frameLength) {
+    if (length == 0 || _used + sizeof(Header) + length > sizeof(_buffer)) {
+        return;
+    }
+
+    // Headers are copied, records are not aligned
+    Header header;
+    header.length = length;
+    header.kind = kind;
+    header.frameLength = frameLength;
+    header.receivedAt = now;
+    memcpy(_buffer + _used, &header, sizeof(header));
+    _used += sizeof(Header) + length;
+    _count++;
+}
+
+bool ParanodeCommandQueue::front(ParanodeCommandRecord& record) const {
+    if (_count == 0) {
+        return false;
+    }
+
+    Header header;
+    memcpy(&header, _buffer, sizeof(header));
+    record.data = _buffer + sizeof(Header);
+    record.length = header.length;
+    record.kind = header.kind;
+    record.frameLength = header.frameLength;
+    record.receivedAt = header.receivedAt;
+    return true;
+}
+
+void ParanodeCommandQueue::pop() {
+    if (_count == 0) {
+        return;
+    }
+
+    Header header;
+    memcpy(&header, _buffer, sizeof(header));
+    size_t size = sizeof(Header) + header.length;
+    memmove(_buffer, _buffer + size, _used - size);
+    _used -= size;
+    _count--;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file ParanodeCommandQueue.h
+ * @brief Inbound commands waiting to run from Paranode::loop()
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#ifndef PARANODE_COMMAND_QUEUE_H
+#define PARANODE_COMMAND_QUEUE_H
+
+#include <Arduino.h>
+#include "Paranode/ParanodeConfig.h"
+
+// Default time loop() may spend running queued commands, in ms
+#ifndef PARANODE_COMMAND_BUDGET
+#define PARANODE_COMMAND_BUDGET 20
+#endif
+
+enum ParanodeCommandKind : uint8_t {
+    PARANODE_COMMAND_SINGLE, // One "command" object
+    PARANODE_COMMAND_BATCH   // A whole "command_batch" message
+};
+
+/**
+ * @struct ParanodeCommandRecord
+ * @brief View of one queued command in its compact (MessagePack) form
+ */
+struct ParanodeCommandRecord {
+    const uint8_t* data;
+    uint16_t length;
+    uint8_t kind;
+    uint16_t frameLength; // Inbound frame it came from, for receive credits
+    unsigned long receivedAt;
+};
+
+/**
+ * @class ParanodeCommandQueue
+ * @brief FIFO of variable-length records in one fixed byte buffer
+ *
+ * Records are packed back to back, so a 20-command batch and a burst of
+ * single commands draw on the same PARANODE_COMMAND_QUEUE_BYTES. Removing
+ * the oldest record moves the rest forward; the buffer is small, so this
+ * costs less than tracking a wrap-around.
+ */
+class ParanodeCommandQueue {
+public:
+    ParanodeCommandQueue();
+
+    /**
+     * @brief Free space at the back of the queue
+     * @param capacity Set to the bytes that may be written there
+     * @return Where to write the record, or nullptr if the queue is full
+     * @note The record is queued only once commit() is called.
+     */
+    uint8_t* reserve(size_t* capacity);
+
+    /**
+     * @brief Queue the record written after reserve()
+     */
+    void commit(uint16_t length, ParanodeCommandKind kind, unsigned long now, uint16_t frameLength);
+
+    /**
+     * @brief View the oldest record
+     * @return False if the queue is empty
+     */
+    bool front(ParanodeCommandRecord& record) const;
+
+    /**
+     * @brief Remove the oldest record
+     */
+    void pop();
+
+    size_t count() const { return _count; }
+    bool isEmpty() const { return _count == 0; }
+
+    /**
+     * @brief Bytes in use, including record headers
+     */
+    size_t bytes() const { return _used; }
+
+private:
+    struct Header {
+        uint32_t receivedAt;
+        uint16_t length;
+        uint16_t frameLength;
+        uint8_t kind;
+    };
+
+    uint8_t _buffer[PARANODE_COMMAND_QUEUE_BYTES];
+    size_t _used;
+    size_t _count;
+};
+
+#endif
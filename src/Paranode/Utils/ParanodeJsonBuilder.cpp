@@ -23,6 +23,8 @@ void ParanodeJsonBuilder::reset() {
 }
 
 void ParanodeJsonBuilder::startObject() {
+    // Separates objects inside an array
+    addCommaIfNeeded();
     appendChar('{');
     _firstElement = true;
 }
@@ -30,6 +32,7 @@ void ParanodeJsonBuilder::startObject() {
 void ParanodeJsonBuilder::endObject() {
     appendChar('}');
     _buffer[_position] = '\0';
+    _firstElement = false;
 }
 
 void ParanodeJsonBuilder::addString(const char* key, const char* value) {
@@ -110,6 +113,22 @@ void ParanodeJsonBuilder::startNestedObject(const char* key) {
     _firstElement = true;
 }
 
+void ParanodeJsonBuilder::startNestedArray(const char* key) {
+    if (!hasSpace(strlen(key) + 5)) return;
+
+    addCommaIfNeeded();
+    appendChar('"');
+    appendString(key);
+    appendString("\":[");
+    _firstElement = true;
+}
+
+void ParanodeJsonBuilder::endArray() {
+    appendChar(']');
+    _buffer[_position] = '\0';
+    _firstElement = false;
+}
+
 void ParanodeJsonBuilder::addCommaIfNeeded() {
     if (!_firstElement) {
         appendChar(',');
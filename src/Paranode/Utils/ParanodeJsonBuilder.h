@@ -73,6 +73,16 @@ public:
      */
     void startNestedObject(const char* key);
 
+    /**
+     * @brief Start nested array; add elements with startObject()/endObject()
+     */
+    void startNestedArray(const char* key);
+
+    /**
+     * @brief End the current array
+     */
+    void endArray();
+
     /**
      * @brief Get built JSON string
      */
@@ -0,0 +1,38 @@
+/**
+ * @file ParanodeMessageClass.cpp
+ * @brief Default delivery policy of each message class
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "ParanodeMessageClass.h"
+
+static const ParanodeClassPolicy CONTROL_POLICY = {3, false, false, true, PARANODE_DROP_OLDEST, 0};
+
+ParanodeClassPolicies::ParanodeClassPolicies() {
+    //                                   priority offline batch urgent drop ttl
+    _policies[PARANODE_MSG_TELEMETRY] = {1, true, true, false, PARANODE_DROP_OLDEST, 0};
+    _policies[PARANODE_MSG_STATUS] = {1, true, false, false, PARANODE_DROP_OLDEST, 0};
+    _policies[PARANODE_MSG_ERROR] = {3, true, false, true, PARANODE_DROP_OLDEST, 1800000};
+    _policies[PARANODE_MSG_METRICS] = {0, true, true, false, PARANODE_DROP_OLDEST, 60000};
+    _policies[PARANODE_MSG_RESPONSE] = {2, true, false, false, PARANODE_DROP_OLDEST, 120000};
+    _policies[PARANODE_MSG_REQUEST] = {1, true, false, false, PARANODE_DROP_NEWEST, 60000};
+    _policies[PARANODE_MSG_HEARTBEAT] = {0, false, false, false, PARANODE_DROP_NEWEST, 0};
+}
+
+const ParanodeClassPolicy& ParanodeClassPolicies::get(uint8_t cls) const {
+    return cls < PARANODE_MSG_CLASSES ? _policies[cls] : CONTROL_POLICY;
+}
+
+void ParanodeClassPolicies::set(ParanodeMessageClass cls, const ParanodeClassPolicy& policy) {
+    if (cls < PARANODE_MSG_CLASSES) {
+        _policies[cls] = policy;
+        if (_policies[cls].priority > 3) {
+            _policies[cls].priority = 3;
+        }
+        // The urgent lane is the critical priority
+        if (_policies[cls].urgent) {
+            _policies[cls].priority = 3;
+        }
+    }
+}
@@ -0,0 +1,78 @@
+/**
+ * @file ParanodeMessageClass.h
+ * @brief Outbound message classes and the delivery policy of each
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#ifndef PARANODE_MESSAGE_CLASS_H
+#define PARANODE_MESSAGE_CLASS_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Outbound message classes
+ *
+ * The classes before PARANODE_MSG_CLASS_COUNT have a plan quota. The
+ * protocol classes after it are never rate limited but otherwise take the
+ * same path. Handshake traffic (auth, device_info, credits, OTA chunk
+ * requests) belongs to one connection and is PARANODE_MSG_CONTROL.
+ */
+enum ParanodeMessageClass : uint8_t {
+    PARANODE_MSG_TELEMETRY = 0,
+    PARANODE_MSG_STATUS,
+    PARANODE_MSG_ERROR,
+    PARANODE_MSG_METRICS,
+    PARANODE_MSG_CLASS_COUNT,
+    PARANODE_MSG_RESPONSE = PARANODE_MSG_CLASS_COUNT, // Command, config and sampling answers
+    PARANODE_MSG_REQUEST,                             // Config, WiFi and project info requests
+    PARANODE_MSG_HEARTBEAT,
+    PARANODE_MSG_CLASSES,
+    PARANODE_MSG_CONTROL = 0xFF
+};
+
+/**
+ * @brief Which message goes when the queue is full
+ */
+enum ParanodeDropPolicy : uint8_t {
+    PARANODE_DROP_OLDEST, // Make room: the oldest lower-priority message, else the oldest
+    PARANODE_DROP_NEWEST  // Keep what is queued and discard the new message
+};
+
+/**
+ * @struct ParanodeClassPolicy
+ * @brief How messages of one class travel through the send path
+ */
+struct ParanodeClassPolicy {
+    uint8_t priority;        // Queue priority (0 = low, 3 = critical)
+    bool offline;            // Queue while disconnected instead of failing
+    bool batch;              // Wait for the next batch frame while batching is on
+    bool urgent;             // Urgent lane: never waits for a batch, queued ahead of the backlog
+    ParanodeDropPolicy drop; // When the queue is full
+    uint32_t ttl;            // ms a queued message stays useful, 0 = the messageTtl tuning value
+};
+
+/**
+ * @class ParanodeClassPolicies
+ * @brief Policy table indexed by ParanodeMessageClass
+ *
+ * Defaults: telemetry and metrics batch; status, responses and requests go
+ * out at once; errors take the urgent lane; everything but heartbeats is
+ * kept offline. Metrics, responses and requests expire sooner than data.
+ */
+class ParanodeClassPolicies {
+public:
+    ParanodeClassPolicies();
+
+    /**
+     * @brief Policy for a class (PARANODE_MSG_CONTROL: send now, never queue)
+     */
+    const ParanodeClassPolicy& get(uint8_t cls) const;
+
+    void set(ParanodeMessageClass cls, const ParanodeClassPolicy& policy);
+
+private:
+    ParanodeClassPolicy _policies[PARANODE_MSG_CLASSES];
+};
+
+#endif
@@ -8,141 +8,218 @@
 #include "ParanodeMessageQueue.h"
 #include <string.h>
 
-ParanodeMessageQueue::ParanodeMessageQueue()
-    : _head(0), _tail(0), _count(0) {
-    // Initialize all messages as invalid
+ParanodeMessageQueue::ParanodeMessageQueue() : _count(0), _bytes(0), _dropped(0), _expired(0) {
+    for (size_t i = 0; i < 4; i++) {
+        _droppedByPriority[i] = 0;
+    }
+
     for (size_t i = 0; i < PARANODE_QUEUE_SIZE; i++) {
-        _messages[i].valid = false;
+        _order[i] = (uint8_t)i;
     }
 }
 
-bool ParanodeMessageQueue::enqueue(const char* message, uint16_t length, uint8_t priority) {
+bool ParanodeMessageQueue::enqueue(const char* message, uint16_t length, uint8_t priority, uint32_t tag, uint8_t kind,
+                                   bool evict, unsigned long now) {
     if (!message || length == 0 || length >= PARANODE_MAX_MESSAGE_SIZE) {
         return false;
     }
 
+    // The caller's class keeps what is already queued
+    if (isFull() && !evict) {
+        _dropped++;
+        _droppedByPriority[priority < 4 ? priority : 3]++;
+        return false;
+    }
+
     // If queue is full, make room based on priority
     if (isFull()) {
         // If new message is high priority (>=2), remove oldest low priority message
+        size_t victim = 0;
         if (priority >= 2) {
-            // Find and remove oldest low priority message
-            size_t checkIdx = _tail;
             for (size_t i = 0; i < _count; i++) {
-                if (_messages[checkIdx].priority < 2) {
-                    // Remove this message by marking invalid
-                    _messages[checkIdx].valid = false;
-                    // Shift tail if needed
-                    if (checkIdx == _tail) {
-                        _tail = nextIndex(_tail);
-                        _count--;
-                    }
+                if (at(i).priority < 2) {
+                    victim = i;
                     break;
                 }
-                checkIdx = nextIndex(checkIdx);
             }
         }
+        // Otherwise drop the oldest message
+        drop(victim);
+    }
 
-        // Still full? Drop oldest message
-        if (isFull()) {
-            _tail = nextIndex(_tail);
-            _count--;
-        }
+    // Add new message in the first free slot
+    QueuedMessage& msg = at(_count);
+    memcpy(msg.data, message, length);
+    msg.data[length] = '\0';
+    msg.length = length;
+    msg.timestamp = now;
+    msg.tag = tag;
+    msg.priority = priority;
+    msg.kind = kind;
+    _bytes += length;
+    _count++;
+
+    return true;
+}
+
+bool ParanodeMessageQueue::coalesce(const char* message, uint16_t length, uint8_t priority, uint32_t tag,
+                                    uint8_t kind, unsigned long now, bool* replaced) {
+    if (replaced) {
+        *replaced = false;
+    }
+    if (!message || length == 0 || length >= PARANODE_MAX_MESSAGE_SIZE) {
+        return false;
     }
 
-    // Add new message
-    memcpy(_messages[_head].data, message, length);
-    _messages[_head].data[length] = '\0';
-    _messages[_head].length = length;
-    _messages[_head].timestamp = millis();
-    _messages[_head].priority = priority;
-    _messages[_head].valid = true;
+    // Newest message of this kind
+    QueuedMessage* match = nullptr;
+    for (size_t i = _count; i > 0; i--) {
+        if (at(i - 1).kind == kind) {
+            match = &at(i - 1);
+            break;
+        }
+    }
 
-    _head = nextIndex(_head);
-    _count++;
+    if (!match) {
+        return enqueue(message, length, priority, tag, kind, true, now);
+    }
 
+    _bytes = _bytes - match->length + length;
+    memcpy(match->data, message, length);
+    match->data[length] = '\0';
+    match->length = length;
+    match->tag = tag;
+    match->priority = priority;
+    if (replaced) {
+        *replaced = true;
+    }
     return true;
 }
 
-uint16_t ParanodeMessageQueue::dequeue(char* buffer, size_t bufferSize) {
+uint16_t ParanodeMessageQueue::dequeue(char* buffer, size_t bufferSize, uint32_t* tag, uint8_t* kind,
+                                       uint8_t minPriority) {
     if (isEmpty() || !buffer) {
         return 0;
     }
 
-    // Find next valid message
-    while (!_messages[_tail].valid && !isEmpty()) {
-        _tail = nextIndex(_tail);
-        _count--;
+    int position = find(minPriority);
+    if (position < 0) {
+        return 0;
     }
+    return take((size_t)position, buffer, bufferSize, tag, kind);
+}
 
-    if (isEmpty()) {
+uint16_t ParanodeMessageQueue::peek(char* buffer, size_t bufferSize, uint32_t* tag, uint8_t* kind,
+                                    uint8_t minPriority) {
+    if (isEmpty() || !buffer) {
         return 0;
     }
 
-    QueuedMessage& msg = _messages[_tail];
-    uint16_t copyLen = msg.length < bufferSize ? msg.length : bufferSize - 1;
-
-    memcpy(buffer, msg.data, copyLen);
-    buffer[copyLen] = '\0';
+    int position = find(minPriority);
+    if (position < 0) {
+        return 0;
+    }
+    return copy((size_t)position, buffer, bufferSize, tag, kind);
+}
 
-    msg.valid = false;
-    _tail = nextIndex(_tail);
-    _count--;
+bool ParanodeMessageQueue::discardNext(uint8_t minPriority) {
+    int position = find(minPriority);
+    if (position < 0) {
+        return false;
+    }
+    release((size_t)position);
+    return true;
+}
 
-    return copyLen;
+int ParanodeMessageQueue::peekKind(uint8_t minPriority) const {
+    int position = find(minPriority);
+    return position < 0 ? -1 : at(position).kind;
 }
 
-uint16_t ParanodeMessageQueue::peek(char* buffer, size_t bufferSize) {
+uint16_t ParanodeMessageQueue::dequeueSince(unsigned long since, char* buffer, size_t bufferSize, uint32_t* tag,
+                                            uint8_t* kind, ParanodeKindFilter accept, void* context) {
     if (isEmpty() || !buffer) {
         return 0;
     }
 
-    // Find next valid message
-    size_t peekIdx = _tail;
-    while (!_messages[peekIdx].valid && peekIdx != _head) {
-        peekIdx = nextIndex(peekIdx);
+    int position = findSince(since, accept, context);
+    if (position < 0) {
+        return 0;
     }
+    return take((size_t)position, buffer, bufferSize, tag, kind);
+}
 
-    if (!_messages[peekIdx].valid) {
+uint16_t ParanodeMessageQueue::peekSince(unsigned long since, char* buffer, size_t bufferSize, uint32_t* tag,
+                                         uint8_t* kind, ParanodeKindFilter accept, void* context) {
+    if (isEmpty() || !buffer) {
         return 0;
     }
 
-    QueuedMessage& msg = _messages[peekIdx];
-    uint16_t copyLen = msg.length < bufferSize ? msg.length : bufferSize - 1;
+    int position = findSince(since, accept, context);
+    if (position < 0) {
+        return 0;
+    }
+    return copy((size_t)position, buffer, bufferSize, tag, kind);
+}
 
-    memcpy(buffer, msg.data, copyLen);
-    buffer[copyLen] = '\0';
+bool ParanodeMessageQueue::discardNextSince(unsigned long since, ParanodeKindFilter accept, void* context) {
+    int position = findSince(since, accept, context);
+    if (position < 0) {
+        return false;
+    }
+    release((size_t)position);
+    return true;
+}
 
-    return copyLen;
+int ParanodeMessageQueue::peekKindSince(unsigned long since, ParanodeKindFilter accept, void* context) const {
+    int position = findSince(since, accept, context);
+    return position < 0 ? -1 : at(position).kind;
+}
+
+size_t ParanodeMessageQueue::countBefore(unsigned long since) const {
+    size_t before = 0;
+    for (size_t i = 0; i < _count; i++) {
+        if (inRange(at(i), RANGE_BEFORE, since)) {
+            before++;
+        }
+    }
+    return before;
 }
 
 void ParanodeMessageQueue::clear() {
-    _head = 0;
-    _tail = 0;
     _count = 0;
-
-    for (size_t i = 0; i < PARANODE_QUEUE_SIZE; i++) {
-        _messages[i].valid = false;
-    }
+    _bytes = 0;
 }
 
 unsigned long ParanodeMessageQueue::getOldestTimestamp() {
-    if (isEmpty()) {
-        return 0;
-    }
+    return isEmpty() ? 0 : at(0).timestamp;
+}
 
-    // Find oldest valid message
-    size_t checkIdx = _tail;
-    for (size_t i = 0; i < _count; i++) {
-        if (_messages[checkIdx].valid) {
-            return _messages[checkIdx].timestamp;
-        }
-        checkIdx = nextIndex(checkIdx);
-    }
+int ParanodeMessageQueue::batchMessages(char* buffer, size_t bufferSize, int maxMessages, uint32_t* tags,
+                                        ParanodeKindFilter admit, void* context) {
+    return batch(RANGE_ALL, 0, buffer, bufferSize, maxMessages, tags, admit, context);
+}
+
+int ParanodeMessageQueue::batchBefore(unsigned long since, char* buffer, size_t bufferSize, int maxMessages,
+                                      uint32_t* tags, ParanodeKindFilter admit, void* context) {
+    return batch(RANGE_BEFORE, since, buffer, bufferSize, maxMessages, tags, admit, context);
+}
 
-    return 0;
+int ParanodeMessageQueue::batchSince(unsigned long since, char* buffer, size_t bufferSize, int maxMessages,
+                                     uint32_t* tags, ParanodeKindFilter admit, void* context) {
+    return batch(RANGE_SINCE, since, buffer, bufferSize, maxMessages, tags, admit, context);
 }
 
-int ParanodeMessageQueue::batchMessages(char* buffer, size_t bufferSize, int maxMessages) {
+size_t ParanodeMessageQueue::discardBefore(unsigned long since, size_t count) {
+    return discard(RANGE_BEFORE, since, count);
+}
+
+size_t ParanodeMessageQueue::discardSince(unsigned long since, size_t count) {
+    return discard(RANGE_SINCE, since, count);
+}
+
+int ParanodeMessageQueue::batch(Range range, unsigned long since, char* buffer, size_t bufferSize, int maxMessages,
+                                uint32_t* tags, ParanodeKindFilter admit, void* context) {
     if (isEmpty() || !buffer || bufferSize < 50) {
         return 0;
     }
@@ -153,32 +230,34 @@ int ParanodeMessageQueue::batchMessages(char* buffer, size_t bufferSize, int max
     // Start batch array
     buffer[pos++] = '[';
 
-    size_t checkIdx = _tail;
-    for (int i = 0; i < maxMessages && i < (int)_count && pos < bufferSize - 2; i++) {
-        if (!_messages[checkIdx].valid) {
-            checkIdx = nextIndex(checkIdx);
+    for (size_t i = 0; i < _count && batched < maxMessages && pos < bufferSize - 2; i++) {
+        const QueuedMessage& msg = at(i);
+        if (!inRange(msg, range, since)) {
             continue;
         }
 
-        QueuedMessage& msg = _messages[checkIdx];
-
-        // Add comma separator if not first message
-        if (batched > 0) {
-            if (pos >= bufferSize - 2) break;
-            buffer[pos++] = ',';
+        // Check if we have space for this message (and its separator)
+        size_t separator = batched > 0 ? 1 : 0;
+        if (pos + separator + msg.length + 2 >= bufferSize) {
+            break;
         }
 
-        // Check if we have space for this message
-        if (pos + msg.length + 2 >= bufferSize) {
+        if (admit && !admit(context, msg.kind)) {
             break;
         }
 
+        // Add comma separator if not first message
+        if (separator) {
+            buffer[pos++] = ',';
+        }
+
         // Copy message
         memcpy(buffer + pos, msg.data, msg.length);
         pos += msg.length;
+        if (tags) {
+            tags[batched] = msg.tag;
+        }
         batched++;
-
-        checkIdx = nextIndex(checkIdx);
     }
 
     // End batch array
@@ -188,44 +267,122 @@ int ParanodeMessageQueue::batchMessages(char* buffer, size_t bufferSize, int max
     return batched;
 }
 
+size_t ParanodeMessageQueue::discard(Range range, unsigned long since, size_t count) {
+    size_t removed = 0;
+    size_t i = 0;
+    while (i < _count && removed < count) {
+        if (inRange(at(i), range, since)) {
+            release(i);
+            removed++;
+        } else {
+            i++;
+        }
+    }
+    return removed;
+}
+
 int ParanodeMessageQueue::removeExpired(unsigned long timeout) {
-    if (isEmpty()) {
+    return removeExpired([timeout](uint8_t) { return timeout; }, millis());
+}
+
+int ParanodeMessageQueue::removeExpired(std::function<unsigned long(uint8_t kind)> timeoutOf, unsigned long now) {
+    if (isEmpty() || !timeoutOf) {
         return 0;
     }
 
-    unsigned long currentTime = millis();
     int removed = 0;
 
-    size_t checkIdx = _tail;
+    // Compact the order in one pass; expired slots go behind the kept ones
+    uint8_t expiredSlots[PARANODE_QUEUE_SIZE];
+    size_t kept = 0;
     for (size_t i = 0; i < _count; i++) {
-        if (_messages[checkIdx].valid) {
-            // Handle millis() overflow
-            unsigned long age;
-            if (currentTime >= _messages[checkIdx].timestamp) {
-                age = currentTime - _messages[checkIdx].timestamp;
-            } else {
-                age = (ULONG_MAX - _messages[checkIdx].timestamp) + currentTime;
-            }
+        uint8_t slot = _order[i];
+        // Unsigned subtraction handles millis() overflow
+        unsigned long age = now - _messages[slot].timestamp;
+
+        if (age > timeoutOf(_messages[slot].kind)) {
+            _bytes -= _messages[slot].length;
+            expiredSlots[removed++] = slot;
+        } else {
+            _order[kept++] = slot;
+        }
+    }
+    memcpy(_order + kept, expiredSlots, removed);
+    _count = kept;
+    _expired += removed;
 
-            if (age > timeout) {
-                _messages[checkIdx].valid = false;
-                removed++;
-            }
+    return removed;
+}
+
+int ParanodeMessageQueue::find(uint8_t minPriority) const {
+    for (size_t i = 0; i < _count; i++) {
+        if (at(i).priority >= minPriority) {
+            return (int)i;
         }
-        checkIdx = nextIndex(checkIdx);
     }
+    return -1;
+}
 
-    // Update count
-    _count -= removed;
+int ParanodeMessageQueue::findSince(unsigned long since, ParanodeKindFilter accept, void* context) const {
+    for (size_t i = 0; i < _count; i++) {
+        if (inRange(at(i), RANGE_SINCE, since) && (!accept || accept(context, at(i).kind))) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
 
-    // Update tail to skip invalid messages
-    while (!isEmpty() && !_messages[_tail].valid) {
-        _tail = nextIndex(_tail);
+bool ParanodeMessageQueue::inRange(const QueuedMessage& msg, Range range, unsigned long since) {
+    if (range == RANGE_ALL) {
+        return true;
     }
+    // Signed difference handles millis() overflow
+    bool before = (long)(msg.timestamp - since) < 0;
+    return range == RANGE_BEFORE ? before : !before;
+}
 
-    return removed;
+uint16_t ParanodeMessageQueue::copy(size_t position, char* buffer, size_t bufferSize, uint32_t* tag,
+                                    uint8_t* kind) const {
+    const QueuedMessage& msg = at(position);
+    uint16_t copyLen = msg.length < bufferSize ? msg.length : bufferSize - 1;
+
+    memcpy(buffer, msg.data, copyLen);
+    buffer[copyLen] = '\0';
+
+    if (tag) {
+        *tag = msg.tag;
+    }
+    if (kind) {
+        *kind = msg.kind;
+    }
+
+    return copyLen;
+}
+
+uint16_t ParanodeMessageQueue::take(size_t position, char* buffer, size_t bufferSize, uint32_t* tag,
+                                    uint8_t* kind) {
+    uint16_t copyLen = copy(position, buffer, bufferSize, tag, kind);
+    release(position);
+    return copyLen;
+}
+
+void ParanodeMessageQueue::release(size_t position) {
+    _bytes -= at(position).length;
+    remove(position);
+}
+
+void ParanodeMessageQueue::remove(size_t position) {
+    // Close the gap in the order and recycle the slot; the payload stays put
+    uint8_t slot = _order[position];
+    memmove(_order + position, _order + position + 1, _count - position - 1);
+    _count--;
+    _order[_count] = slot;
 }
 
-size_t ParanodeMessageQueue::nextIndex(size_t index) const {
-    return (index + 1) % PARANODE_QUEUE_SIZE;
+void ParanodeMessageQueue::drop(size_t position) {
+    const QueuedMessage& msg = at(position);
+    _bytes -= msg.length;
+    _dropped++;
+    _droppedByPriority[msg.priority < 4 ? msg.priority : 3]++;
+    remove(position);
 }
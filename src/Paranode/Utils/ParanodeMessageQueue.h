@@ -1,11 +1,12 @@
 /**
  * @file ParanodeMessageQueue.h
- * @brief Lightweight circular message queue for offline buffering and batching
+ * @brief Lightweight message queue for offline buffering and batching
  * @author Muhammad Daffa
  * @date 2025-10-25
  *
  * Features:
- * - Circular buffer for efficient memory usage
+ * - Fixed slots kept in FIFO order by a byte index, so taking a message out
+ *   of order moves index bytes, not payloads
  * - Message batching to reduce overhead
  * - Offline message buffering
  * - Configurable queue size
@@ -16,6 +17,8 @@
 #define PARANODE_MESSAGE_QUEUE_H
 
 #include <Arduino.h>
+#include <functional>
+#include "Paranode/ParanodeConfig.h"
 
 // Default configuration
 #ifndef PARANODE_QUEUE_SIZE
@@ -26,6 +29,13 @@
 #define PARANODE_MAX_MESSAGE_SIZE 384
 #endif
 
+static_assert(PARANODE_QUEUE_SIZE <= 256, "PARANODE_QUEUE_SIZE must fit the uint8_t slot index");
+
+/**
+ * @brief Per-message check by kind; context is passed through unchanged
+ */
+typedef bool (*ParanodeKindFilter)(void* context, uint8_t kind);
+
 /**
  * @struct QueuedMessage
  * @brief Structure to hold queued message data
@@ -34,13 +44,14 @@ struct QueuedMessage {
     char data[PARANODE_MAX_MESSAGE_SIZE];
     uint16_t length;
     unsigned long timestamp;
+    uint32_t tag;     // Caller-defined (telemetry sequence number, 0 = none)
     uint8_t priority; // 0=low, 1=normal, 2=high, 3=critical
-    bool valid;
+    uint8_t kind;     // Caller-defined message class
 };
 
 /**
  * @class ParanodeMessageQueue
- * @brief Circular message queue with batching support
+ * @brief Fixed-slot message queue with batching support
  */
 class ParanodeMessageQueue {
 public:
@@ -54,31 +65,120 @@ public:
      * @param message Message data
      * @param length Message length
      * @param priority Message priority (0-3)
+     * @param tag Optional caller-defined tag returned by dequeue()
+     * @param kind Optional caller-defined message class
+     * @param evict If the queue is full, discard an older message (true) or
+     *        this one (false); either way the discarded message is counted
+     * @param now Time the message is queued at, from the caller's clock
      * @return True if enqueued successfully
      */
-    bool enqueue(const char* message, uint16_t length, uint8_t priority = 1);
+    bool enqueue(const char* message, uint16_t length, uint8_t priority, uint32_t tag, uint8_t kind, bool evict,
+                 unsigned long now);
+
+    /**
+     * @brief Enqueue a message stamped with millis()
+     */
+    bool enqueue(const char* message, uint16_t length, uint8_t priority = 1, uint32_t tag = 0, uint8_t kind = 0,
+                 bool evict = true) {
+        return enqueue(message, length, priority, tag, kind, evict, millis());
+    }
+
+    /**
+     * @brief Replace the newest queued message of the same kind, or enqueue
+     * @param now Time a new message is queued at
+     * @param replaced Optional output, true if an older message was overwritten
+     * @return True if the message is now queued
+     * @note The replacement keeps the old message's place in the queue and
+     *       its timestamp, so queue order stays time order
+     */
+    bool coalesce(const char* message, uint16_t length, uint8_t priority, uint32_t tag, uint8_t kind,
+                  unsigned long now, bool* replaced = nullptr);
 
     /**
      * @brief Dequeue a message
      * @param buffer Output buffer
      * @param bufferSize Buffer size
+     * @param tag Optional output for the message tag
+     * @param kind Optional output for the message class
+     * @param minPriority Take the oldest message of at least this priority,
+     *        ahead of older lower-priority ones (0 = strictly oldest first)
      * @return Length of dequeued message, 0 if queue empty
      */
-    uint16_t dequeue(char* buffer, size_t bufferSize);
+    uint16_t dequeue(char* buffer, size_t bufferSize, uint32_t* tag = nullptr, uint8_t* kind = nullptr,
+                     uint8_t minPriority = 0);
 
     /**
      * @brief Peek at next message without removing
      * @param buffer Output buffer
      * @param bufferSize Buffer size
+     * @param tag Optional output for the message tag
+     * @param kind Optional output for the message class
+     * @param minPriority Message to look at, as dequeue()
      * @return Length of peeked message, 0 if queue empty
      */
-    uint16_t peek(char* buffer, size_t bufferSize);
+    uint16_t peek(char* buffer, size_t bufferSize, uint32_t* tag = nullptr, uint8_t* kind = nullptr,
+                  uint8_t minPriority = 0);
+
+    /**
+     * @brief Remove the message peek() with the same minPriority returned
+     * @return True if a message was removed
+     * @note Peek, write, then remove: a failed write leaves the message in
+     *       its place with its priority and timestamp
+     */
+    bool discardNext(uint8_t minPriority = 0);
+
+    /**
+     * @brief Class of the next message
+     * @param minPriority Look only at messages of at least this priority
+     * @return Its kind, or -1 if there is none
+     */
+    int peekKind(uint8_t minPriority = 0) const;
+
+    /**
+     * @brief Dequeue the oldest message queued at or after a time
+     * @param since millis() value; older messages are overtaken
+     * @param accept Optional kind filter; refused messages are overtaken too
+     * @param context Passed to accept
+     * @return Length of dequeued message, 0 if there is none
+     */
+    uint16_t dequeueSince(unsigned long since, char* buffer, size_t bufferSize, uint32_t* tag = nullptr,
+                          uint8_t* kind = nullptr, ParanodeKindFilter accept = nullptr, void* context = nullptr);
+
+    /**
+     * @brief Peek at the message dequeueSince() would take
+     * @return Length of peeked message, 0 if there is none
+     */
+    uint16_t peekSince(unsigned long since, char* buffer, size_t bufferSize, uint32_t* tag = nullptr,
+                       uint8_t* kind = nullptr, ParanodeKindFilter accept = nullptr, void* context = nullptr);
+
+    /**
+     * @brief Remove the message peekSince() with the same arguments returned
+     * @return True if a message was removed
+     */
+    bool discardNextSince(unsigned long since, ParanodeKindFilter accept = nullptr, void* context = nullptr);
+
+    /**
+     * @brief Class of the oldest message queued at or after a time
+     * @param accept Optional kind filter, as dequeueSince()
+     * @return Its kind, or -1 if there is none
+     */
+    int peekKindSince(unsigned long since, ParanodeKindFilter accept = nullptr, void* context = nullptr) const;
+
+    /**
+     * @brief Number of messages queued before a time
+     */
+    size_t countBefore(unsigned long since) const;
 
     /**
      * @brief Get number of messages in queue
      */
     size_t count() const { return _count; }
 
+    /**
+     * @brief Get bytes of message data in queue
+     */
+    size_t bytes() const { return _bytes; }
+
     /**
      * @brief Check if queue is empty
      */
@@ -105,24 +205,99 @@ public:
      * @param buffer Output buffer
      * @param bufferSize Buffer size
      * @param maxMessages Maximum messages to batch
+     * @param tags Optional output array (maxMessages entries) for message tags
+     * @param admit Optional check per message kind; the batch ends at the
+     *        first message it refuses, so it stays a prefix of the queue
+     * @param context Passed to admit
      * @return Number of messages batched
      */
-    int batchMessages(char* buffer, size_t bufferSize, int maxMessages = 5);
+    int batchMessages(char* buffer, size_t bufferSize, int maxMessages = 5, uint32_t* tags = nullptr,
+                      ParanodeKindFilter admit = nullptr, void* context = nullptr);
+
+    /**
+     * @brief Batch the oldest messages queued before a time
+     * @param since Messages at or after it are skipped, not batched
+     * @note Parameters otherwise as batchMessages()
+     */
+    int batchBefore(unsigned long since, char* buffer, size_t bufferSize, int maxMessages, uint32_t* tags = nullptr,
+                    ParanodeKindFilter admit = nullptr, void* context = nullptr);
+
+    /**
+     * @brief Batch the oldest messages queued at or after a time
+     * @param since Messages before it are skipped, not batched
+     */
+    int batchSince(unsigned long since, char* buffer, size_t bufferSize, int maxMessages, uint32_t* tags = nullptr,
+                   ParanodeKindFilter admit = nullptr, void* context = nullptr);
+
+    /**
+     * @brief Remove what batchBefore()/batchSince() with the same time batched
+     * @param count Messages batched
+     * @return Number of messages removed
+     */
+    size_t discardBefore(unsigned long since, size_t count);
+    size_t discardSince(unsigned long since, size_t count);
 
     /**
-     * @brief Remove expired messages older than timeout
+     * @brief Remove expired messages older than timeout, by millis()
      * @param timeout Age in milliseconds
      * @return Number of messages removed
      */
     int removeExpired(unsigned long timeout);
 
+    /**
+     * @brief Remove expired messages, with a timeout per message kind
+     * @param timeoutOf Age in milliseconds after which a kind expires
+     * @param now Current time on the clock the messages were queued by
+     * @return Number of messages removed
+     */
+    int removeExpired(std::function<unsigned long(uint8_t kind)> timeoutOf, unsigned long now);
+
+    /**
+     * @brief Number of messages discarded because the queue was full
+     */
+    uint32_t droppedCount() const { return _dropped; }
+
+    /**
+     * @brief Number of messages of one priority discarded because the queue was full
+     * @param priority Priority of the discarded messages (0-3)
+     */
+    uint32_t droppedCount(uint8_t priority) const { return priority < 4 ? _droppedByPriority[priority] : 0; }
+
+    /**
+     * @brief Number of messages discarded by removeExpired()
+     */
+    uint32_t expiredCount() const { return _expired; }
+
 private:
     QueuedMessage _messages[PARANODE_QUEUE_SIZE];
-    size_t _head;
-    size_t _tail;
+    // Slot numbers, oldest message first; entries past _count are free slots
+    uint8_t _order[PARANODE_QUEUE_SIZE];
     size_t _count;
+    size_t _bytes;
+    uint32_t _dropped;
+    uint32_t _droppedByPriority[4];
+    uint32_t _expired;
+
+    // Messages a batch may take
+    enum Range : uint8_t {
+        RANGE_ALL,
+        RANGE_BEFORE,
+        RANGE_SINCE
+    };
 
-    size_t nextIndex(size_t index) const;
+    QueuedMessage& at(size_t position) { return _messages[_order[position]]; }
+    const QueuedMessage& at(size_t position) const { return _messages[_order[position]]; }
+    int find(uint8_t minPriority) const;
+    int findSince(unsigned long since, ParanodeKindFilter accept, void* context) const;
+    static bool inRange(const QueuedMessage& msg, Range range, unsigned long since);
+    int batch(Range range, unsigned long since, char* buffer, size_t bufferSize, int maxMessages, uint32_t* tags,
+              ParanodeKindFilter admit, void* context);
+    size_t discard(Range range, unsigned long since, size_t count);
+    uint16_t copy(size_t position, char* buffer, size_t bufferSize, uint32_t* tag, uint8_t* kind) const;
+    uint16_t take(size_t position, char* buffer, size_t bufferSize, uint32_t* tag, uint8_t* kind);
+    void release(size_t position);
+    void remove(size_t position);
+    void drop(size_t position);
 };
 
 #endif
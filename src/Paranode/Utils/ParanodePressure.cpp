@@ -0,0 +1,84 @@
+/**
+ * @file ParanodePressure.cpp
+ * @brief Implementation of the backpressure gauge
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "ParanodePressure.h"
+
+ParanodePressureGauge::ParanodePressureGauge()
+    : _level(PARANODE_PRESSURE_NORMAL), _windowStart(0), _windowCount(0), _lastDropped(0), _growth(0),
+      _started(false) {
+}
+
+bool ParanodePressureGauge::update(size_t count, size_t bytes, uint32_t dropped, bool linkUp, unsigned long now) {
+    if (!_started) {
+        _started = true;
+        _windowStart = now;
+        _windowCount = count;
+        _lastDropped = dropped;
+    }
+
+    // A drop is reported at once rather than at the end of the window
+    bool dropping = dropped != _lastDropped;
+    _lastDropped = dropped;
+
+    bool windowEnded = now - _windowStart >= PARANODE_PRESSURE_WINDOW;
+    if (windowEnded) {
+        int32_t delta = (int32_t)count - (int32_t)_windowCount;
+        _growth = delta * (int32_t)(60000 / PARANODE_PRESSURE_WINDOW);
+        _windowStart = now;
+        _windowCount = count;
+    }
+
+    ParanodePressureLevel next = target(count, bytes, dropping, linkUp);
+    if (next < _level) {
+        if (!windowEnded) {
+            return false;
+        }
+        next = (ParanodePressureLevel)(_level - 1);
+    }
+
+    if (next == _level) {
+        return false;
+    }
+    _level = next;
+    return true;
+}
+
+ParanodePressureLevel ParanodePressureGauge::target(size_t count, size_t bytes, bool dropping, bool linkUp) const {
+    if (dropping) {
+        return PARANODE_PRESSURE_CRITICAL;
+    }
+
+    // Slots usually run out first; bytes matter when messages are near full size
+    size_t slotFill = count * 100 / PARANODE_QUEUE_SIZE;
+    size_t byteFill = bytes * 100 / ((size_t)PARANODE_QUEUE_SIZE * (PARANODE_MAX_MESSAGE_SIZE - 1));
+    size_t fill = slotFill > byteFill ? slotFill : byteFill;
+
+    int level = PARANODE_PRESSURE_NORMAL;
+    if (fill >= 90) {
+        level = PARANODE_PRESSURE_CRITICAL;
+    } else if (fill >= 70) {
+        level = PARANODE_PRESSURE_HIGH;
+    } else if (fill >= 40) {
+        level = PARANODE_PRESSURE_ELEVATED;
+    }
+
+    // Nothing drains while the link is down
+    if (!linkUp && count > 0 && level < PARANODE_PRESSURE_ELEVATED) {
+        level = PARANODE_PRESSURE_ELEVATED;
+    }
+
+    // Growing fast enough to fill up within the horizon
+    if (_growth > 0 && level < PARANODE_PRESSURE_CRITICAL) {
+        uint32_t freeSlots = count < PARANODE_QUEUE_SIZE ? PARANODE_QUEUE_SIZE - count : 0;
+        uint32_t msToFull = (uint32_t)((uint64_t)freeSlots * 60000 / (uint32_t)_growth);
+        if (msToFull < PARANODE_PRESSURE_HORIZON) {
+            level++;
+        }
+    }
+
+    return (ParanodePressureLevel)level;
+}
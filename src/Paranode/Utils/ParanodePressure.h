@@ -0,0 +1,72 @@
+/**
+ * @file ParanodePressure.h
+ * @brief Outbound backpressure level from queue fill, drain rate and link state
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#ifndef PARANODE_PRESSURE_H
+#define PARANODE_PRESSURE_H
+
+#include <Arduino.h>
+#include "ParanodeMessageQueue.h"
+
+// Queue growth is measured over windows of this length
+#ifndef PARANODE_PRESSURE_WINDOW
+#define PARANODE_PRESSURE_WINDOW 1000
+#endif
+
+// At the current growth rate the queue is full within this time: one level up
+#ifndef PARANODE_PRESSURE_HORIZON
+#define PARANODE_PRESSURE_HORIZON 30000
+#endif
+
+enum ParanodePressureLevel : uint8_t {
+    PARANODE_PRESSURE_NORMAL,   // Keeping up
+    PARANODE_PRESSURE_ELEVATED, // Backlog building or link down; consider sampling less
+    PARANODE_PRESSURE_HIGH,     // Queue mostly full; aggregate or skip readings
+    PARANODE_PRESSURE_CRITICAL  // Queue full, data is being dropped
+};
+
+/**
+ * @class ParanodePressureGauge
+ * @brief Turns queue samples into a pressure level
+ *
+ * The level rises as soon as a sample calls for it and falls one step per
+ * window, so a queue hovering at a threshold does not flap.
+ */
+class ParanodePressureGauge {
+public:
+    ParanodePressureGauge();
+
+    /**
+     * @brief Feed the current queue state (call from loop)
+     * @param count Messages queued
+     * @param bytes Bytes queued
+     * @param dropped Total messages dropped so far
+     * @param linkUp True when the connection is authenticated
+     * @param now Current time in ms
+     * @return True if the level changed
+     */
+    bool update(size_t count, size_t bytes, uint32_t dropped, bool linkUp, unsigned long now);
+
+    ParanodePressureLevel level() const { return _level; }
+
+    /**
+     * @brief Queue growth over the last window, in messages per minute
+     * @return Positive while the backlog grows, negative while it drains
+     */
+    int32_t growthPerMinute() const { return _growth; }
+
+private:
+    ParanodePressureLevel _level;
+    unsigned long _windowStart;
+    size_t _windowCount;
+    uint32_t _lastDropped;
+    int32_t _growth;
+    bool _started;
+
+    ParanodePressureLevel target(size_t count, size_t bytes, bool dropping, bool linkUp) const;
+};
+
+#endif
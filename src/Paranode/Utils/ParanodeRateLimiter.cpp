@@ -0,0 +1,115 @@
+/**
+ * @file ParanodeRateLimiter.cpp
+ * @brief Implementation of the per-class token buckets
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "ParanodeRateLimiter.h"
+
+ParanodeRateLimiter::ParanodeRateLimiter() {
+    for (uint8_t i = 0; i < PARANODE_MSG_CLASS_COUNT; i++) {
+        _buckets[i].perMinute = 0;
+        _buckets[i].burst = 0;
+        _buckets[i].milliTokens = 0;
+        _buckets[i].lastRefill = 0;
+        _buckets[i].throttled = 0;
+        _buckets[i].policy = PARANODE_RATE_QUEUE;
+    }
+
+    // Only the latest status and metrics matter
+    _buckets[PARANODE_MSG_STATUS].policy = PARANODE_RATE_COALESCE;
+    _buckets[PARANODE_MSG_METRICS].policy = PARANODE_RATE_COALESCE;
+}
+
+void ParanodeRateLimiter::setLimit(ParanodeMessageClass cls, uint32_t perMinute, uint32_t burst) {
+    if (cls >= PARANODE_MSG_CLASS_COUNT) {
+        return;
+    }
+
+    if (burst == 0) {
+        burst = perMinute / 6;
+    }
+    if (burst == 0) {
+        burst = 1;
+    }
+
+    Bucket& bucket = _buckets[cls];
+    if (bucket.perMinute == perMinute && bucket.burst == burst) {
+        // Re-announced on every reconnect; keep the bucket's level
+        return;
+    }
+    // A full bucket has nothing to refill, so its clock starts on the first
+    // tryConsume() and the limiter never reads the time itself
+    bucket.perMinute = perMinute;
+    bucket.burst = burst;
+    bucket.milliTokens = burst * 1000;
+    bucket.lastRefill = 0;
+}
+
+ParanodeRateLimit ParanodeRateLimiter::getLimit(ParanodeMessageClass cls) const {
+    ParanodeRateLimit limit = {0, 0};
+    if (cls < PARANODE_MSG_CLASS_COUNT && _buckets[cls].perMinute > 0) {
+        limit.perMinute = _buckets[cls].perMinute;
+        limit.burst = _buckets[cls].burst;
+    }
+    return limit;
+}
+
+void ParanodeRateLimiter::setPolicy(ParanodeMessageClass cls, ParanodeRatePolicy policy) {
+    if (cls < PARANODE_MSG_CLASS_COUNT) {
+        _buckets[cls].policy = policy;
+    }
+}
+
+ParanodeRatePolicy ParanodeRateLimiter::getPolicy(ParanodeMessageClass cls) const {
+    return cls < PARANODE_MSG_CLASS_COUNT ? _buckets[cls].policy : PARANODE_RATE_QUEUE;
+}
+
+bool ParanodeRateLimiter::tryConsume(uint8_t cls, unsigned long now) {
+    if (cls >= PARANODE_MSG_CLASS_COUNT || _buckets[cls].perMinute == 0) {
+        return true;
+    }
+
+    Bucket& bucket = _buckets[cls];
+    uint32_t capacity = bucket.burst * 1000;
+    if (bucket.milliTokens < capacity) {
+        // perMinute tokens per 60000 ms = perMinute / 60 milli-tokens per ms.
+        // The clock only advances when something was added, so slow rates
+        // polled every millisecond still accumulate.
+        uint64_t added = (uint64_t)(now - bucket.lastRefill) * bucket.perMinute / 60;
+        if (added > 0) {
+            uint64_t total = bucket.milliTokens + added;
+            bucket.milliTokens = total > capacity ? capacity : (uint32_t)total;
+            bucket.lastRefill = now;
+        }
+    } else {
+        bucket.lastRefill = now;
+    }
+
+    if (bucket.milliTokens < 1000) {
+        return false;
+    }
+    bucket.milliTokens -= 1000;
+    return true;
+}
+
+void ParanodeRateLimiter::refund(uint8_t cls) {
+    if (cls >= PARANODE_MSG_CLASS_COUNT || _buckets[cls].perMinute == 0) {
+        return;
+    }
+
+    Bucket& bucket = _buckets[cls];
+    uint32_t capacity = bucket.burst * 1000;
+    bucket.milliTokens = bucket.milliTokens + 1000 < capacity ? bucket.milliTokens + 1000 : capacity;
+}
+
+void ParanodeRateLimiter::recordThrottled(uint8_t cls) {
+    if (cls < PARANODE_MSG_CLASS_COUNT) {
+        _buckets[cls].throttled++;
+    }
+}
+
+uint32_t ParanodeRateLimiter::throttledCount(ParanodeMessageClass cls) const {
+    return cls < PARANODE_MSG_CLASS_COUNT ? _buckets[cls].throttled : 0;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file ParanodeRateLimiter.h
+ * @brief Per-class token buckets that keep a device within its plan quota
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#ifndef PARANODE_RATE_LIMITER_H
+#define PARANODE_RATE_LIMITER_H
+
+#include <Arduino.h>
+#include "ParanodeMessageClass.h"
+
+/**
+ * @brief What happens to a message that arrives with no tokens left
+ */
+enum ParanodeRatePolicy : uint8_t {
+    PARANODE_RATE_QUEUE,    // Wait in the queue until a token is available
+    PARANODE_RATE_COALESCE, // Replace the waiting message of the same class
+    PARANODE_RATE_DROP      // Discard
+};
+
+/**
+ * @struct ParanodeRateLimit
+ * @brief One class's quota
+ */
+struct ParanodeRateLimit {
+    uint32_t perMinute; // Sustained rate, 0 = unlimited
+    uint32_t burst;     // Bucket size
+};
+
+/**
+ * @class ParanodeRateLimiter
+ * @brief A token bucket per ParanodeMessageClass
+ *
+ * Tokens are kept in thousandths, so rates below one per second refill
+ * smoothly without floating point.
+ */
+class ParanodeRateLimiter {
+public:
+    /**
+     * @brief Constructor (every class unlimited)
+     */
+    ParanodeRateLimiter();
+
+    /**
+     * @brief Set a class's quota; the bucket starts full and refills from its first use
+     * @param burst Bucket size, 0 = ten seconds' worth (at least 1)
+     */
+    void setLimit(ParanodeMessageClass cls, uint32_t perMinute, uint32_t burst = 0);
+
+    /**
+     * @brief Get a class's quota
+     */
+    ParanodeRateLimit getLimit(ParanodeMessageClass cls) const;
+
+    void setPolicy(ParanodeMessageClass cls, ParanodeRatePolicy policy);
+    ParanodeRatePolicy getPolicy(ParanodeMessageClass cls) const;
+
+    /**
+     * @brief Take a token if one is available
+     * @return True if the message may be sent now
+     */
+    bool tryConsume(uint8_t cls, unsigned long now);
+
+    /**
+     * @brief Give back a token taken for a message that was not written
+     */
+    void refund(uint8_t cls);
+
+    /**
+     * @brief Count a message held back by the limiter
+     */
+    void recordThrottled(uint8_t cls);
+
+    /**
+     * @brief Messages held back (queued, coalesced or dropped) for a class
+     */
+    uint32_t throttledCount(ParanodeMessageClass cls) const;
+
+private:
+    struct Bucket {
+        uint32_t perMinute;
+        uint32_t burst;
+        uint32_t milliTokens;
+        unsigned long lastRefill;
+        uint32_t throttled;
+        ParanodeRatePolicy policy;
+    };
+
+    Bucket _buckets[PARANODE_MSG_CLASS_COUNT];
+};
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @file ParanodeReceiveCredits.cpp
+ * @brief Implementation of the inbound receive credits
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "ParanodeReceiveCredits.h"
+
+ParanodeReceiveCredits::ParanodeReceiveCredits()
+    : _received(0), _receivedBytes(0), _held(0), _heldBytes(0), _granted(0), _grantedBytes(0), _announced(false),
+      _overruns(0) {
+}
+
+void ParanodeReceiveCredits::reset() {
+    _received = 0;
+    _receivedBytes = 0;
+    _granted = 0;
+    _grantedBytes = 0;
+    _announced = false;
+}
+
+bool ParanodeReceiveCredits::receive(size_t bytes) {
+    // The server counts every frame it sends, admitted or not
+    _received++;
+    _receivedBytes += bytes;
+
+    // Nothing is enforced before the first grant (auth response, replay)
+    if (_announced && (_received > _granted || _receivedBytes > _grantedBytes)) {
+        _overruns++;
+        return false;
+    }
+
+    _held++;
+    _heldBytes += bytes;
+    return true;
+}
+
+void ParanodeReceiveCredits::release(size_t bytes) {
+    if (_held > 0) {
+        _held--;
+    }
+    _heldBytes = bytes < _heldBytes ? _heldBytes - bytes : 0;
+}
+
+bool ParanodeReceiveCredits::shouldAnnounce() const {
+    if (!_announced) {
+        return true;
+    }
+
+    uint32_t messages = grant();
+    uint32_t bytes = grantBytes();
+    if (messages == _granted && bytes == _grantedBytes) {
+        return false;
+    }
+
+    // The server is waiting on us
+    if (_received >= _granted || _receivedBytes >= _grantedBytes) {
+        return true;
+    }
+    return messages - _granted >= (PARANODE_RECEIVE_CREDITS + 1) / 2 ||
+           bytes - _grantedBytes >= PARANODE_RECEIVE_CREDIT_BYTES / 2;
+}
+
+void ParanodeReceiveCredits::announce(uint32_t* messages, uint32_t* bytes) {
+    _granted = grant();
+    _grantedBytes = grantBytes();
+    _announced = true;
+    if (messages) {
+        *messages = _granted;
+    }
+    if (bytes) {
+        *bytes = _grantedBytes;
+    }
+}
+
+uint32_t ParanodeReceiveCredits::grant() const {
+    return _received + available();
+}
+
+uint32_t ParanodeReceiveCredits::grantBytes() const {
+    uint32_t free = _heldBytes < PARANODE_RECEIVE_CREDIT_BYTES ? PARANODE_RECEIVE_CREDIT_BYTES - _heldBytes : 0;
+    return _receivedBytes + free;
+}
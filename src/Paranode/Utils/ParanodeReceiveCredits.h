@@ -0,0 +1,88 @@
+/**
+ * @file ParanodeReceiveCredits.h
+ * @brief Receive credits the device grants the server for inbound messages
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#ifndef PARANODE_RECEIVE_CREDITS_H
+#define PARANODE_RECEIVE_CREDITS_H
+
+#include <Arduino.h>
+#include "Paranode/ParanodeConfig.h"
+
+/**
+ * @class ParanodeReceiveCredits
+ * @brief Inbound window in messages and bytes, advertised as cumulative grants
+ *
+ * A message holds its credit from the moment it arrives until it has been
+ * handled; a queued command holds it until it has run. The grant sent to
+ * the server is the total it may have sent since the connection opened:
+ *
+ *   grant = received + window - held
+ *
+ * so credits are never lost or counted twice, whatever the order of
+ * announcements and frames in flight.
+ */
+class ParanodeReceiveCredits {
+public:
+    ParanodeReceiveCredits();
+
+    /**
+     * @brief Start counting for a new connection
+     * @note Messages still held from the last connection keep their credit.
+     */
+    void reset();
+
+    /**
+     * @brief Account for an inbound message
+     * @param bytes Frame length
+     * @return False if it exceeds the credit granted (it must be dropped)
+     */
+    bool receive(size_t bytes);
+
+    /**
+     * @brief Give back the credit of a message that has been handled
+     */
+    void release(size_t bytes);
+
+    /**
+     * @brief Check whether enough credit came back to be worth a message
+     *
+     * True for the first grant of a connection, when half a window has been
+     * returned, or when the server has used up the last grant.
+     */
+    bool shouldAnnounce() const;
+
+    /**
+     * @brief Record the grant about to be sent
+     * @param messages Set to the cumulative message grant
+     * @param bytes Set to the cumulative byte grant
+     */
+    void announce(uint32_t* messages, uint32_t* bytes);
+
+    /**
+     * @brief Messages that could be accepted right now
+     */
+    uint16_t available() const { return _held < PARANODE_RECEIVE_CREDITS ? PARANODE_RECEIVE_CREDITS - _held : 0; }
+
+    /**
+     * @brief Messages dropped because the server exceeded its grant
+     */
+    uint32_t overrunCount() const { return _overruns; }
+
+private:
+    uint32_t _received;
+    uint32_t _receivedBytes;
+    uint16_t _held;
+    uint32_t _heldBytes;
+    uint32_t _granted;
+    uint32_t _grantedBytes;
+    bool _announced;
+    uint32_t _overruns;
+
+    uint32_t grant() const;
+    uint32_t grantBytes() const;
+};
+
+#endif
@@ -0,0 +1,207 @@
+/**
+ * @file ParanodeSampler.cpp
+ * @brief Implementation of the per-key sampling rules
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "ParanodeSampler.h"
+
+static const char WILDCARD[] = "*";
+
+ParanodeSampler::ParanodeSampler() : _shed(0), _expiresAt(0), _expires(false) {
+    clear();
+}
+
+bool ParanodeSampler::setRule(const char* key, uint32_t minInterval, ParanodeSampleMode mode, uint8_t priority) {
+    if (!key || key[0] == '\0' || strlen(key) >= PARANODE_MAX_KEY_LENGTH) {
+        return false;
+    }
+
+    bool wildcard = strcmp(key, WILDCARD) == 0;
+    if (wildcard) {
+        // Per-key copies follow the old "*" rule
+        for (size_t i = 0; i < PARANODE_SAMPLING_RULES; i++) {
+            if (_slots[i].derived) {
+                _slots[i].used = false;
+                _slots[i].derived = false;
+            }
+        }
+    }
+
+    Slot* slot = find(key);
+    if (!slot) {
+        for (size_t i = 0; i < PARANODE_SAMPLING_RULES; i++) {
+            if (!_slots[i].used || _slots[i].derived) {
+                slot = &_slots[i];
+                break;
+            }
+        }
+    }
+    if (!slot) {
+        return false;
+    }
+
+    strcpy(slot->key, key);
+    slot->minInterval = minInterval;
+    slot->mode = mode;
+    slot->priority = priority > 2 ? 2 : priority;
+    slot->used = true;
+    slot->derived = false;
+    slot->started = false;
+    return true;
+}
+
+void ParanodeSampler::clear() {
+    for (size_t i = 0; i < PARANODE_SAMPLING_RULES; i++) {
+        _slots[i].used = false;
+        _slots[i].derived = false;
+        _slots[i].started = false;
+    }
+    _expires = false;
+}
+
+void ParanodeSampler::expireAt(unsigned long until) {
+    _expiresAt = until;
+    _expires = true;
+}
+
+bool ParanodeSampler::shouldSample(const char* key, unsigned long now) {
+    checkExpiry(now);
+
+    Slot* slot = resolve(key);
+    if (!slot) {
+        return true;
+    }
+    switch (slot->mode) {
+        case PARANODE_SAMPLE_DROP:
+            return false;
+        case PARANODE_SAMPLE_AGGREGATE:
+            // Every reading counts towards the summary
+            return true;
+        default:
+            return !slot->started || now - slot->lastSent >= slot->minInterval;
+    }
+}
+
+ParanodeSampleAction ParanodeSampler::admit(const char* key, unsigned long now, uint8_t* priority) {
+    checkExpiry(now);
+
+    Slot* slot = resolve(key);
+    if (!slot) {
+        return PARANODE_SAMPLE_SEND;
+    }
+    if (priority) {
+        *priority = slot->priority;
+    }
+    return decide(slot, false, 0, now, nullptr);
+}
+
+ParanodeSampleAction ParanodeSampler::admit(const char* key, float value, unsigned long now, uint8_t* priority,
+                                            ParanodeSampleSummary* summary) {
+    checkExpiry(now);
+
+    Slot* slot = resolve(key);
+    if (!slot) {
+        return PARANODE_SAMPLE_SEND;
+    }
+    if (priority) {
+        *priority = slot->priority;
+    }
+    return decide(slot, true, value, now, summary);
+}
+
+size_t ParanodeSampler::ruleCount() const {
+    size_t count = 0;
+    for (size_t i = 0; i < PARANODE_SAMPLING_RULES; i++) {
+        if (_slots[i].used && !_slots[i].derived) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void ParanodeSampler::checkExpiry(unsigned long now) {
+    if (_expires && (long)(now - _expiresAt) >= 0) {
+        clear();
+    }
+}
+
+ParanodeSampler::Slot* ParanodeSampler::find(const char* key) {
+    for (size_t i = 0; i < PARANODE_SAMPLING_RULES; i++) {
+        if (_slots[i].used && strcmp(_slots[i].key, key) == 0) {
+            return &_slots[i];
+        }
+    }
+    return nullptr;
+}
+
+ParanodeSampler::Slot* ParanodeSampler::resolve(const char* key) {
+    if (!key) {
+        return nullptr;
+    }
+
+    Slot* slot = find(key);
+    if (slot) {
+        return slot;
+    }
+
+    Slot* wildcard = find(WILDCARD);
+    if (!wildcard || strlen(key) >= PARANODE_MAX_KEY_LENGTH) {
+        return wildcard;
+    }
+
+    for (size_t i = 0; i < PARANODE_SAMPLING_RULES; i++) {
+        if (!_slots[i].used) {
+            _slots[i] = *wildcard;
+            strcpy(_slots[i].key, key);
+            _slots[i].derived = true;
+            _slots[i].started = false;
+            return &_slots[i];
+        }
+    }
+    return wildcard;
+}
+
+ParanodeSampleAction ParanodeSampler::decide(Slot* slot, bool numeric, float value, unsigned long now,
+                                             ParanodeSampleSummary* summary) {
+    if (slot->mode == PARANODE_SAMPLE_DROP) {
+        _shed++;
+        return PARANODE_SAMPLE_SKIP;
+    }
+
+    if (slot->mode == PARANODE_SAMPLE_AGGREGATE && numeric && summary) {
+        if (!slot->started) {
+            slot->started = true;
+            slot->lastSent = now;  // Window start
+            slot->sum = 0;
+            slot->min = value;
+            slot->max = value;
+            slot->count = 0;
+        }
+        slot->sum += value;
+        slot->min = value < slot->min ? value : slot->min;
+        slot->max = value > slot->max ? value : slot->max;
+        slot->count++;
+
+        if (now - slot->lastSent < slot->minInterval) {
+            _shed++;
+            return PARANODE_SAMPLE_SKIP;
+        }
+
+        summary->mean = slot->sum / slot->count;
+        summary->min = slot->min;
+        summary->max = slot->max;
+        summary->count = slot->count;
+        slot->started = false;
+        return PARANODE_SAMPLE_SUMMARY;
+    }
+
+    if (slot->started && now - slot->lastSent < slot->minInterval) {
+        _shed++;
+        return PARANODE_SAMPLE_SKIP;
+    }
+    slot->started = true;
+    slot->lastSent = now;
+    return PARANODE_SAMPLE_SEND;
+}
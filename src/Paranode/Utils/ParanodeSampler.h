@@ -0,0 +1,135 @@
+/**
+ * @file ParanodeSampler.h
+ * @brief Server-pushed per-key sampling rules for load shedding
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#ifndef PARANODE_SAMPLER_H
+#define PARANODE_SAMPLER_H
+
+#include <Arduino.h>
+#include "Paranode/ParanodeConfig.h"
+
+/**
+ * @brief What a rule does with readings inside its interval
+ */
+enum ParanodeSampleMode : uint8_t {
+    PARANODE_SAMPLE_INTERVAL,  // Send at most one reading per interval, skip the rest
+    PARANODE_SAMPLE_AGGREGATE, // Fold readings into one mean/min/max/count per interval
+    PARANODE_SAMPLE_DROP       // Send nothing for this key
+};
+
+/**
+ * @brief Decision for one reading
+ */
+enum ParanodeSampleAction : uint8_t {
+    PARANODE_SAMPLE_SEND,   // Send the reading as is
+    PARANODE_SAMPLE_SKIP,   // Shed it (or it was folded into the running summary)
+    PARANODE_SAMPLE_SUMMARY // Send the summary instead; the window restarts
+};
+
+/**
+ * @struct ParanodeSampleSummary
+ * @brief One aggregation window
+ */
+struct ParanodeSampleSummary {
+    float mean;
+    float min;
+    float max;
+    uint32_t count;
+};
+
+/**
+ * @class ParanodeSampler
+ * @brief Fixed table of sampling rules keyed by telemetry key
+ *
+ * A rule for "*" applies to every key without its own rule. It is copied
+ * into a free slot the first time a key uses it, so each key keeps its own
+ * interval; once the table is full those keys share the "*" slot.
+ */
+class ParanodeSampler {
+public:
+    /**
+     * @brief Constructor (no rules: everything is sent)
+     */
+    ParanodeSampler();
+
+    /**
+     * @brief Add or replace the rule for a key
+     * @param key Telemetry key, or "*" for every other key
+     * @param minInterval Minimum ms between readings sent for the key
+     * @param mode How readings inside the interval are handled
+     * @param priority Queue priority for the key (0 = low, 2 = high)
+     * @return False if the key is too long or the table is full
+     */
+    bool setRule(const char* key, uint32_t minInterval, ParanodeSampleMode mode, uint8_t priority = 1);
+
+    /**
+     * @brief Remove every rule
+     */
+    void clear();
+
+    /**
+     * @brief Remove every rule at a point in time
+     * @param until Clock::millis() value after which the rules lapse
+     */
+    void expireAt(unsigned long until);
+
+    /**
+     * @brief Check whether a reading taken now would be used
+     */
+    bool shouldSample(const char* key, unsigned long now);
+
+    /**
+     * @brief Decide on a non-numeric reading (aggregation acts as interval)
+     * @param priority Set to the rule's queue priority
+     */
+    ParanodeSampleAction admit(const char* key, unsigned long now, uint8_t* priority);
+
+    /**
+     * @brief Decide on a numeric reading
+     * @param summary Filled when PARANODE_SAMPLE_SUMMARY is returned
+     */
+    ParanodeSampleAction admit(const char* key, float value, unsigned long now, uint8_t* priority,
+                               ParanodeSampleSummary* summary);
+
+    /**
+     * @brief Rules pushed or set (per-key copies of "*" not counted)
+     */
+    size_t ruleCount() const;
+
+    /**
+     * @brief Readings skipped or folded into a summary
+     */
+    uint32_t shedCount() const { return _shed; }
+
+private:
+    struct Slot {
+        char key[PARANODE_MAX_KEY_LENGTH];
+        uint32_t minInterval;
+        uint8_t mode;
+        uint8_t priority;
+        bool used;
+        bool derived;  // Copy of the "*" rule for one key
+        bool started;  // lastSent/windowStart is valid
+        unsigned long lastSent;
+        float sum;
+        float min;
+        float max;
+        uint32_t count;
+    };
+
+    Slot _slots[PARANODE_SAMPLING_RULES];
+    uint32_t _shed;
+    unsigned long _expiresAt;
+    bool _expires;
+
+    void checkExpiry(unsigned long now);
+    Slot* find(const char* key);
+    Slot* resolve(const char* key);
+    ParanodeSampleAction decide(Slot* slot, bool numeric, float value, unsigned long now,
+                                ParanodeSampleSummary* summary);
+};
+
+#endif
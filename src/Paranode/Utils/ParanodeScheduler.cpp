@@ -0,0 +1,71 @@
+/**
+ * @file ParanodeScheduler.cpp
+ * @brief Implementation of the live/backlog scheduler
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "ParanodeScheduler.h"
+
+ParanodeScheduler::ParanodeScheduler()
+    : _liveShare(PARANODE_LIVE_SHARE), _backlogShare(PARANODE_BACKLOG_SHARE), _liveCredit(0), _backlogCredit(0),
+      _liveSince(0), _windowStart(0), _window(1), _windowUsed(0) {
+}
+
+void ParanodeScheduler::setShares(uint8_t live, uint8_t backlog) {
+    _liveShare = live > 0 ? live : 1;
+    _backlogShare = backlog > 0 ? backlog : 1;
+    _liveCredit = 0;
+    _backlogCredit = 0;
+}
+
+void ParanodeScheduler::restart(unsigned long now) {
+    _liveSince = now;
+    _windowStart = now;
+    _window = 1;
+    _windowUsed = 0;
+    _liveCredit = 0;
+    _backlogCredit = 0;
+}
+
+ParanodeLane ParanodeScheduler::next(bool liveWaiting, bool backlogWaiting, unsigned long now) {
+    if (now - _windowStart >= PARANODE_SLOW_START_INTERVAL) {
+        // A window used in full without a failure: double it
+        if (_windowUsed >= _window && _window < PARANODE_BACKLOG_WINDOW_MAX) {
+            _window = _window * 2 < PARANODE_BACKLOG_WINDOW_MAX ? _window * 2 : PARANODE_BACKLOG_WINDOW_MAX;
+        }
+        _windowStart = now;
+        _windowUsed = 0;
+    }
+
+    bool backlogReady = backlogWaiting && _windowUsed < _window;
+    if (!liveWaiting) {
+        return backlogReady ? PARANODE_LANE_BACKLOG : PARANODE_LANE_NONE;
+    }
+    if (!backlogReady) {
+        return PARANODE_LANE_LIVE;
+    }
+
+    if (_liveCredit == 0 && _backlogCredit == 0) {
+        _liveCredit = _liveShare;
+        _backlogCredit = _backlogShare;
+    }
+    return _liveCredit > 0 ? PARANODE_LANE_LIVE : PARANODE_LANE_BACKLOG;
+}
+
+void ParanodeScheduler::sent(ParanodeLane lane) {
+    if (lane == PARANODE_LANE_LIVE) {
+        if (_liveCredit > 0) {
+            _liveCredit--;
+        }
+    } else if (lane == PARANODE_LANE_BACKLOG) {
+        if (_backlogCredit > 0) {
+            _backlogCredit--;
+        }
+        _windowUsed++;
+    }
+}
+
+void ParanodeScheduler::failed() {
+    _window = _window > 1 ? _window / 2 : 1;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file ParanodeScheduler.h
+ * @brief Shares the link between live messages and post-outage backlog
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#ifndef PARANODE_SCHEDULER_H
+#define PARANODE_SCHEDULER_H
+
+#include <Arduino.h>
+
+// Sends per round: live messages and backlog frames
+#ifndef PARANODE_LIVE_SHARE
+#define PARANODE_LIVE_SHARE 3
+#endif
+
+#ifndef PARANODE_BACKLOG_SHARE
+#define PARANODE_BACKLOG_SHARE 1
+#endif
+
+// Slow start: backlog frames per interval start at 1 and double each interval
+#ifndef PARANODE_SLOW_START_INTERVAL
+#define PARANODE_SLOW_START_INTERVAL 200
+#endif
+
+#ifndef PARANODE_BACKLOG_WINDOW_MAX
+#define PARANODE_BACKLOG_WINDOW_MAX 8
+#endif
+
+enum ParanodeLane : uint8_t {
+    PARANODE_LANE_NONE,
+    PARANODE_LANE_LIVE,   // Queued on the current connection
+    PARANODE_LANE_BACKLOG // Queued before it, sent as bulk frames
+};
+
+/**
+ * @class ParanodeScheduler
+ * @brief Weighted round robin between two lanes, with slow start for backlog
+ *
+ * A lane with nothing to send gives its turn to the other, so the link is
+ * never idle while either has data. The backlog window is halved when a
+ * write fails.
+ */
+class ParanodeScheduler {
+public:
+    ParanodeScheduler();
+
+    /**
+     * @brief Set the sends per round (each at least 1)
+     */
+    void setShares(uint8_t live, uint8_t backlog);
+
+    /**
+     * @brief A connection has opened: what is queued now is backlog
+     */
+    void restart(unsigned long now);
+
+    /**
+     * @brief Messages queued before this time are backlog
+     */
+    unsigned long liveSince() const { return _liveSince; }
+
+    /**
+     * @brief Pick the lane for the next send
+     */
+    ParanodeLane next(bool liveWaiting, bool backlogWaiting, unsigned long now);
+
+    /**
+     * @brief Count a send made on a lane
+     */
+    void sent(ParanodeLane lane);
+
+    /**
+     * @brief A backlog write failed: back off
+     */
+    void failed();
+
+    uint8_t backlogWindow() const { return _window; }
+
+private:
+    uint8_t _liveShare;
+    uint8_t _backlogShare;
+    uint8_t _liveCredit;
+    uint8_t _backlogCredit;
+    unsigned long _liveSince;
+    unsigned long _windowStart;
+    uint8_t _window;
+    uint8_t _windowUsed;
+};
+
+#endif
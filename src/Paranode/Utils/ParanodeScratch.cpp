@@ -0,0 +1,129 @@
+/**
+ * @file ParanodeScratch.cpp
+ * @brief Implementation of the scratch arena
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "ParanodeScratch.h"
+
+static size_t alignUp(size_t size) {
+    return (size + 7) & ~(size_t)7;
+}
+
+ParanodeScratch::ParanodeScratch()
+    : _used(0), _highWater(0), _windowPeak(0), _failures(0), _stackBase(0), _freeStackMin(0) {
+    memset(_stackDepth, 0, sizeof(_stackDepth));
+    memset(_scratchPeak, 0, sizeof(_scratchPeak));
+}
+
+void* ParanodeScratch::allocate(size_t size) {
+    size = alignUp(size);
+    if (size == 0 || size > PARANODE_SCRATCH_SIZE - _used) {
+        _failures++;
+        return nullptr;
+    }
+
+    void* ptr = _buffer + _used;
+    _used += size;
+
+    if (_used > _highWater) {
+        _highWater = _used;
+    }
+    if (_used > _windowPeak) {
+        _windowPeak = _used;
+    }
+    return ptr;
+}
+
+void ParanodeScratch::release(void* ptr) {
+    uint8_t* p = (uint8_t*)ptr;
+    if (p >= _buffer && p < _buffer + _used) {
+        _used = p - _buffer;
+    }
+}
+
+void* ParanodeScratch::reallocate(void* ptr, size_t size) {
+    uint8_t* p = (uint8_t*)ptr;
+    if (p < _buffer || p >= _buffer + _used) {
+        return nullptr;
+    }
+
+    size_t offset = p - _buffer;
+    size = alignUp(size);
+    if (size > PARANODE_SCRATCH_SIZE - offset) {
+        return nullptr;
+    }
+
+    // Only the most recent allocation can change size; anything allocated
+    // after ptr is released with it, as with release()
+    _used = offset + size;
+    if (_used > _highWater) {
+        _highWater = _used;
+    }
+    if (_used > _windowPeak) {
+        _windowPeak = _used;
+    }
+    return ptr;
+}
+
+void ParanodeScratch::setStackBase() {
+    uint8_t marker;
+    _stackBase = (uintptr_t)&marker;
+
+    uint32_t freeStack = 0;
+#ifdef ESP32
+    freeStack = uxTaskGetStackHighWaterMark(NULL);
+#elif defined(ESP8266)
+    freeStack = ESP.getFreeContStack();
+#endif
+    if (freeStack > 0 && (_freeStackMin == 0 || freeStack < _freeStackMin)) {
+        _freeStackMin = freeStack;
+    }
+}
+
+void ParanodeScratch::probeStack(ParanodeEntryPoint entry) {
+    uint8_t marker;
+    uintptr_t here = (uintptr_t)&marker;
+
+    // The stack grows down on Xtensa and RISC-V
+    if (_stackBase == 0 || here > _stackBase) {
+        return;
+    }
+
+    uintptr_t depth = _stackBase - here;
+    if (depth > 0xFFFF) {
+        depth = 0xFFFF;
+    }
+    if (depth > _stackDepth[entry]) {
+        _stackDepth[entry] = depth;
+    }
+}
+
+void ParanodeScratch::getReport(ParanodeStackReport& report) const {
+    memcpy(report.stackDepth, _stackDepth, sizeof(report.stackDepth));
+    memcpy(report.scratchPeak, _scratchPeak, sizeof(report.scratchPeak));
+    report.scratchCapacity = PARANODE_SCRATCH_SIZE;
+    report.scratchHighWater = _highWater;
+    report.scratchFailures = _failures;
+    report.freeStackMin = _freeStackMin;
+}
+
+ParanodeScratchScope::ParanodeScratchScope(ParanodeScratch& scratch, ParanodeEntryPoint entry)
+    : _scratch(scratch), _entry(entry), _mark(scratch._used), _outerWindowPeak(scratch._windowPeak) {
+    _scratch._windowPeak = _mark;
+    _scratch.probeStack(entry);
+}
+
+ParanodeScratchScope::~ParanodeScratchScope() {
+    size_t peak = _scratch._windowPeak - _mark;
+    if (peak > _scratch._scratchPeak[_entry]) {
+        _scratch._scratchPeak[_entry] = peak;
+    }
+
+    // Let the enclosing scope see what we used
+    if (_outerWindowPeak > _scratch._windowPeak) {
+        _scratch._windowPeak = _outerWindowPeak;
+    }
+    _scratch._used = _mark;
+}
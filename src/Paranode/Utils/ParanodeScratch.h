@@ -0,0 +1,160 @@
+/**
+ * @file ParanodeScratch.h
+ * @brief Scratch arena for temporary buffers and stack budget tracking
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Large temporaries (the JSON document used to parse server messages and
+ * the dequeue buffers of the send path) are taken from a fixed arena owned
+ * by Paranode instead of the stack. Allocations are released in LIFO order
+ * by ParanodeScratchScope, so nested use (a command callback that flushes
+ * the queue) works naturally.
+ *
+ * The arena also records, per entry point, the peak arena use and the stack
+ * depth below Paranode::loop(), so the worst case can be checked on device.
+ */
+
+#ifndef PARANODE_SCRATCH_H
+#define PARANODE_SCRATCH_H
+
+#include <Arduino.h>
+#include "Paranode/ParanodeConfig.h"
+
+// Parse document for server messages
+#ifndef PARANODE_JSON_DOC_SIZE
+#define PARANODE_JSON_DOC_SIZE 1024
+#endif
+
+// Enough for the parse document plus one nested dequeue buffer
+#ifndef PARANODE_SCRATCH_SIZE
+#define PARANODE_SCRATCH_SIZE 1536
+#endif
+
+enum ParanodeEntryPoint {
+    PARANODE_ENTRY_HANDLE_MESSAGE = 0,
+    PARANODE_ENTRY_PROCESS_QUEUE,
+    PARANODE_ENTRY_FLUSH_QUEUE,
+    PARANODE_ENTRY_RUN_COMMANDS,
+    PARANODE_ENTRY_CALLBACK, // Where user callbacks start
+    PARANODE_ENTRY_COUNT
+};
+
+/**
+ * @struct ParanodeStackReport
+ * @brief Peak stack and arena use per entry point
+ */
+struct ParanodeStackReport {
+    uint16_t stackDepth[PARANODE_ENTRY_COUNT];  // Bytes below Paranode::loop()
+    uint16_t scratchPeak[PARANODE_ENTRY_COUNT]; // Arena bytes incl. nested calls
+    uint16_t scratchCapacity;
+    uint16_t scratchHighWater;
+    uint16_t scratchFailures;                   // Allocations that didn't fit
+    uint32_t freeStackMin;                      // Lowest free stack seen (bytes, 0 if unknown)
+};
+
+/**
+ * @class ParanodeScratch
+ * @brief Fixed-size LIFO arena
+ */
+class ParanodeScratch {
+public:
+    /**
+     * @brief Constructor
+     */
+    ParanodeScratch();
+
+    /**
+     * @brief Allocate from the arena
+     * @param size Bytes needed (rounded up to 8)
+     * @return Pointer, or nullptr if the arena is exhausted
+     */
+    void* allocate(size_t size);
+
+    /**
+     * @brief Release everything allocated at or after ptr
+     */
+    void release(void* ptr);
+
+    /**
+     * @brief Grow or shrink the most recent allocation in place
+     * @return ptr, or nullptr if it isn't the most recent allocation or doesn't fit
+     */
+    void* reallocate(void* ptr, size_t size);
+
+    /**
+     * @brief Bytes currently in use
+     */
+    size_t used() const { return _used; }
+
+    /**
+     * @brief Arena size in bytes
+     */
+    size_t capacity() const { return PARANODE_SCRATCH_SIZE; }
+
+    /**
+     * @brief Mark the stack position of Paranode::loop()
+     */
+    void setStackBase();
+
+    /**
+     * @brief Record the stack depth reached at an entry point
+     */
+    void probeStack(ParanodeEntryPoint entry);
+
+    /**
+     * @brief Fill a report with the peaks seen since startup
+     */
+    void getReport(ParanodeStackReport& report) const;
+
+private:
+    friend class ParanodeScratchScope;
+
+    alignas(8) uint8_t _buffer[PARANODE_SCRATCH_SIZE];
+    size_t _used;
+    size_t _highWater;
+    size_t _windowPeak;
+    uint16_t _failures;
+    uintptr_t _stackBase;
+    uint16_t _stackDepth[PARANODE_ENTRY_COUNT];
+    uint16_t _scratchPeak[PARANODE_ENTRY_COUNT];
+    uint32_t _freeStackMin;
+};
+
+/**
+ * @class ParanodeScratchScope
+ * @brief Releases every allocation made through it when it goes out of scope
+ */
+class ParanodeScratchScope {
+public:
+    ParanodeScratchScope(ParanodeScratch& scratch, ParanodeEntryPoint entry);
+    ~ParanodeScratchScope();
+
+    void* allocate(size_t size) { return _scratch.allocate(size); }
+
+private:
+    ParanodeScratch& _scratch;
+    ParanodeEntryPoint _entry;
+    size_t _mark;
+    size_t _outerWindowPeak;
+
+    ParanodeScratchScope(const ParanodeScratchScope&);
+    ParanodeScratchScope& operator=(const ParanodeScratchScope&);
+};
+
+/**
+ * @struct ParanodeScratchAllocator
+ * @brief ArduinoJson allocator backed by the arena
+ *
+ * Use with BasicJsonDocument inside a ParanodeScratchScope.
+ */
+struct ParanodeScratchAllocator {
+    ParanodeScratch* scratch;
+
+    explicit ParanodeScratchAllocator(ParanodeScratch* s = nullptr) : scratch(s) {}
+
+    void* allocate(size_t size) { return scratch ? scratch->allocate(size) : nullptr; }
+    void deallocate(void* ptr) { if (scratch && ptr) scratch->release(ptr); }
+    void* reallocate(void* ptr, size_t size) { return scratch ? scratch->reallocate(ptr, size) : nullptr; }
+};
+
+#endif
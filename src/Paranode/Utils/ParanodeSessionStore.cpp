@@ -0,0 +1,163 @@
+/**
+ * @file ParanodeSessionStore.cpp
+ * @brief Implementation of the persisted session state
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "ParanodeSessionStore.h"
+
+#if PARANODE_ENABLE_SESSION_STORE
+
+#ifdef ESP32
+#include <Preferences.h>
+#else
+#include <EEPROM.h>
+#endif
+
+static const uint32_t SESSION_MAGIC = 0x31534E50; // "PNS1"
+static const uint16_t SESSION_VERSION = 5;
+
+ParanodeSessionStore::ParanodeSessionStore()
+    : _storedChecksum(0), _writes(0) {
+}
+
+uint32_t ParanodeSessionStore::hash(const void* data, size_t length, uint32_t seed) {
+    // FNV-1a
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint32_t h = seed;
+    for (size_t i = 0; i < length; i++) {
+        h = (h ^ bytes[i]) * 16777619UL;
+    }
+    return h;
+}
+
+uint32_t ParanodeSessionStore::checksum(const Record& record) {
+    return hash(&record, offsetof(Record, checksum));
+}
+
+bool ParanodeSessionStore::load(const char* owner, ParanodeSessionState& state) {
+    Record record;
+    if (!readRecord(record) ||
+        record.magic != SESSION_MAGIC ||
+        record.version != SESSION_VERSION ||
+        record.size != sizeof(Record) ||
+        record.checksum != checksum(record)) {
+        return false;
+    }
+    _storedChecksum = record.checksum;
+
+    if (record.owner != hash(owner, strlen(owner))) {
+        return false;
+    }
+
+    state = record.state;
+    state.deviceId[sizeof(state.deviceId) - 1] = '\0';
+    state.sessionToken[sizeof(state.sessionToken) - 1] = '\0';
+    return true;
+}
+
+bool ParanodeSessionStore::save(const char* owner, const ParanodeSessionState& state) {
+    Record record;
+    memset(&record, 0, sizeof(record)); // Padding is part of the checksum
+    record.magic = SESSION_MAGIC;
+    record.version = SESSION_VERSION;
+    record.size = sizeof(Record);
+    record.owner = hash(owner, strlen(owner));
+    record.state = state;
+    record.checksum = checksum(record);
+
+    if (record.checksum == _storedChecksum) {
+        return true;
+    }
+
+    if (!writeRecord(record)) {
+        return false;
+    }
+    _storedChecksum = record.checksum;
+    _writes++;
+    return true;
+}
+
+#ifdef ESP32
+
+bool ParanodeSessionStore::readRecord(Record& record) {
+    Preferences prefs;
+    if (!prefs.begin("paranode", true)) {
+        return false;
+    }
+    bool ok = prefs.getBytes("session", &record, sizeof(record)) == sizeof(record);
+    prefs.end();
+    return ok;
+}
+
+bool ParanodeSessionStore::writeRecord(const Record& record) {
+    Preferences prefs;
+    if (!prefs.begin("paranode", false)) {
+        return false;
+    }
+    bool ok = prefs.putBytes("session", &record, sizeof(record)) == sizeof(record);
+    prefs.end();
+    return ok;
+}
+
+void ParanodeSessionStore::clear() {
+    Preferences prefs;
+    if (prefs.begin("paranode", false)) {
+        prefs.remove("session");
+        prefs.end();
+    }
+    _storedChecksum = 0;
+}
+
+#else
+
+// EEPROM keeps a RAM mirror while open. A sketch that uses EEPROM itself
+// may keep it open: its mirror is used as it is and left open. Otherwise
+// the store opens one for each access and closes it again.
+
+static bool beginEEPROM(size_t size, bool* opened) {
+    *opened = EEPROM.length() == 0;
+    if (*opened) {
+        EEPROM.begin(size);
+    }
+    return EEPROM.length() >= size;
+}
+
+static void endEEPROM(bool opened) {
+    if (opened) {
+        EEPROM.end();
+    }
+}
+
+bool ParanodeSessionStore::readRecord(Record& record) {
+    bool opened;
+    bool ok = beginEEPROM(PARANODE_SESSION_EEPROM_OFFSET + sizeof(Record), &opened);
+    if (ok) {
+        EEPROM.get(PARANODE_SESSION_EEPROM_OFFSET, record);
+    }
+    endEEPROM(opened);
+    return ok;
+}
+
+bool ParanodeSessionStore::writeRecord(const Record& record) {
+    bool opened;
+    bool ok = beginEEPROM(PARANODE_SESSION_EEPROM_OFFSET + sizeof(Record), &opened);
+    if (ok) {
+        EEPROM.put(PARANODE_SESSION_EEPROM_OFFSET, record);
+        ok = EEPROM.commit();
+    }
+    endEEPROM(opened);
+    return ok;
+}
+
+void ParanodeSessionStore::clear() {
+    Record record;
+    memset(&record, 0, sizeof(record));
+    writeRecord(record);
+    _storedChecksum = 0;
+}
+
+#endif
+
+#endif
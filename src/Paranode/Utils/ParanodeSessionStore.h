@@ -0,0 +1,101 @@
+/**
+ * @file ParanodeSessionStore.h
+ * @brief Server-assigned session state kept across reboots
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Stored in NVS (Preferences) on ESP32 and in EEPROM on ESP8266. The record
+ * is tagged with a hash of the project token (or legacy device ID), so
+ * flashing a device into another project starts from a clean state.
+ */
+
+#ifndef PARANODE_SESSION_STORE_H
+#define PARANODE_SESSION_STORE_H
+
+#include <Arduino.h>
+#include "Paranode/ParanodeConfig.h"
+#include "ParanodeTuning.h"
+#include "ParanodeRateLimiter.h"
+
+// ESP8266 only: EEPROM offset of the record. The bytes from here to
+// offset + sizeof(record) are the library's; move it if the sketch uses them
+#ifndef PARANODE_SESSION_EEPROM_OFFSET
+#define PARANODE_SESSION_EEPROM_OFFSET 0
+#endif
+
+/**
+ * @struct ParanodeSessionState
+ * @brief What the server told the device last time
+ */
+struct ParanodeSessionState {
+    char deviceId[PARANODE_MAX_ID_LENGTH]; // From auth_response (token auth)
+    ParanodeTuning tuning;                 // From config
+    uint32_t configSchema;                 // PARANODE_CONFIG_SCHEMA_VERSION of the tuning
+    uint32_t firmwareHash;                 // hash() of the firmware version that ran the tuning
+    ParanodeRateLimit limits[PARANODE_MSG_CLASS_COUNT]; // From the project plan
+    char sessionToken[PARANODE_MAX_TOKEN_LENGTH]; // Presented in the WebSocket upgrade
+    uint32_t deviceInfoHash;               // device_info last delivered
+};
+
+/**
+ * @class ParanodeSessionStore
+ * @brief Loads and saves ParanodeSessionState
+ *
+ * save() skips the write when nothing changed, so calling it on every
+ * server reply costs no flash wear.
+ */
+class ParanodeSessionStore {
+public:
+    /**
+     * @brief Constructor
+     */
+    ParanodeSessionStore();
+
+    /**
+     * @brief Read the stored state
+     * @param owner Project token (or legacy device ID) the state belongs to
+     * @param state Output state
+     * @return False if nothing valid is stored for this owner
+     */
+    bool load(const char* owner, ParanodeSessionState& state);
+
+    /**
+     * @brief Store the state if it differs from what is stored
+     * @return False if the write failed
+     */
+    bool save(const char* owner, const ParanodeSessionState& state);
+
+    /**
+     * @brief Erase the stored state
+     */
+    void clear();
+
+    /**
+     * @brief Flash writes since startup
+     */
+    uint32_t writeCount() const { return _writes; }
+
+    /**
+     * @brief FNV-1a, as used for the owner tag and the checksum
+     */
+    static uint32_t hash(const void* data, size_t length, uint32_t seed = 2166136261UL);
+
+private:
+    struct Record {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t size;
+        uint32_t owner;
+        ParanodeSessionState state;
+        uint32_t checksum;
+    };
+
+    uint32_t _storedChecksum; // Checksum of the stored record, 0 if unknown
+    uint32_t _writes;
+
+    static uint32_t checksum(const Record& record);
+    bool readRecord(Record& record);
+    bool writeRecord(const Record& record);
+};
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ * @file ParanodeSha256.h
+ * @brief Small incremental SHA-256 for verifying firmware images
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Self-contained so it behaves the same on ESP32 (mbedTLS) and ESP8266
+ * (BearSSL) cores, whose hash APIs differ between core versions.
+ */
+
+#ifndef PARANODE_SHA256_H
+#define PARANODE_SHA256_H
+
+#include <Arduino.h>
+
+#define PARANODE_SHA256_SIZE 32
+
+/**
+ * @class ParanodeSha256
+ * @brief Incremental SHA-256 (about 110 bytes of state)
+ */
+class ParanodeSha256 {
+public:
+    ParanodeSha256();
+
+    /**
+     * @brief Start a new digest
+     */
+    void reset();
+
+    /**
+     * @brief Hash more data
+     */
+    void update(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Finish and write the 32-byte digest
+     * @note Call reset() before reusing
+     */
+    void finish(uint8_t digest[PARANODE_SHA256_SIZE]);
+
+    /**
+     * @brief Parse a 64-character hex digest
+     * @return False if the string isn't a valid digest
+     */
+    static bool parseHex(const char* hex, uint8_t digest[PARANODE_SHA256_SIZE]);
+
+private:
+    uint32_t _state[8];
+    uint8_t _block[64];
+    uint64_t _length;
+    uint8_t _blockLength;
+
+    void transform(const uint8_t* block);
+};
+
+#endif
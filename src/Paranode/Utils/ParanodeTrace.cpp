@@ -0,0 +1,166 @@
+/**
+ * @file ParanodeTrace.cpp
+ * @brief Implementation of per-message latency tracing
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "ParanodeTrace.h"
+
+#ifdef PARANODE_ENABLE_TRACE
+
+static const char* const STAGE_NAMES[PARANODE_TRACE_STAGE_COUNT] = {
+    "total", "enqueue", "queue", "write", "ack"
+};
+
+ParanodeTrace::ParanodeTrace() : _sampling(1) {
+    memset(_entries, 0, sizeof(_entries));
+}
+
+void ParanodeTrace::setSampling(uint16_t everyN) {
+    _sampling = everyN > 0 ? everyN : 1;
+}
+
+void ParanodeTrace::begin(uint32_t seq) {
+    if (seq == 0 || (seq % _sampling) != 0) {
+        return;
+    }
+
+    Entry& entry = _entries[seq % PARANODE_TRACE_SIZE];
+    memset(&entry, 0, sizeof(entry));
+    entry.seq = seq;
+    entry.stamps[PARANODE_TRACE_CREATED] = micros() | 1; // 0 means "not reached"
+}
+
+void ParanodeTrace::mark(uint32_t seq, ParanodeTraceStage stage) {
+    Entry* entry = find(seq);
+    if (entry && entry->stamps[stage] == 0) {
+        entry->stamps[stage] = micros() | 1;
+    }
+}
+
+ParanodeTrace::Entry* ParanodeTrace::find(uint32_t seq) {
+    if (seq == 0) {
+        return nullptr;
+    }
+    Entry& entry = _entries[seq % PARANODE_TRACE_SIZE];
+    return entry.seq == seq ? &entry : nullptr;
+}
+
+int ParanodeTrace::previousStage(const Entry& entry, int stage) {
+    for (int i = stage - 1; i >= 0; i--) {
+        if (entry.stamps[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static uint32_t percentile(uint32_t* values, uint16_t count, uint8_t pct) {
+    // Insertion sort - count is at most PARANODE_TRACE_SIZE
+    for (uint16_t i = 1; i < count; i++) {
+        uint32_t v = values[i];
+        int j = i - 1;
+        while (j >= 0 && values[j] > v) {
+            values[j + 1] = values[j];
+            j--;
+        }
+        values[j + 1] = v;
+    }
+    uint16_t idx = ((uint32_t)(count - 1) * pct) / 100;
+    return values[idx];
+}
+
+void ParanodeTrace::summarize(ParanodeTraceSummary& summary) const {
+    memset(&summary, 0, sizeof(summary));
+    uint32_t values[PARANODE_TRACE_SIZE];
+
+    for (int stage = 0; stage < PARANODE_TRACE_STAGE_COUNT; stage++) {
+        uint16_t count = 0;
+        for (size_t i = 0; i < PARANODE_TRACE_SIZE; i++) {
+            const Entry& entry = _entries[i];
+            if (!entry.seq) {
+                continue;
+            }
+
+            if (stage == PARANODE_TRACE_CREATED) {
+                int last = previousStage(entry, PARANODE_TRACE_STAGE_COUNT);
+                if (last > PARANODE_TRACE_CREATED) {
+                    values[count++] = entry.stamps[last] - entry.stamps[PARANODE_TRACE_CREATED];
+                }
+            } else if (entry.stamps[stage]) {
+                int prev = previousStage(entry, stage);
+                if (prev >= 0) {
+                    values[count++] = entry.stamps[stage] - entry.stamps[prev];
+                }
+            }
+        }
+
+        if (count > 0) {
+            summary.samples[stage] = count;
+            summary.p50[stage] = percentile(values, count, 50);
+            summary.p99[stage] = percentile(values, count, 99);
+            summary.max[stage] = values[count - 1];
+        }
+    }
+}
+
+void ParanodeTrace::writeChromeTrace(Print& out) const {
+    out.print("{\"traceEvents\":[");
+    bool first = true;
+
+    for (size_t i = 0; i < PARANODE_TRACE_SIZE; i++) {
+        const Entry& entry = _entries[i];
+        if (!entry.seq) {
+            continue;
+        }
+
+        // One complete ("X") event per stage interval, one row per message
+        for (int stage = PARANODE_TRACE_ENQUEUED; stage < PARANODE_TRACE_STAGE_COUNT; stage++) {
+            if (!entry.stamps[stage]) {
+                continue;
+            }
+            int prev = previousStage(entry, stage);
+            if (prev < 0) {
+                continue;
+            }
+
+            if (!first) {
+                out.print(',');
+            }
+            first = false;
+
+            out.print("{\"name\":\"");
+            out.print(STAGE_NAMES[stage]);
+            out.print("\",\"ph\":\"X\",\"pid\":1,\"tid\":");
+            out.print(entry.seq);
+            out.print(",\"ts\":");
+            out.print(entry.stamps[prev]);
+            out.print(",\"dur\":");
+            out.print(entry.stamps[stage] - entry.stamps[prev]);
+            out.print('}');
+        }
+    }
+
+    out.print("]}");
+}
+
+void ParanodeTrace::printSummary(Print& out) const {
+    ParanodeTraceSummary summary;
+    summarize(summary);
+
+    out.println("stage,samples,p50_us,p99_us,max_us");
+    for (int stage = 0; stage < PARANODE_TRACE_STAGE_COUNT; stage++) {
+        out.print(STAGE_NAMES[stage]);
+        out.print(',');
+        out.print(summary.samples[stage]);
+        out.print(',');
+        out.print(summary.p50[stage]);
+        out.print(',');
+        out.print(summary.p99[stage]);
+        out.print(',');
+        out.println(summary.max[stage]);
+    }
+}
+
+#endif
@@ -0,0 +1,125 @@
+/**
+ * @file ParanodeTrace.h
+ * @brief Optional per-message latency tracing
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Records when a telemetry message passes each stage of the send path,
+ * keyed by its "seq" number, in a small side ring (nothing is added to the
+ * payload). Enable with -DPARANODE_ENABLE_TRACE in your build flags;
+ * otherwise every call compiles to nothing.
+ *
+ * Stages: created (sendData) -> enqueued -> dequeued/batched -> written
+ * to the socket -> acked by the server ({"type":"ack","seq":N}).
+ */
+
+#ifndef PARANODE_TRACE_H
+#define PARANODE_TRACE_H
+
+#include <Arduino.h>
+#include "Paranode/ParanodeConfig.h"
+
+#ifndef PARANODE_TRACE_SIZE
+#define PARANODE_TRACE_SIZE 32
+#endif
+
+enum ParanodeTraceStage {
+    PARANODE_TRACE_CREATED = 0,
+    PARANODE_TRACE_ENQUEUED,
+    PARANODE_TRACE_DEQUEUED,
+    PARANODE_TRACE_WRITTEN,
+    PARANODE_TRACE_ACKED,
+    PARANODE_TRACE_STAGE_COUNT
+};
+
+/**
+ * @struct ParanodeTraceSummary
+ * @brief Latency percentiles (microseconds) for the time spent before each stage
+ *
+ * Index by ParanodeTraceStage; entry i covers the time from the previous
+ * recorded stage to stage i. Index PARANODE_TRACE_CREATED holds the
+ * end-to-end total instead.
+ */
+struct ParanodeTraceSummary {
+    uint16_t samples[PARANODE_TRACE_STAGE_COUNT];
+    uint32_t p50[PARANODE_TRACE_STAGE_COUNT];
+    uint32_t p99[PARANODE_TRACE_STAGE_COUNT];
+    uint32_t max[PARANODE_TRACE_STAGE_COUNT];
+};
+
+#ifdef PARANODE_ENABLE_TRACE
+
+/**
+ * @class ParanodeTrace
+ * @brief Fixed-size ring of per-message stage timestamps
+ */
+class ParanodeTrace {
+public:
+    /**
+     * @brief Constructor
+     */
+    ParanodeTrace();
+
+    /**
+     * @brief Trace only every Nth message
+     * @param everyN Sampling interval (1 = every message)
+     */
+    void setSampling(uint16_t everyN);
+
+    /**
+     * @brief Start tracing a message (stage "created")
+     * @param seq Message sequence number
+     */
+    void begin(uint32_t seq);
+
+    /**
+     * @brief Record that a traced message reached a stage
+     * @param seq Message sequence number (0 = untraced, ignored)
+     * @param stage Stage reached
+     */
+    void mark(uint32_t seq, ParanodeTraceStage stage);
+
+    /**
+     * @brief Compute latency percentiles over the ring
+     */
+    void summarize(ParanodeTraceSummary& summary) const;
+
+    /**
+     * @brief Write the ring as Chrome trace-event JSON (chrome://tracing, Perfetto)
+     */
+    void writeChromeTrace(Print& out) const;
+
+    /**
+     * @brief Print a one-line-per-stage summary
+     */
+    void printSummary(Print& out) const;
+
+private:
+    struct Entry {
+        uint32_t seq;
+        uint32_t stamps[PARANODE_TRACE_STAGE_COUNT];
+    };
+
+    Entry _entries[PARANODE_TRACE_SIZE];
+    uint16_t _sampling;
+
+    Entry* find(uint32_t seq);
+    static int previousStage(const Entry& entry, int stage);
+};
+
+#else
+
+// Tracing disabled: same interface, no storage, no code
+class ParanodeTrace {
+public:
+    void setSampling(uint16_t) {}
+    void begin(uint32_t) {}
+    void mark(uint32_t, ParanodeTraceStage) {}
+    void summarize(ParanodeTraceSummary& summary) const { memset(&summary, 0, sizeof(summary)); }
+    void writeChromeTrace(Print&) const {}
+    void printSummary(Print&) const {}
+};
+
+#endif
+
+#endif
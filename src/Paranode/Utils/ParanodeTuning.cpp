@@ -0,0 +1,77 @@
+/**
+ * @file ParanodeTuning.cpp
+ * @brief Bounds and defaults of the runtime tuning parameters
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "ParanodeTuning.h"
+
+struct TuningField {
+    const char* name;
+    uint32_t ParanodeTuning::*field;
+    uint32_t min;
+    uint32_t max;
+};
+
+// Bounds keep a bad push from flooding the server or silencing the device
+static const TuningField FIELDS[] = {
+    {"heartbeatInterval", &ParanodeTuning::heartbeatInterval, 10000, 86400000},
+    {"metricsInterval", &ParanodeTuning::metricsInterval, 10000, 86400000},
+    {"batching", &ParanodeTuning::batching, 0, 1},
+    {"batchSize", &ParanodeTuning::batchSize, 1, PARANODE_MAX_BATCH_SIZE},
+    {"batchInterval", &ParanodeTuning::batchInterval, 100, 3600000},
+    {"maxSendPerLoop", &ParanodeTuning::maxSendPerLoop, 1, PARANODE_QUEUE_SIZE},
+    {"messageTtl", &ParanodeTuning::messageTtl, 1000, 86400000},
+    {"reconnectInterval", &ParanodeTuning::reconnectInterval, 1000, 3600000},
+};
+
+static const size_t FIELD_COUNT = sizeof(FIELDS) / sizeof(FIELDS[0]);
+
+static const TuningField* findField(const char* name) {
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        if (strcmp(FIELDS[i].name, name) == 0) {
+            return &FIELDS[i];
+        }
+    }
+    return nullptr;
+}
+
+ParanodeTuning ParanodeTuning::defaults() {
+    ParanodeTuning tuning;
+    tuning.heartbeatInterval = PARANODE_HEARTBEAT_INTERVAL;
+    tuning.metricsInterval = PARANODE_METRICS_INTERVAL;
+    tuning.batching = 0;
+    tuning.batchSize = 5;
+    tuning.batchInterval = 10000;
+    tuning.maxSendPerLoop = 3;
+    tuning.messageTtl = PARANODE_MESSAGE_TTL;
+    tuning.reconnectInterval = PARANODE_RECONNECT_INTERVAL;
+    return tuning;
+}
+
+ParanodeTuningResult ParanodeTuning::set(const char* name, uint32_t value) {
+    const TuningField* f = name ? findField(name) : nullptr;
+    if (!f) {
+        return PARANODE_TUNING_UNKNOWN;
+    }
+    if (value < f->min || value > f->max) {
+        return PARANODE_TUNING_OUT_OF_RANGE;
+    }
+    this->*(f->field) = value;
+    return PARANODE_TUNING_OK;
+}
+
+bool ParanodeTuning::isField(const char* name) {
+    return name && findField(name) != nullptr;
+}
+
+bool ParanodeTuning::isValid() const {
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        uint32_t value = this->*(FIELDS[i].field);
+        if (value < FIELDS[i].min || value > FIELDS[i].max) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file ParanodeTuning.h
+ * @brief Runtime traffic parameters the server can change through config
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#ifndef PARANODE_TUNING_H
+#define PARANODE_TUNING_H
+
+#include <Arduino.h>
+#include "Paranode/ParanodeConfig.h"
+#include "ParanodeMessageQueue.h"
+
+// Config fields this build understands; reported in auth and config_request
+#define PARANODE_CONFIG_SCHEMA_VERSION 2
+
+#ifndef PARANODE_HEARTBEAT_INTERVAL
+#define PARANODE_HEARTBEAT_INTERVAL 30000
+#endif
+
+#ifndef PARANODE_METRICS_INTERVAL
+#define PARANODE_METRICS_INTERVAL 60000
+#endif
+
+#ifndef PARANODE_RECONNECT_INTERVAL
+#define PARANODE_RECONNECT_INTERVAL 5000
+#endif
+
+// Queued messages older than this are dropped
+#ifndef PARANODE_MESSAGE_TTL
+#define PARANODE_MESSAGE_TTL 300000
+#endif
+
+#define PARANODE_MAX_BATCH_SIZE 10
+
+enum ParanodeTuningResult {
+    PARANODE_TUNING_OK,
+    PARANODE_TUNING_OUT_OF_RANGE,
+    PARANODE_TUNING_UNKNOWN
+};
+
+/**
+ * @struct ParanodeTuning
+ * @brief Every performance-relevant parameter in one value
+ *
+ * Paranode keeps one of these and replaces it as a whole, so a config
+ * message is either applied completely or not at all. The comment on each
+ * field is the config schema version that introduced it.
+ */
+struct ParanodeTuning {
+    uint32_t heartbeatInterval; // 1: ms between heartbeats
+    uint32_t metricsInterval;   // 1: ms between automatic metrics
+    uint32_t batching;          // 2: 1 = queue telemetry and send in batches
+    uint32_t batchSize;         // 2: messages per batch frame
+    uint32_t batchInterval;     // 2: ms between automatic batch flushes
+    uint32_t maxSendPerLoop;    // 2: queued messages sent per loop()
+    uint32_t messageTtl;        // 2: ms before a queued message expires
+    uint32_t reconnectInterval; // 2: base ms between reconnect attempts
+
+    /**
+     * @brief Compiled-in defaults
+     */
+    static ParanodeTuning defaults();
+
+    /**
+     * @brief Set one field by its config name, within its bounds
+     * @return PARANODE_TUNING_OK, or why the value was not taken
+     */
+    ParanodeTuningResult set(const char* name, uint32_t value);
+
+    /**
+     * @brief Check whether a config name is a tuning field
+     */
+    static bool isField(const char* name);
+
+    /**
+     * @brief Check every field against its bounds
+     */
+    bool isValid() const;
+};
+
+#endif
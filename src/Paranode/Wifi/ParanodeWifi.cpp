@@ -54,6 +54,24 @@ String ParanodeWifi::getIPAddress()
     return WiFi.localIP().toString();
 }
 
+size_t ParanodeWifi::getIPAddress(char *buffer, size_t size)
+{
+    if (!buffer || size == 0)
+    {
+        return 0;
+    }
+
+    buffer[0] = '\0';
+    if (!_isConnected)
+    {
+        return 0;
+    }
+
+    IPAddress ip = WiFi.localIP();
+    int length = snprintf(buffer, size, "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+    return length > 0 ? (size_t)length : 0;
+}
+
 bool ParanodeWifi::connectAsync(const char *ssid, const char *password)
 {
     if (WiFi.status() == WL_CONNECTED)
@@ -76,6 +76,14 @@ public:
      */
     String getIPAddress();
 
+    /**
+     * @brief Get the current IP address without allocating
+     * @param buffer Output buffer (16 bytes fits any IPv4 address)
+     * @param size Buffer size
+     * @return Length written, 0 if not connected
+     */
+    size_t getIPAddress(char *buffer, size_t size);
+
 private:
     bool _isConnected;
     bool _isConnecting;
@@ -0,0 +1,18 @@
+/**
+ * @file benchmark_main.cpp
+ * @brief Runs examples/Benchmark on the host
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * The sketch is compiled unchanged; setup() prints the CSV and returns.
+ * Host figures are for comparing library versions on one machine, not for
+ * predicting device timings.
+ */
+
+#include "../../examples/Benchmark/Benchmark.ino"
+
+int main()
+{
+    setup();
+    return 0;
+}
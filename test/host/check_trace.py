@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""Check that a file is a Chrome trace the way ParanodeTrace writes it.
+
+    check_trace.py trace.json [--stages=enqueue,queue,write,ack]
+
+The file must be JSON object format ({"traceEvents": [...]}) holding
+complete ("X") events with integer pid/tid/ts/dur, one thread per traced
+message. A message's stage intervals must follow each other without
+overlapping. With --stages, every listed stage must appear at least once.
+
+Author: Muhammad Daffa
+Date: 2025-10-25
+"""
+
+import argparse
+import json
+import sys
+
+STAGES = ("enqueue", "queue", "write", "ack")
+
+
+def check(trace, required):
+    if not isinstance(trace, dict) or not isinstance(trace.get("traceEvents"), list):
+        return ["not a trace-event object with a traceEvents array"]
+    events = trace["traceEvents"]
+    if not events:
+        return ["no events"]
+
+    errors = []
+    threads = {}
+    for i, event in enumerate(events):
+        if not isinstance(event, dict):
+            errors.append("event %d is not an object" % i)
+            continue
+        count = len(errors)
+        if event.get("ph") != "X":
+            errors.append("event %d: ph is %r, expected complete events (\"X\")" % (i, event.get("ph")))
+        if event.get("name") not in STAGES:
+            errors.append("event %d: unknown stage %r" % (i, event.get("name")))
+        for field in ("pid", "tid", "ts", "dur"):
+            value = event.get(field)
+            if not isinstance(value, int) or isinstance(value, bool) or value < 0:
+                errors.append("event %d: %s is %r, expected a non-negative integer" % (i, field, value))
+        if len(errors) == count:
+            threads.setdefault(event["tid"], []).append(event)
+
+    for tid, stages in threads.items():
+        stages.sort(key=lambda event: STAGES.index(event["name"]))
+        for previous, event in zip(stages, stages[1:]):
+            if event["ts"] < previous["ts"] + previous["dur"]:
+                errors.append("message %d: %s starts before %s ends" % (tid, event["name"], previous["name"]))
+
+    seen = {event.get("name") for event in events if isinstance(event, dict)}
+    for stage in required:
+        if stage not in seen:
+            errors.append("no %s events" % stage)
+    return errors
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Validate a ParanodeTrace Chrome trace")
+    parser.add_argument("trace", help="trace.json written by writeTrace()")
+    parser.add_argument("--stages", default="", help="comma-separated stages that must appear")
+    args = parser.parse_args()
+
+    try:
+        with open(args.trace) as f:
+            trace = json.load(f)
+    except (OSError, ValueError) as error:
+        print("%s: %s" % (args.trace, error), file=sys.stderr)
+        return 1
+
+    required = [stage for stage in args.stages.split(",") if stage]
+    errors = check(trace, required)
+    for error in errors:
+        print("%s: %s" % (args.trace, error), file=sys.stderr)
+    if errors:
+        return 1
+
+    print("%s: %d events, %d messages" % (args.trace, len(trace["traceEvents"]),
+                                          len({event["tid"] for event in trace["traceEvents"]})))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
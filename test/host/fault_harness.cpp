@@ -0,0 +1,57 @@
+/**
+ * @file fault_harness.cpp
+ * @brief Runs a fault scenario against the fleet simulator and checks it
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ *   paranode_fault_harness <scenario.txt> [--devices]
+ *
+ * Prints the fleet summary followed by one "metric,value,limit,result" line
+ * per expectation, and exits 1 if any expectation fails. See
+ * sim/SimScenario.h for the scenario format; test/host/scenarios holds the
+ * ones ctest runs.
+ */
+
+#include "sim/SimScenario.h"
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    bool perDevice = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--devices") == 0) {
+            perDevice = true;
+        } else if (!path) {
+            path = argv[i];
+        } else {
+            fprintf(stderr, "unexpected argument: %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (!path) {
+        fprintf(stderr, "usage: %s <scenario.txt> [--devices]\n", argv[0]);
+        return 2;
+    }
+
+    SimScenario scenario;
+    if (!scenario.load(path)) {
+        fprintf(stderr, "%s: %s\n", path, scenario.error().c_str());
+        return 2;
+    }
+
+    SimFleet fleet(scenario.config());
+    scenario.run(fleet);
+
+    Serial.printf("# scenario %s, %u faults\n", path, (unsigned)scenario.faults().size());
+    fleet.printReport(Serial, perDevice);
+
+    bool passed = true;
+    Serial.println("metric,value,limit,result");
+    for (const SimExpectationResult& result : scenario.evaluate(fleet)) {
+        Serial.printf("%s,%.2f,%s%.2f,%s\n", result.expectation.metric.c_str(), result.value,
+                      result.expectation.atLeast ? ">=" : "<=", result.expectation.limit,
+                      result.passed ? "PASS" : "FAIL");
+        passed = passed && result.passed;
+    }
+    Serial.flush();
+    return passed ? 0 : 1;
+}
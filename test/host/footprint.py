@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+"""Profile table for OPTIMIZATION.md, from per-profile host builds.
+
+    footprint.py --size size --build EXE LIB [--build EXE LIB ...]
+                 [--check OPTIMIZATION.md | --update OPTIMIZATION.md]
+
+Each EXE is footprint_main.cpp built for one PARANODE_PROFILE_* and LIB the
+library built with the same flag. The profile's sizes and sizeof(Paranode)
+come from EXE; code and data sizes are the section totals of LIB as
+reported by size(1). Without --check or --update the table is printed.
+
+The table sits between the footprint markers in OPTIMIZATION.md. --update
+rewrites it. --check fails if the sizes or sizeof(Paranode) differ from
+the document; section sizes depend on the compiler and are not compared.
+
+Author: Muhammad Daffa
+Date: 2025-10-25
+"""
+
+import argparse
+import csv
+import io
+import subprocess
+import sys
+
+BEGIN = "<!-- footprint:begin -->"
+END = "<!-- footprint:end -->"
+HEADER = ("| Profile | Queue | Message | Pool | Batch | Parse doc / scratch | `sizeof(Paranode)` "
+          "| Code (.text) | Data (.data + .bss) |\n"
+          "|---------|-------|---------|------|-------|---------------------|--------------------"
+          "|--------------|---------------------|")
+CHECKED_COLUMNS = 7
+
+
+def profile_row(exe):
+    output = subprocess.run([exe], check=True, capture_output=True, text=True).stdout
+    rows = list(csv.DictReader(io.StringIO(output)))
+    if len(rows) != 1:
+        raise ValueError("%s: expected one CSV row, got %d" % (exe, len(rows)))
+    return rows[0]
+
+
+def sections(size_tool, lib):
+    # Berkeley format with totals: the last line is "text data bss dec hex (TOTALS)"
+    output = subprocess.run([size_tool, "-t", lib], check=True, capture_output=True, text=True).stdout
+    fields = output.strip().splitlines()[-1].split()
+    return int(fields[0]), int(fields[1]) + int(fields[2])
+
+
+def table(size_tool, builds):
+    lines = [HEADER]
+    for exe, lib in builds:
+        row = profile_row(exe)
+        text, data = sections(size_tool, lib)
+        name = "`PARANODE_PROFILE_%s`" % row["profile"].upper()
+        if row["profile"] == "standard":
+            name += " (default)"
+        lines.append("| %s | %s | %s B | %s | %s B | %s / %s B | %s B | %s B | %s B |" % (
+            name, row["queue"], row["message"], row["pool"], row["batch"], row["json_doc"],
+            row["scratch"], row["paranode_bytes"], text, data))
+    return "\n".join(lines)
+
+
+def checked(table_text):
+    rows = []
+    for line in table_text.strip().splitlines()[2:]:
+        rows.append([cell.strip() for cell in line.strip("|").split("|")][:CHECKED_COLUMNS])
+    return rows
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate the footprint profile table")
+    parser.add_argument("--size", required=True, help="size(1) for the host toolchain")
+    parser.add_argument("--build", nargs=2, action="append", required=True, metavar=("EXE", "LIB"))
+    group = parser.add_mutually_exclusive_group()
+    group.add_argument("--check", metavar="DOC", help="fail if DOC's table is out of date")
+    group.add_argument("--update", metavar="DOC", help="rewrite DOC's table")
+    args = parser.parse_args()
+
+    generated = table(args.size, args.build)
+    print(generated)
+
+    path = args.check or args.update
+    if not path:
+        return 0
+    with open(path) as f:
+        doc = f.read()
+    begin = doc.find(BEGIN)
+    end = doc.find(END)
+    if begin < 0 or end < begin:
+        print("%s: no footprint markers" % path, file=sys.stderr)
+        return 1
+    current = doc[begin + len(BEGIN):end]
+
+    if args.update:
+        with open(path, "w") as f:
+            f.write(doc[:begin + len(BEGIN)] + "\n" + generated + "\n" + doc[end:])
+        return 0
+
+    if checked(current) != checked(generated):
+        print("%s: profile table is out of date; rebuild the paranode_footprint_table target" % path,
+              file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,30 @@
+/**
+ * @file footprint_main.cpp
+ * @brief Prints the RAM a footprint profile gives the library
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Built once per PARANODE_PROFILE_* against a library compiled with the same
+ * flag. Prints one CSV row of the profile's sizes and the objects they end
+ * up in:
+ *
+ *   profile,queue,message,pool,batch,json_doc,scratch,queue_bytes,pool_bytes,scratch_bytes,paranode_bytes
+ *
+ * footprint.py collects the rows, adds the library's section sizes and
+ * writes the profile table in OPTIMIZATION.md.
+ */
+
+#include <Paranode.h>
+
+int main() {
+    Serial.println("profile,queue,message,pool,batch,json_doc,scratch,queue_bytes,pool_bytes,scratch_bytes,"
+                   "paranode_bytes");
+    Serial.printf("%s,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n", PARANODE_PROFILE_NAME, (unsigned)PARANODE_QUEUE_SIZE,
+                  (unsigned)PARANODE_MAX_MESSAGE_SIZE, (unsigned)PARANODE_BUFFER_POOL_SIZE,
+                  (unsigned)PARANODE_BATCH_BUFFER_SIZE, (unsigned)PARANODE_JSON_DOC_SIZE,
+                  (unsigned)PARANODE_SCRATCH_SIZE, (unsigned)sizeof(ParanodeMessageQueue),
+                  (unsigned)sizeof(ParanodeBufferPool), (unsigned)sizeof(ParanodeScratch),
+                  (unsigned)sizeof(Paranode));
+    Serial.flush();
+    return 0;
+}
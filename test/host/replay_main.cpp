@@ -0,0 +1,165 @@
+/**
+ * @file replay_main.cpp
+ * @brief Replays a PNC1 capture through Paranode on the host
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ *   paranode_replay [--realtime] [--expect-frames=N] [--expect-commands=N]
+ *                   capture.pnc
+ *
+ * Does what examples/CaptureReplay does on a board: the inbound frames go
+ * through the transport's inject path and the message dispatcher, waiting
+ * for a receive credit like the server would. By default they go in as
+ * fast as possible; --realtime keeps the recorded gaps between frames.
+ * Prints the example's CSV plus the number of commands dispatched:
+ *
+ *   mode,frames,bytes,total_us,frames_per_sec,commands
+ *
+ * Returns non-zero if the file is not a capture, or if the frames replayed
+ * or the commands dispatched differ from the --expect-* counts.
+ */
+
+#include <Paranode.h>
+#include <cstdio>
+
+// A capture file as the Stream ParanodeCaptureReader reads
+class FileStream : public Stream {
+public:
+    explicit FileStream(FILE* file) : _file(file) {}
+
+    int available() override {
+        int c = peek();
+        return c < 0 ? 0 : 1;
+    }
+    int read() override { return fgetc(_file); }
+    int peek() override {
+        int c = fgetc(_file);
+        if (c != EOF) {
+            ungetc(c, _file);
+        }
+        return c;
+    }
+    size_t write(uint8_t) override { return 0; }
+
+private:
+    FILE* _file;
+};
+
+static bool option(const char* arg, const char* name, const char** value) {
+    size_t length = strlen(name);
+    if (strncmp(arg, name, length) != 0) {
+        return false;
+    }
+    if (arg[length] == '=') {
+        *value = arg + length + 1;
+        return true;
+    }
+    *value = "";
+    return arg[length] == '\0';
+}
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    bool realTime = false;
+    long expectFrames = -1;
+    long expectCommands = -1;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = nullptr;
+        if (option(argv[i], "--realtime", &value)) {
+            realTime = true;
+        } else if (option(argv[i], "--expect-frames", &value)) {
+            expectFrames = strtol(value, nullptr, 10);
+        } else if (option(argv[i], "--expect-commands", &value)) {
+            expectCommands = strtol(value, nullptr, 10);
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (!path) {
+        fprintf(stderr, "usage: paranode_replay [--realtime] [--expect-frames=N] [--expect-commands=N] capture.pnc\n");
+        return 2;
+    }
+
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 1;
+    }
+    FileStream in(file);
+    ParanodeCaptureReader reader(in);
+    if (!reader.begin()) {
+        fprintf(stderr, "%s is not a Paranode capture\n", path);
+        fclose(file);
+        return 1;
+    }
+
+    Paranode paranode("replay-token");
+    unsigned long commands = 0;
+    paranode.begin();
+    paranode.onCommand([&commands](const JsonObject& command) { commands++; });
+
+    static char frame[2048];
+    ParanodeCaptureRecord record;
+    unsigned long frames = 0;
+    unsigned long bytes = 0;
+    unsigned long firstTimestamp = 0;
+    unsigned long busyUs = 0;
+    unsigned long replayStart = millis();
+    int length;
+
+    while ((length = reader.next(record, frame, sizeof(frame))) >= 0) {
+        if (record.direction != PARANODE_CAPTURE_INBOUND) {
+            continue;
+        }
+        if (frames == 0) {
+            firstTimestamp = record.timestamp;
+        }
+
+        if (realTime) {
+            // Wait until the frame's original offset from the first frame
+            unsigned long offset = record.timestamp - firstTimestamp;
+            unsigned long elapsed = millis() - replayStart;
+            if (elapsed < offset) {
+                delay(offset - elapsed);
+            }
+        }
+
+        unsigned long start = micros();
+        // Queued commands run, and return their credit, in loop()
+        while (paranode.receiveCredits() == 0) {
+            paranode.loop();
+        }
+        paranode.injectMessage(frame, length);
+        busyUs += micros() - start;
+
+        frames++;
+        bytes += length;
+    }
+    fclose(file);
+
+    // Commands still queued are part of the work
+    unsigned long drainStart = micros();
+    while (paranode.receiveCredits() < PARANODE_RECEIVE_CREDITS) {
+        paranode.loop();
+    }
+    busyUs += micros() - drainStart;
+
+    Serial.println("mode,frames,bytes,total_us,frames_per_sec,commands");
+    Serial.printf("%s,%lu,%lu,%lu,%.1f,%lu\n", realTime ? "realtime" : "fullspeed", frames, bytes, busyUs,
+                  busyUs > 0 ? (frames * 1000000.0) / busyUs : 0.0, commands);
+    Serial.flush();
+
+    if (expectFrames >= 0 && frames != (unsigned long)expectFrames) {
+        fprintf(stderr, "replayed %lu frames, expected %ld\n", frames, expectFrames);
+        return 1;
+    }
+    if (expectCommands >= 0 && commands != (unsigned long)expectCommands) {
+        fprintf(stderr, "dispatched %lu commands, expected %ld\n", commands, expectCommands);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,272 @@
+/**
+ * @file Arduino.h
+ * @brief Minimal Arduino core for building the library on a Linux host
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Just enough of the ESP32 Arduino core (String, Print/Serial, millis/micros,
+ * ESP, FreeRTOS critical sections) for src/ to compile and run unchanged.
+ * The host build defines ESP32, so the library takes its ESP32 paths.
+ *
+ * Host-only controls live in the host namespace:
+ *  - host::useVirtualClock() makes millis()/micros() follow setMillis() and
+ *    advanceMillis() instead of the wall clock, for simulations and tests.
+ *  - host::allocationCount()/liveHeapBytes() count heap use (glibc only);
+ *    ESP.getFreeHeap() reports PARANODE_HOST_HEAP_SIZE minus the live bytes.
+ */
+
+#ifndef PARANODE_HOST_ARDUINO_H
+#define PARANODE_HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <string>
+#include <functional>
+#include <algorithm>
+
+#ifndef PARANODE_HOST_HEAP_SIZE
+#define PARANODE_HOST_HEAP_SIZE 327680
+#endif
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define F(string_literal) (string_literal)
+#define PROGMEM
+#define IRAM_ATTR
+#define RTC_NOINIT_ATTR
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define LED_BUILTIN 2
+
+#define DEC 10
+#define HEX 16
+
+namespace host {
+
+/**
+ * @brief Drive millis()/micros() from a settable clock (starts at 0)
+ */
+void useVirtualClock(bool enable);
+void setMillis(unsigned long ms);
+void advanceMillis(unsigned long ms);
+
+/**
+ * @brief Heap allocations since start, and bytes currently allocated
+ */
+size_t allocationCount();
+size_t liveHeapBytes();
+
+} // namespace host
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+inline void yield() {}
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return LOW; }
+inline int analogRead(uint8_t) { return 0; }
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+char* itoa(int value, char* buffer, int base);
+char* ltoa(long value, char* buffer, int base);
+char* utoa(unsigned value, char* buffer, int base);
+char* ultoa(unsigned long value, char* buffer, int base);
+
+// FreeRTOS pieces used by the ESP32 paths
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+inline void portENTER_CRITICAL(portMUX_TYPE*) {}
+inline void portEXIT_CRITICAL(portMUX_TYPE*) {}
+inline unsigned uxTaskGetStackHighWaterMark(void*) { return 0; }
+
+/**
+ * @class String
+ * @brief Arduino String on top of std::string
+ */
+class String {
+public:
+    String() {}
+    String(const char* s) : _s(s ? s : "") {}
+    String(const char* s, size_t length) : _s(s ? std::string(s, length) : std::string()) {}
+    String(const std::string& s) : _s(s) {}
+    String(char c) : _s(1, c) {}
+    String(int value, unsigned char base = DEC) : _s(format((long)value, base)) {}
+    String(unsigned int value, unsigned char base = DEC) : _s(format((unsigned long)value, base)) {}
+    String(long value, unsigned char base = DEC) : _s(format(value, base)) {}
+    String(unsigned long value, unsigned char base = DEC) : _s(format(value, base)) {}
+    String(float value, unsigned char decimals = 2) : _s(format((double)value, decimals)) {}
+    String(double value, unsigned char decimals = 2) : _s(format(value, decimals)) {}
+
+    const char* c_str() const { return _s.c_str(); }
+    unsigned int length() const { return (unsigned int)_s.size(); }
+    bool isEmpty() const { return _s.empty(); }
+    bool reserve(unsigned int size) { _s.reserve(size); return true; }
+
+    char charAt(unsigned int index) const { return index < _s.size() ? _s[index] : '\0'; }
+    char operator[](unsigned int index) const { return charAt(index); }
+
+    bool equals(const String& other) const { return _s == other._s; }
+    bool operator==(const String& other) const { return _s == other._s; }
+    bool operator==(const char* other) const { return _s == (other ? other : ""); }
+    bool operator!=(const String& other) const { return _s != other._s; }
+    bool operator!=(const char* other) const { return !(*this == other); }
+    bool operator<(const String& other) const { return _s < other._s; }
+
+    String& operator+=(const String& other) { _s += other._s; return *this; }
+    String& operator+=(const char* other) { _s += other ? other : ""; return *this; }
+    String& operator+=(char c) { _s += c; return *this; }
+    bool concat(const String& other) { _s += other._s; return true; }
+
+    friend String operator+(const String& a, const String& b) { return String(a._s + b._s); }
+    friend String operator+(const String& a, const char* b) { return String(a._s + (b ? b : "")); }
+    friend String operator+(const char* a, const String& b) { return String((a ? a : "") + b._s); }
+
+    int indexOf(char c, unsigned int from = 0) const { return find(_s.find(c, from)); }
+    int indexOf(const char* s, unsigned int from = 0) const { return find(_s.find(s, from)); }
+    int lastIndexOf(char c) const { return find(_s.rfind(c)); }
+    bool startsWith(const char* prefix) const { return _s.compare(0, strlen(prefix), prefix) == 0; }
+    bool endsWith(const char* suffix) const {
+        size_t n = strlen(suffix);
+        return _s.size() >= n && _s.compare(_s.size() - n, n, suffix) == 0;
+    }
+
+    String substring(unsigned int from) const { return from < _s.size() ? String(_s.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const {
+        return from < to && from < _s.size() ? String(_s.substr(from, to - from)) : String();
+    }
+
+    long toInt() const { return atol(_s.c_str()); }
+    float toFloat() const { return (float)atof(_s.c_str()); }
+    void trim();
+    void toUpperCase() { std::transform(_s.begin(), _s.end(), _s.begin(), ::toupper); }
+    void toLowerCase() { std::transform(_s.begin(), _s.end(), _s.begin(), ::tolower); }
+
+private:
+    std::string _s;
+
+    static int find(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+    static std::string format(long value, unsigned char base);
+    static std::string format(unsigned long value, unsigned char base);
+    static std::string format(double value, unsigned char decimals);
+};
+
+class IPAddress {
+public:
+    IPAddress() : _octets{0, 0, 0, 0} {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _octets{a, b, c, d} {}
+
+    uint8_t operator[](int index) const { return _octets[index & 3]; }
+    String toString() const;
+
+private:
+    uint8_t _octets[4];
+};
+
+/**
+ * @class Print
+ * @brief Arduino Print; subclasses implement write(uint8_t)
+ */
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+    size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+    virtual void flush() {}
+
+    size_t print(const char* s) { return write(s); }
+    size_t print(const String& s) { return write(s.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value, int base = DEC) { return print((long)value, base); }
+    size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(unsigned long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(long long value) { return printf("%lld", value); }
+    size_t print(unsigned long long value) { return printf("%llu", value); }
+    size_t print(double value, int decimals = 2) { return print(String(value, (unsigned char)decimals)); }
+    size_t print(const IPAddress& ip) { return print(ip.toString()); }
+
+    template<typename T>
+    size_t println(const T& value) { return print(value) + println(); }
+    size_t println(double value, int decimals) { return print(value, decimals) + println(); }
+    size_t println(long value, int base) { return print(value, base) + println(); }
+    size_t println() { return write("\r\n"); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print {
+public:
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual int peek() { return -1; }
+
+    size_t readBytes(uint8_t* buffer, size_t length);
+    size_t readBytes(char* buffer, size_t length) { return readBytes((uint8_t*)buffer, length); }
+};
+
+/**
+ * @class HardwareSerial
+ * @brief Serial on stdout
+ */
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long) {}
+    void end() {}
+    operator bool() const { return true; }
+
+    size_t write(uint8_t c) override { return fwrite(&c, 1, 1, stdout); }
+    size_t write(const uint8_t* buffer, size_t size) override { return fwrite(buffer, 1, size, stdout); }
+    using Print::write;
+    void flush() override { fflush(stdout); }
+};
+
+extern HardwareSerial Serial;
+
+/**
+ * @class EspClass
+ * @brief The ESP object; heap figures come from the host allocation counter
+ */
+class EspClass {
+public:
+    uint32_t getFreeHeap();
+    uint32_t getMaxAllocHeap() { return getFreeHeap(); }
+    uint32_t getHeapSize() { return PARANODE_HOST_HEAP_SIZE; }
+    uint32_t getCycleCount() { return (uint32_t)micros() * 240; }
+    uint32_t getChipId() { return 0x00C0FFEE; }
+    uint32_t getSketchSize() { return 0; }
+    uint32_t getFreeSketchSpace() { return 0; }
+
+    /**
+     * @brief Counts restarts instead of exiting, so tests can observe them
+     */
+    void restart() { _restarts++; }
+    uint32_t restartCount() const { return _restarts; }
+
+private:
+    uint32_t _restarts = 0;
+};
+
+extern EspClass ESP;
+
+#endif
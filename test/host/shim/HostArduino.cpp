@@ -0,0 +1,349 @@
+/**
+ * @file HostArduino.cpp
+ * @brief Globals and helpers behind the host Arduino shim
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <Update.h>
+#include <Preferences.h>
+#include <chrono>
+#include <thread>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+HardwareSerial Serial;
+EspClass ESP;
+WiFiClass WiFi;
+UpdateClass Update;
+
+namespace {
+
+bool virtualClock = false;
+unsigned long virtualMillis = 0;
+unsigned long virtualMicros = 0;
+
+const auto startTime = std::chrono::steady_clock::now();
+
+size_t allocations = 0;
+long liveBytes = 0;
+
+std::string preferenceFile;
+const char PREFERENCE_MAGIC[4] = {'P', 'N', 'V', '1'};
+
+bool readLength(FILE* file, uint32_t* length) {
+    uint8_t bytes[4];
+    if (fread(bytes, 1, 4, file) != 4) {
+        return false;
+    }
+    *length = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+    return true;
+}
+
+void writeLength(FILE* file, uint32_t length) {
+    uint8_t bytes[4] = {(uint8_t)length, (uint8_t)(length >> 8), (uint8_t)(length >> 16), (uint8_t)(length >> 24)};
+    fwrite(bytes, 1, 4, file);
+}
+
+} // namespace
+
+#if defined(__GLIBC__)
+// Count every heap allocation in the process, including operator new,
+// by wrapping glibc's allocator
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size) {
+    void* ptr = __libc_malloc(size);
+    if (ptr) {
+        allocations++;
+        liveBytes += (long)malloc_usable_size(ptr);
+    }
+    return ptr;
+}
+
+void* calloc(size_t count, size_t size) {
+    void* ptr = __libc_calloc(count, size);
+    if (ptr) {
+        allocations++;
+        liveBytes += (long)malloc_usable_size(ptr);
+    }
+    return ptr;
+}
+
+void* realloc(void* ptr, size_t size) {
+    long before = ptr ? (long)malloc_usable_size(ptr) : 0;
+    void* result = __libc_realloc(ptr, size);
+    if (result) {
+        allocations++;
+        liveBytes += (long)malloc_usable_size(result) - before;
+    } else if (size == 0) {
+        liveBytes -= before;
+    }
+    return result;
+}
+
+void free(void* ptr) {
+    if (ptr) liveBytes -= (long)malloc_usable_size(ptr);
+    __libc_free(ptr);
+}
+}
+#endif
+
+namespace host {
+
+void useVirtualClock(bool enable) {
+    virtualClock = enable;
+    virtualMillis = 0;
+    virtualMicros = 0;
+}
+
+void setMillis(unsigned long ms) {
+    virtualMillis = ms;
+    virtualMicros = ms * 1000UL;
+}
+
+void advanceMillis(unsigned long ms) {
+    setMillis(virtualMillis + ms);
+}
+
+size_t allocationCount() {
+    return allocations;
+}
+
+size_t liveHeapBytes() {
+    return liveBytes > 0 ? (size_t)liveBytes : 0;
+}
+
+std::map<std::string, std::vector<uint8_t>>& preferenceStore() {
+    static std::map<std::string, std::vector<uint8_t>> store;
+    return store;
+}
+
+void clearPreferences() {
+    preferenceStore().clear();
+    savePreferences();
+}
+
+bool usePreferenceFile(const char* path) {
+    preferenceFile = path ? path : "";
+    return reloadPreferences();
+}
+
+// File layout: "PNV1", entry count, then per entry a key length, the key, a
+// value length and the value; lengths are 32-bit little-endian
+bool reloadPreferences() {
+    std::map<std::string, std::vector<uint8_t>>& store = preferenceStore();
+    store.clear();
+    if (preferenceFile.empty()) {
+        return true;
+    }
+
+    FILE* file = fopen(preferenceFile.c_str(), "rb");
+    if (!file) {
+        return true; // Never written: erased flash
+    }
+    std::map<std::string, std::vector<uint8_t>> loaded;
+    char magic[4];
+    uint32_t entries = 0;
+    bool ok = fread(magic, 1, 4, file) == 4 && memcmp(magic, PREFERENCE_MAGIC, 4) == 0 &&
+              readLength(file, &entries);
+    for (uint32_t i = 0; ok && i < entries; i++) {
+        uint32_t keyLength = 0;
+        uint32_t valueLength = 0;
+        std::string key;
+        std::vector<uint8_t> value;
+        ok = readLength(file, &keyLength) && keyLength <= 256;
+        if (ok) {
+            key.resize(keyLength);
+            ok = fread(&key[0], 1, keyLength, file) == keyLength && readLength(file, &valueLength) &&
+                 valueLength <= 65536;
+        }
+        if (ok) {
+            value.resize(valueLength);
+            ok = fread(value.data(), 1, valueLength, file) == valueLength;
+        }
+        if (ok) {
+            loaded[key] = value;
+        }
+    }
+    ok = ok && fgetc(file) == EOF;
+    fclose(file);
+
+    if (ok) {
+        store.swap(loaded);
+    }
+    return ok;
+}
+
+void savePreferences() {
+    if (preferenceFile.empty()) {
+        return;
+    }
+    FILE* file = fopen(preferenceFile.c_str(), "wb");
+    if (!file) {
+        return;
+    }
+    const std::map<std::string, std::vector<uint8_t>>& store = preferenceStore();
+    fwrite(PREFERENCE_MAGIC, 1, 4, file);
+    writeLength(file, (uint32_t)store.size());
+    for (const auto& entry : store) {
+        writeLength(file, (uint32_t)entry.first.size());
+        fwrite(entry.first.data(), 1, entry.first.size(), file);
+        writeLength(file, (uint32_t)entry.second.size());
+        fwrite(entry.second.data(), 1, entry.second.size(), file);
+    }
+    fclose(file);
+}
+
+} // namespace host
+
+unsigned long millis() {
+    if (virtualClock) return virtualMillis;
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+}
+
+unsigned long micros() {
+    if (virtualClock) return virtualMicros;
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+}
+
+void delay(unsigned long ms) {
+    if (virtualClock) {
+        host::advanceMillis(ms);
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us) {
+    if (virtualClock) {
+        virtualMicros += us;
+        virtualMillis = virtualMicros / 1000UL;
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+long random(long max) {
+    return max > 0 ? ::random() % max : 0;
+}
+
+long random(long min, long max) {
+    return max > min ? min + random(max - min) : min;
+}
+
+void randomSeed(unsigned long seed) {
+    srandom((unsigned)seed);
+}
+
+static char* formatInteger(unsigned long value, bool negative, char* buffer, int base) {
+    char digits[sizeof(unsigned long) * 8 + 1];
+    size_t length = 0;
+    do {
+        unsigned digit = (unsigned)(value % (unsigned)base);
+        digits[length++] = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+        value /= (unsigned)base;
+    } while (value);
+
+    char* out = buffer;
+    if (negative) *out++ = '-';
+    while (length) *out++ = digits[--length];
+    *out = '\0';
+    return buffer;
+}
+
+char* ltoa(long value, char* buffer, int base) {
+    bool negative = value < 0 && base == 10;
+    unsigned long magnitude = negative ? 0UL - (unsigned long)value : (unsigned long)value;
+    return formatInteger(magnitude, negative, buffer, base);
+}
+
+char* itoa(int value, char* buffer, int base) {
+    return ltoa(value, buffer, base);
+}
+
+char* ultoa(unsigned long value, char* buffer, int base) {
+    return formatInteger(value, false, buffer, base);
+}
+
+char* utoa(unsigned value, char* buffer, int base) {
+    return formatInteger(value, false, buffer, base);
+}
+
+std::string String::format(long value, unsigned char base) {
+    char buffer[sizeof(long) * 8 + 2];
+    return ltoa(value, buffer, base);
+}
+
+std::string String::format(unsigned long value, unsigned char base) {
+    char buffer[sizeof(long) * 8 + 2];
+    return ultoa(value, buffer, base);
+}
+
+std::string String::format(double value, unsigned char decimals) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+    return buffer;
+}
+
+void String::trim() {
+    size_t first = _s.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) {
+        _s.clear();
+        return;
+    }
+    _s = _s.substr(first, _s.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+String IPAddress::toString() const {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", _octets[0], _octets[1], _octets[2], _octets[3]);
+    return buffer;
+}
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t written = 0;
+    while (written < size && write(buffer[written])) written++;
+    return written;
+}
+
+size_t Print::printf(const char* format, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0) return 0;
+    if ((size_t)length < sizeof(buffer)) return write((const uint8_t*)buffer, length);
+
+    std::string large((size_t)length + 1, '\0');
+    va_start(args, format);
+    vsnprintf(&large[0], large.size(), format, args);
+    va_end(args);
+    return write((const uint8_t*)large.data(), (size_t)length);
+}
+
+size_t Stream::readBytes(uint8_t* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = read();
+        if (c < 0) break;
+        buffer[count++] = (uint8_t)c;
+    }
+    return count;
+}
+
+uint32_t EspClass::getFreeHeap() {
+    size_t live = host::liveHeapBytes();
+    return live < PARANODE_HOST_HEAP_SIZE ? (uint32_t)(PARANODE_HOST_HEAP_SIZE - live) : 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file Preferences.h
+ * @brief Host stand-in for ESP32 Preferences (NVS)
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Kept in memory, and with host::usePreferenceFile() also in a file that is
+ * rewritten on every change, so a test can power-cycle a device by
+ * reloading the file into a new instance.
+ */
+
+#ifndef PARANODE_HOST_PREFERENCES_H
+#define PARANODE_HOST_PREFERENCES_H
+
+#include <Arduino.h>
+#include <map>
+#include <vector>
+
+namespace host {
+
+/**
+ * @brief Erase every namespace, as a flash wipe would
+ */
+void clearPreferences();
+
+/**
+ * @brief Back the preferences with a file, and load it
+ * @param path File to load now and rewrite on every change; nullptr keeps
+ *        the preferences in memory only
+ * @return False if the file exists but is not a preference file; it is then
+ *         treated as erased flash
+ */
+bool usePreferenceFile(const char* path);
+
+/**
+ * @brief Drop what is in memory and load the file again, as a reboot would
+ * @return As usePreferenceFile()
+ */
+bool reloadPreferences();
+
+/**
+ * @brief Write the store to the file, if there is one
+ */
+void savePreferences();
+
+std::map<std::string, std::vector<uint8_t>>& preferenceStore();
+
+} // namespace host
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false) {
+        _prefix = std::string(name) + "/";
+        _readOnly = readOnly;
+        return true;
+    }
+    void end() {}
+
+    size_t getBytes(const char* key, void* buffer, size_t length) {
+        auto it = host::preferenceStore().find(_prefix + key);
+        if (it == host::preferenceStore().end()) return 0;
+        size_t count = std::min(length, it->second.size());
+        memcpy(buffer, it->second.data(), count);
+        return count;
+    }
+    size_t getBytesLength(const char* key) {
+        auto it = host::preferenceStore().find(_prefix + key);
+        return it == host::preferenceStore().end() ? 0 : it->second.size();
+    }
+    size_t putBytes(const char* key, const void* value, size_t length) {
+        if (_readOnly) return 0;
+        const uint8_t* bytes = static_cast<const uint8_t*>(value);
+        host::preferenceStore()[_prefix + key].assign(bytes, bytes + length);
+        host::savePreferences();
+        return length;
+    }
+    bool remove(const char* key) {
+        if (_readOnly || host::preferenceStore().erase(_prefix + key) == 0) return false;
+        host::savePreferences();
+        return true;
+    }
+
+private:
+    std::string _prefix;
+    bool _readOnly = false;
+};
+
+#endif
@@ -0,0 +1,49 @@
+/**
+ * @file Update.h
+ * @brief Host stand-in for the ESP32 Update object
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Counts the bytes written; end() succeeds when the announced size arrived.
+ */
+
+#ifndef PARANODE_HOST_UPDATE_H
+#define PARANODE_HOST_UPDATE_H
+
+#include <Arduino.h>
+
+#define UPDATE_SIZE_UNKNOWN 0xFFFFFFFF
+
+class UpdateClass {
+public:
+    bool begin(size_t size) {
+        _size = size;
+        _written = 0;
+        _active = true;
+        return true;
+    }
+    size_t write(uint8_t*, size_t length) {
+        if (!_active) return 0;
+        _written += length;
+        return length;
+    }
+    bool end(bool evenIfRemaining = false) {
+        bool ok = _active && (evenIfRemaining || _size == UPDATE_SIZE_UNKNOWN || _written == _size);
+        _active = false;
+        return ok;
+    }
+    void abort() { _active = false; }
+    bool isRunning() const { return _active; }
+    bool hasError() const { return false; }
+    uint8_t getError() const { return 0; }
+    size_t progress() const { return _written; }
+
+private:
+    size_t _size = 0;
+    size_t _written = 0;
+    bool _active = false;
+};
+
+extern UpdateClass Update;
+
+#endif
@@ -0,0 +1,53 @@
+/**
+ * @file WebSocketsClient.h
+ * @brief Host stand-in for arduinoWebSockets' client
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Never connects and accepts every send. Simulations and tests drive
+ * BasicParanode through their own Transport instead of ParanodeSocket.
+ */
+
+#ifndef PARANODE_HOST_WEBSOCKETS_CLIENT_H
+#define PARANODE_HOST_WEBSOCKETS_CLIENT_H
+
+#include <Arduino.h>
+
+#define WEBSOCKETS_MAX_HEADER_SIZE (14)
+
+typedef enum {
+    WStype_ERROR,
+    WStype_DISCONNECTED,
+    WStype_CONNECTED,
+    WStype_TEXT,
+    WStype_BIN,
+    WStype_PING,
+    WStype_PONG
+} WStype_t;
+
+class WebSocketsClient {
+public:
+    typedef std::function<void(WStype_t type, uint8_t* payload, size_t length)> WebSocketClientEvent;
+
+    void begin(const char*, uint16_t, const char* = "/", const char* = "arduino") {}
+    void beginSSL(const char*, uint16_t, const char* = "/", const char* = "", const char* = "arduino") {}
+    void onEvent(WebSocketClientEvent callback) { _event = callback; }
+    void setReconnectInterval(unsigned long) {}
+    void setExtraHeaders(const char* = nullptr) {}
+    void enableHeartbeat(uint32_t, uint32_t, uint8_t) {}
+    void disconnect() {}
+    void loop() {}
+    bool isConnected() { return false; }
+
+    bool sendTXT(uint8_t*, size_t = 0, bool = false) { return true; }
+    bool sendTXT(const uint8_t*, size_t = 0) { return true; }
+    bool sendTXT(char*, size_t = 0, bool = false) { return true; }
+    bool sendTXT(const char*, size_t = 0) { return true; }
+    bool sendTXT(String&) { return true; }
+    bool sendBIN(const uint8_t*, size_t) { return true; }
+
+private:
+    WebSocketClientEvent _event;
+};
+
+#endif
@@ -0,0 +1,50 @@
+/**
+ * @file WiFi.h
+ * @brief Host stand-in for the ESP32 WiFi object
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * The station is connected by default; simulations flip it with
+ * WiFi.setStatus() to model access point loss.
+ */
+
+#ifndef PARANODE_HOST_WIFI_H
+#define PARANODE_HOST_WIFI_H
+
+#include <Arduino.h>
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+#define WIFI_OFF 0
+#define WIFI_STA 1
+
+class WiFiClass {
+public:
+    wl_status_t status() const { return _status; }
+    void setStatus(wl_status_t status) { _status = status; }
+
+    void mode(int) {}
+    void begin(const char*, const char* = nullptr) { _status = WL_CONNECTED; }
+    void disconnect(bool = false) { _status = WL_DISCONNECTED; }
+
+    IPAddress localIP() const { return IPAddress(10, 0, 0, 2); }
+    String macAddress() const { return "02:00:00:00:00:01"; }
+    String SSID() const { return "host"; }
+    int RSSI() const { return _rssi; }
+    void setRSSI(int rssi) { _rssi = rssi; }
+
+private:
+    wl_status_t _status = WL_CONNECTED;
+    int _rssi = -50;
+};
+
+extern WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,39 @@
+/**
+ * @file esp_ota_ops.h
+ * @brief Host stand-in for the ESP-IDF OTA partition API
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * The running partition reads back as zeroes, so delta patches in tests
+ * should be built against an all-zero base image.
+ */
+
+#ifndef PARANODE_HOST_ESP_OTA_OPS_H
+#define PARANODE_HOST_ESP_OTA_OPS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+typedef int esp_err_t;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+
+typedef struct {
+    uint32_t address;
+    uint32_t size;
+} esp_partition_t;
+
+inline const esp_partition_t* esp_ota_get_running_partition() {
+    static const esp_partition_t running = {0x10000, 0x140000};
+    return &running;
+}
+
+inline esp_err_t esp_partition_read(const esp_partition_t* partition, size_t offset, void* dst, size_t size) {
+    if (offset + size > partition->size) return ESP_FAIL;
+    memset(dst, 0, size);
+    return ESP_OK;
+}
+
+#endif
@@ -0,0 +1,212 @@
+/**
+ * @file MockServer.cpp
+ * @brief Paranode server model for the host simulations
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "MockServer.h"
+
+static const char SESSION_HEADER[] = "X-Paranode-Session: ";
+
+MockServer::MockServer(SimNetwork& network, const MockServerConfig& config)
+    : _network(network), _config(config), _acceptWindow(0), _acceptsInWindow(0), _commandCounter(0) {
+    _network.setServer(this);
+}
+
+MockServer::Connection& MockServer::connection(int device) {
+    if ((size_t)device >= _connections.size()) {
+        _connections.resize(device + 1);
+    }
+    return _connections[device];
+}
+
+MockDeviceRecord& MockServer::record(int device) {
+    if ((size_t)device >= _records.size()) {
+        _records.resize(device + 1);
+    }
+    return _records[device];
+}
+
+void MockServer::revokeSessions() {
+    for (Connection& conn : _connections) {
+        conn.sessionToken.clear();
+    }
+}
+
+bool MockServer::accept(SimLink& link, const std::string& headers, unsigned long now) {
+    MockDeviceRecord& rec = record(link.device());
+
+    if (_config.acceptsPerSecond > 0) {
+        if (now / 1000 != _acceptWindow) {
+            _acceptWindow = now / 1000;
+            _acceptsInWindow = 0;
+        }
+        if (_acceptsInWindow >= _config.acceptsPerSecond) {
+            rec.refused++;
+            return false;
+        }
+        _acceptsInWindow++;
+    }
+
+    Connection& conn = connection(link.device());
+    std::string token = conn.sessionToken;
+    conn = Connection();
+    conn.sessionToken = token;
+    conn.open = true;
+    conn.nextCommand = now;
+
+    size_t header = headers.find(SESSION_HEADER);
+    if (header != std::string::npos) {
+        size_t start = header + sizeof(SESSION_HEADER) - 1;
+        std::string presented = headers.substr(start, headers.find('\r', start) - start);
+        if (_config.resumeSessions && !token.empty() && presented == token) {
+            conn.authenticated = true;
+            rec.resumed++;
+        } else {
+            conn.tokenRejected = true;
+        }
+    }
+    rec.connects++;
+    return true;
+}
+
+void MockServer::opened(SimLink& link, unsigned long now) {
+    Connection& conn = connection(link.device());
+    if (conn.tokenRejected) {
+        // The device believes it is authenticated; send it back to auth_token
+        reply(link, "{\"type\":\"auth_token_response\",\"success\":false,\"error\":\"session expired\"}");
+    }
+}
+
+void MockServer::closed(SimLink& link, unsigned long now) {
+    Connection& conn = connection(link.device());
+    conn.open = false;
+    conn.authenticated = false;
+    // Commands in flight are answered on a later connection, or not at all
+}
+
+bool MockServer::reply(SimLink& link, const char* frame, bool counted) {
+    size_t length = strlen(frame);
+    if (!link.sendToDevice(frame, length)) {
+        return false;
+    }
+    if (counted) {
+        Connection& conn = connection(link.device());
+        conn.sentMessages++;
+        conn.sentBytes += length;
+    }
+    return true;
+}
+
+void MockServer::receive(SimLink& link, const std::string& frame, bool binary, unsigned long now) {
+    MockDeviceRecord& rec = record(link.device());
+    rec.frames++;
+    rec.bytes += frame.size();
+    if (binary) {
+        return;
+    }
+
+    DynamicJsonDocument doc(frame.size() * 4 + 1024);
+    if (deserializeJson(doc, frame.data(), frame.size())) {
+        return;
+    }
+
+    // Bulk frames are plain arrays of messages
+    if (doc.is<JsonArray>()) {
+        for (JsonVariant item : doc.as<JsonArray>()) {
+            handle(link, item.as<JsonObject>(), now);
+        }
+    } else {
+        handle(link, doc.as<JsonObject>(), now);
+    }
+}
+
+void MockServer::handle(SimLink& link, JsonObject message, unsigned long now) {
+    int device = link.device();
+    MockDeviceRecord& rec = record(device);
+    Connection& conn = connection(device);
+    const char* type = message["type"] | "";
+
+    if (strcmp(type, "auth_token") == 0) {
+        rec.handshakes++;
+        conn.authenticated = true;
+        conn.sessionGeneration++;
+        char token[48];
+        snprintf(token, sizeof(token), "s%d-%u", device, (unsigned)conn.sessionGeneration);
+        conn.sessionToken = token;
+
+        char response[160];
+        snprintf(response, sizeof(response),
+                 "{\"type\":\"auth_token_response\",\"success\":true,\"deviceId\":\"sim-%d\",\"sessionToken\":\"%s\"}",
+                 device, token);
+        reply(link, response);
+    } else if (strcmp(type, "telemetry") == 0) {
+        uint32_t seq = message["seq"] | 0U;
+        unsigned long timestamp = message["timestamp"] | 0UL;
+        rec.telemetry++;
+        if (!rec.seen.insert(seq).second) {
+            rec.duplicates++;
+            return;
+        }
+        rec.latencies.push_back(now >= timestamp ? (uint32_t)(now - timestamp) : 0);
+        if (_config.ackTelemetry) {
+            char ack[48];
+            snprintf(ack, sizeof(ack), "{\"type\":\"ack\",\"seq\":%u}", (unsigned)seq);
+            reply(link, ack);
+        }
+    } else if (strcmp(type, "credits") == 0) {
+        conn.granted = true;
+        conn.grantMessages = message["messages"] | 0U;
+        conn.grantBytes = message["bytes"] | 0U;
+    } else if (strcmp(type, "command_response") == 0) {
+        const char* id = message["commandId"] | "";
+        auto it = conn.pending.find(id);
+        if (it != conn.pending.end()) {
+            rec.commandResponses++;
+            rec.commandLatencies.push_back((uint32_t)(now - it->second));
+            conn.pending.erase(it);
+        }
+    }
+}
+
+void MockServer::tick(unsigned long now) {
+    if (_config.commandsPerMinute == 0) {
+        return;
+    }
+    unsigned long interval = 60000UL / _config.commandsPerMinute;
+
+    for (size_t device = 0; device < _network.size(); device++) {
+        Connection& conn = connection((int)device);
+        if (!conn.open || !conn.authenticated || (long)(now - conn.nextCommand) < 0) {
+            continue;
+        }
+        sendCommand(_network.link((int)device), now);
+        conn.nextCommand += interval;
+        if ((long)(now - conn.nextCommand) > 0) {
+            conn.nextCommand = now + interval;
+        }
+    }
+}
+
+void MockServer::sendCommand(SimLink& link, unsigned long now) {
+    Connection& conn = connection(link.device());
+    MockDeviceRecord& rec = record(link.device());
+
+    char id[24];
+    snprintf(id, sizeof(id), "c%u", (unsigned)++_commandCounter);
+    char frame[128];
+    int length = snprintf(frame, sizeof(frame),
+                          "{\"type\":\"command\",\"command\":{\"id\":\"%s\",\"action\":\"ping\"}}", id);
+
+    // Within the device's receive credits only
+    if (!conn.granted || conn.sentMessages + 1 > conn.grantMessages ||
+        conn.sentBytes + (uint32_t)length > conn.grantBytes) {
+        rec.creditStalls++;
+        return;
+    }
+    if (reply(link, frame)) {
+        conn.pending[id] = now;
+        rec.commandsSent++;
+    }
+}
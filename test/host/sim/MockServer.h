@@ -0,0 +1,106 @@
+/**
+ * @file MockServer.h
+ * @brief Paranode server model for the host simulations
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Speaks enough of the protocol to keep devices running: token auth and
+ * session resume, receive credits, commands and their responses. Every
+ * telemetry message is recorded once per (device, seq) so delivery,
+ * duplicates and end-to-end latency can be reported.
+ */
+
+#ifndef PARANODE_MOCK_SERVER_H
+#define PARANODE_MOCK_SERVER_H
+
+#include <ArduinoJson.h>
+#include <map>
+#include <unordered_set>
+#include "SimNetwork.h"
+
+/**
+ * @struct MockServerConfig
+ * @brief Server behaviour shared by all devices
+ */
+struct MockServerConfig {
+    uint32_t acceptsPerSecond = 0;   // Upgrades accepted per second, 0 for no limit
+    uint32_t commandsPerMinute = 0;  // Commands sent to each authenticated device
+    bool resumeSessions = true;      // Honour X-Paranode-Session on reconnect
+    bool ackTelemetry = false;       // Answer telemetry with {"type":"ack","seq":N}
+};
+
+/**
+ * @struct MockDeviceRecord
+ * @brief What the server saw from one device
+ */
+struct MockDeviceRecord {
+    uint32_t frames = 0;
+    uint32_t bytes = 0;
+    uint32_t telemetry = 0;        // Telemetry messages, duplicates included
+    uint32_t duplicates = 0;
+    uint32_t connects = 0;
+    uint32_t refused = 0;          // Upgrades turned away by acceptsPerSecond
+    uint32_t handshakes = 0;       // Full auth_token exchanges
+    uint32_t resumed = 0;          // Connections authenticated by session token
+    uint32_t commandsSent = 0;
+    uint32_t commandResponses = 0;
+    uint32_t creditStalls = 0;     // Commands held back for lack of credit
+    std::vector<uint32_t> latencies;        // Telemetry, build to arrival (ms)
+    std::vector<uint32_t> commandLatencies; // Command round trips (ms)
+    std::unordered_set<uint32_t> seen;
+};
+
+class MockServer : public SimServer {
+public:
+    MockServer(SimNetwork& network, const MockServerConfig& config);
+
+    MockServerConfig& config() { return _config; }
+    const MockDeviceRecord& record(int device) const { return _records[device]; }
+
+    /**
+     * @brief Send commands that are due
+     */
+    void tick(unsigned long now);
+
+    /**
+     * @brief Forget issued session tokens, as after a server-side flush
+     */
+    void revokeSessions();
+
+    bool accept(SimLink& link, const std::string& headers, unsigned long now) override;
+    void opened(SimLink& link, unsigned long now) override;
+    void receive(SimLink& link, const std::string& frame, bool binary, unsigned long now) override;
+    void closed(SimLink& link, unsigned long now) override;
+
+private:
+    struct Connection {
+        bool open = false;
+        bool authenticated = false;
+        bool tokenRejected = false;
+        bool granted = false;
+        uint32_t sentMessages = 0;
+        uint32_t sentBytes = 0;
+        uint32_t grantMessages = 0;
+        uint32_t grantBytes = 0;
+        unsigned long nextCommand = 0;
+        uint32_t sessionGeneration = 0;
+        std::string sessionToken;
+        std::map<std::string, unsigned long> pending;  // Command ID to send time
+    };
+
+    SimNetwork& _network;
+    MockServerConfig _config;
+    std::vector<MockDeviceRecord> _records;
+    std::vector<Connection> _connections;
+    unsigned long _acceptWindow;
+    uint32_t _acceptsInWindow;
+    uint32_t _commandCounter;
+
+    Connection& connection(int device);
+    MockDeviceRecord& record(int device);
+    bool reply(SimLink& link, const char* frame, bool counted = true);
+    void handle(SimLink& link, JsonObject message, unsigned long now);
+    void sendCommand(SimLink& link, unsigned long now);
+};
+
+#endif
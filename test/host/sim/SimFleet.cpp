@@ -0,0 +1,191 @@
+/**
+ * @file SimFleet.cpp
+ * @brief Many BasicParanode devices on one simulated network and clock
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "SimFleet.h"
+#include <Preferences.h>
+#include <algorithm>
+#include <random>
+
+SimFleet::SimFleet(const SimFleetConfig& config)
+    : _config(config), _network(config.seed), _server(_network, config.server), _nextStorm(0), _now(0) {
+    host::useVirtualClock(true);
+    host::clearPreferences();
+    std::sort(_config.storms.begin(), _config.storms.end());
+
+    std::mt19937 random(config.seed);
+    unsigned long interval = _config.workload.telemetryPerMinute > 0
+                                 ? 60000UL / _config.workload.telemetryPerMinute
+                                 : 0;
+
+    _devices.resize(_config.devices);
+    for (size_t i = 0; i < _devices.size(); i++) {
+        Device& device = _devices[i];
+        char token[32];
+        snprintf(token, sizeof(token), "sim-token-%u", (unsigned)i);
+        SimTransport::attachNext(&_network.addLink(_config.link));
+        device.paranode.reset(new SimParanode(token));
+
+        if (_config.bootSpreadMs > 0) {
+            device.bootAt = std::uniform_int_distribution<unsigned long>(0, _config.bootSpreadMs)(random);
+        }
+        // Readings are spread over the interval, not all on the same tick
+        device.nextReading = device.bootAt +
+                             (interval > 0 ? std::uniform_int_distribution<unsigned long>(0, interval - 1)(random) : 0);
+    }
+}
+
+SimFleet::~SimFleet() {
+    host::useVirtualClock(false);
+}
+
+void SimFleet::setWifi(size_t index, bool up) {
+    _devices[index].wifiUp = up;
+    if (!up) {
+        _network.link((int)index).drop();
+    }
+}
+
+void SimFleet::run() {
+    runUntil(_config.durationMs + _config.drainMs);
+}
+
+void SimFleet::runUntil(unsigned long end) {
+    while (_now < end) {
+        tick();
+        _now += _config.tickMs;
+    }
+}
+
+void SimFleet::tick() {
+    host::setMillis(_now);
+
+    while (_nextStorm < _config.storms.size() && _config.storms[_nextStorm] <= _now) {
+        _network.dropAll();
+        _nextStorm++;
+    }
+
+    _network.deliver(_now);
+    _server.tick(_now);
+
+    unsigned long interval = _config.workload.telemetryPerMinute > 0
+                                 ? 60000UL / _config.workload.telemetryPerMinute
+                                 : 0;
+
+    for (size_t i = 0; i < _devices.size(); i++) {
+        Device& device = _devices[i];
+        if (_now < device.bootAt) {
+            continue;
+        }
+        WiFi.setStatus(device.wifiUp ? WL_CONNECTED : WL_DISCONNECTED);
+        SimParanode& paranode = *device.paranode;
+
+        if (!device.booted) {
+            char mac[18];
+            snprintf(mac, sizeof(mac), "02:00:00:%02X:%02X:%02X", (unsigned)((i >> 16) & 0xFF),
+                     (unsigned)((i >> 8) & 0xFF), (unsigned)(i & 0xFF));
+            paranode.setMacAddress(mac);
+            paranode.setBatching(_config.workload.batching, _config.workload.batchSize);
+            paranode.onCommand([&paranode](const JsonObject& command) {
+                paranode.sendCommandResponse(command["id"] | "", "success");
+            });
+            paranode.begin();
+            paranode.connect();
+            device.booted = true;
+        }
+
+        while (interval > 0 && _now < _config.durationMs && (long)(_now - device.nextReading) >= 0) {
+            paranode.sendData<int>("reading", (int)device.generated, "", _config.workload.useQueue);
+            device.generated++;
+            device.nextReading += interval;
+        }
+
+        paranode.loop();
+
+        size_t depth = paranode.getQueuedCount();
+        device.peakQueue = std::max(device.peakQueue, depth);
+        device.queueSum += depth;
+        device.queueSamples++;
+    }
+}
+
+SimDeviceReport SimFleet::report(size_t index) const {
+    const Device& device = _devices[index];
+    const MockDeviceRecord& record = _server.record((int)index);
+    SimDeviceReport report;
+
+    report.generated = device.generated;
+    report.delivered = (uint32_t)record.seen.size();
+    report.duplicates = record.duplicates;
+    report.throughput = _config.durationMs > 0 ? report.delivered * 1000.0f / _config.durationMs : 0;
+    report.latencyP50 = percentile(record.latencies, 0.50f);
+    report.latencyP95 = percentile(record.latencies, 0.95f);
+    report.latencyP99 = percentile(record.latencies, 0.99f);
+    report.latencyMax = percentile(record.latencies, 1.0f);
+    report.peakQueue = device.peakQueue;
+    report.meanQueue = device.queueSamples > 0 ? (float)device.queueSum / device.queueSamples : 0;
+    report.connects = record.connects;
+    report.handshakes = record.handshakes;
+    report.resumed = record.resumed;
+    report.refused = record.refused;
+    report.commandsSent = record.commandsSent;
+    report.commandResponses = record.commandResponses;
+    report.commandP50 = percentile(record.commandLatencies, 0.50f);
+    report.stats = device.paranode->getStats();
+    return report;
+}
+
+uint32_t SimFleet::percentile(std::vector<uint32_t> values, float p) {
+    if (values.empty()) {
+        return 0;
+    }
+    size_t rank = (size_t)(p * (values.size() - 1) + 0.5f);
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+SimFleetTotals SimFleet::totals() const {
+    SimFleetTotals totals;
+    for (size_t i = 0; i < _devices.size(); i++) {
+        const MockDeviceRecord& record = _server.record((int)i);
+        totals.generated += _devices[i].generated;
+        totals.delivered += record.seen.size();
+        totals.duplicates += record.duplicates;
+        totals.connects += record.connects;
+        totals.refused += record.refused;
+        totals.commandsSent += record.commandsSent;
+        totals.commandResponses += record.commandResponses;
+        totals.lostFrames += _network.link((int)i).lostFrames();
+        totals.peakQueue = std::max(totals.peakQueue, _devices[i].peakQueue);
+        totals.latencies.insert(totals.latencies.end(), record.latencies.begin(), record.latencies.end());
+    }
+    return totals;
+}
+
+void SimFleet::printReport(Print& out, bool perDevice) const {
+    if (perDevice) {
+        out.println("device,generated,delivered,duplicates,msgs_per_s,p50_ms,p95_ms,p99_ms,max_ms,"
+                    "peak_queue,mean_queue,connects,handshakes,resumed,refused,commands,cmd_p50_ms,failed,dropped,expired");
+        for (size_t i = 0; i < _devices.size(); i++) {
+            SimDeviceReport r = report(i);
+            out.printf("%u,%u,%u,%u,%.2f,%u,%u,%u,%u,%u,%.1f,%u,%u,%u,%u,%u,%u,%u,%u,%u\n", (unsigned)i, r.generated,
+                       r.delivered, r.duplicates, r.throughput, r.latencyP50, r.latencyP95, r.latencyP99,
+                       r.latencyMax, (unsigned)r.peakQueue, r.meanQueue, r.connects, r.handshakes, r.resumed,
+                       r.refused, r.commandResponses, r.commandP50, r.stats.failed, r.stats.dropped, r.stats.expired);
+        }
+    }
+
+    SimFleetTotals t = totals();
+    out.printf("# fleet,devices,%u,generated,%llu,delivered,%llu,delivery_pct,%.2f,duplicates,%llu,lost_frames,%llu\n",
+               (unsigned)_devices.size(), (unsigned long long)t.generated, (unsigned long long)t.delivered,
+               t.generated > 0 ? t.delivered * 100.0 / t.generated : 100.0, (unsigned long long)t.duplicates,
+               (unsigned long long)t.lostFrames);
+    out.printf("# fleet,msgs_per_s,%.1f,p50_ms,%u,p95_ms,%u,p99_ms,%u,max_ms,%u,peak_queue,%u,connects,%llu,refused,%llu\n",
+               _config.durationMs > 0 ? t.delivered * 1000.0 / _config.durationMs : 0.0,
+               percentile(t.latencies, 0.50f), percentile(t.latencies, 0.95f), percentile(t.latencies, 0.99f),
+               percentile(t.latencies, 1.0f), (unsigned)t.peakQueue, (unsigned long long)t.connects,
+               (unsigned long long)t.refused);
+}
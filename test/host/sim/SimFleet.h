@@ -0,0 +1,149 @@
+/**
+ * @file SimFleet.h
+ * @brief Many BasicParanode devices on one simulated network and clock
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Each tick advances the host virtual clock, delivers due frames, lets the
+ * server send commands, then runs every device's workload and loop().
+ * Devices share the process, so WiFi.status() is set per device before its
+ * loop() to model each station separately.
+ */
+
+#ifndef PARANODE_SIM_FLEET_H
+#define PARANODE_SIM_FLEET_H
+
+#include "SimTransport.h"
+#include "MockServer.h"
+
+/**
+ * @struct SimWorkload
+ * @brief What every device does
+ */
+struct SimWorkload {
+    uint32_t telemetryPerMinute = 60;
+    bool useQueue = true;      // sendData(..., useQueue): batch when online
+    bool batching = true;      // setBatching()
+    int batchSize = 5;
+};
+
+/**
+ * @struct SimFleetConfig
+ * @brief A fleet run
+ */
+struct SimFleetConfig {
+    size_t devices = 10;
+    unsigned long durationMs = 60000;  // Workload runs this long
+    unsigned long drainMs = 15000;     // Then the fleet keeps running without new data
+    unsigned long tickMs = 10;
+    unsigned long bootSpreadMs = 0;    // Devices power up within this window; 0 is a boot storm
+    uint32_t seed = 1;
+    SimLinkConfig link;
+    MockServerConfig server;
+    SimWorkload workload;
+    std::vector<unsigned long> storms; // Times at which every connection drops at once
+};
+
+/**
+ * @struct SimDeviceReport
+ * @brief Per-device results of a run
+ */
+struct SimDeviceReport {
+    uint32_t generated = 0;   // Telemetry readings handed to sendData
+    uint32_t delivered = 0;   // Distinct readings the server received
+    uint32_t duplicates = 0;
+    float throughput = 0;     // Delivered per second of workload
+    uint32_t latencyP50 = 0;
+    uint32_t latencyP95 = 0;
+    uint32_t latencyP99 = 0;
+    uint32_t latencyMax = 0;
+    size_t peakQueue = 0;
+    float meanQueue = 0;
+    uint32_t connects = 0;
+    uint32_t handshakes = 0;
+    uint32_t resumed = 0;
+    uint32_t refused = 0;
+    uint32_t commandsSent = 0;
+    uint32_t commandResponses = 0;
+    uint32_t commandP50 = 0;
+    ParanodeStats stats;
+};
+
+/**
+ * @struct SimFleetTotals
+ * @brief Whole-fleet results of a run
+ */
+struct SimFleetTotals {
+    uint64_t generated = 0;
+    uint64_t delivered = 0;
+    uint64_t duplicates = 0;
+    uint64_t connects = 0;
+    uint64_t refused = 0;
+    uint64_t commandsSent = 0;
+    uint64_t commandResponses = 0;
+    uint64_t lostFrames = 0;   // Frames the network lost, either way
+    size_t peakQueue = 0;
+    std::vector<uint32_t> latencies;
+};
+
+class SimFleet {
+public:
+    explicit SimFleet(const SimFleetConfig& config);
+    ~SimFleet();
+
+    /**
+     * @brief Run to the end of the workload plus the drain period
+     */
+    void run();
+
+    /**
+     * @brief Run ticks until the clock reaches end
+     */
+    void runUntil(unsigned long end);
+
+    unsigned long now() const { return _now; }
+    size_t size() const { return _devices.size(); }
+    const SimFleetConfig& config() const { return _config; }
+    SimNetwork& network() { return _network; }
+    MockServer& server() { return _server; }
+    SimParanode& device(size_t index) { return *_devices[index].paranode; }
+
+    /**
+     * @brief Bring a device's Wi-Fi station down or up; down also drops its link
+     */
+    void setWifi(size_t index, bool up);
+
+    SimDeviceReport report(size_t index) const;
+    SimFleetTotals totals() const;
+
+    /**
+     * @brief Per-device CSV followed by fleet totals
+     */
+    void printReport(Print& out, bool perDevice = true) const;
+
+    static uint32_t percentile(std::vector<uint32_t> values, float p);
+
+private:
+    struct Device {
+        std::unique_ptr<SimParanode> paranode;
+        unsigned long bootAt = 0;
+        unsigned long nextReading = 0;
+        bool booted = false;
+        bool wifiUp = true;
+        uint32_t generated = 0;
+        size_t peakQueue = 0;
+        uint64_t queueSum = 0;
+        uint64_t queueSamples = 0;
+    };
+
+    SimFleetConfig _config;
+    SimNetwork _network;
+    MockServer _server;
+    std::vector<Device> _devices;
+    size_t _nextStorm;
+    unsigned long _now;
+
+    void tick();
+};
+
+#endif
@@ -0,0 +1,212 @@
+/**
+ * @file SimNetwork.cpp
+ * @brief Simulated links between many devices and one server
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "SimNetwork.h"
+
+static uint64_t nowUs() {
+    return (uint64_t)millis() * 1000ULL;
+}
+
+SimLink::SimLink(SimNetwork& network, int device)
+    : _network(network), _device(device), _state(SIM_LINK_DOWN), _connectAtUs(0), _halfOpen(false),
+      _halfOpenUntilUs(0), _halfOpenBytes(0), _lost(0) {
+}
+
+void SimLink::connect(const std::string& headers) {
+    if (_state != SIM_LINK_DOWN) {
+        return;
+    }
+    _headers = headers;
+    _state = SIM_LINK_CONNECTING;
+    _connectAtUs = nowUs() + (uint64_t)(2 * _config.latencyMs + _config.handshakeMs) * 1000ULL;
+}
+
+void SimLink::close() {
+    bool wasUp = _state == SIM_LINK_UP && !_halfOpen;
+    reset(false);
+    if (wasUp && _network.server()) {
+        _network.server()->closed(*this, millis());
+    }
+}
+
+void SimLink::drop() {
+    bool wasUp = _state == SIM_LINK_UP;
+    bool serverOpen = wasUp && !_halfOpen;
+    reset(wasUp);
+    if (serverOpen && _network.server()) {
+        _network.server()->closed(*this, millis());
+    }
+}
+
+void SimLink::halfOpen(unsigned long detectMs) {
+    if (_state != SIM_LINK_UP || _halfOpen) {
+        return;
+    }
+    _halfOpen = true;
+    _halfOpenUntilUs = nowUs() + (uint64_t)detectMs * 1000ULL;
+    _halfOpenBytes = 0;
+    _up = Direction();
+    _down = Direction();
+    if (_network.server()) {
+        _network.server()->closed(*this, millis());
+    }
+}
+
+void SimLink::reset(bool notifyDevice) {
+    _state = SIM_LINK_DOWN;
+    _halfOpen = false;
+    _up = Direction();
+    _down = Direction();
+    // Frames that arrived before the drop are still read by the device
+    if (notifyDevice) {
+        _events.push_back(SimEvent{SIM_EVENT_DISCONNECTED, std::string()});
+    }
+}
+
+bool SimLink::send(const char* data, size_t length, bool binary) {
+    if (_state != SIM_LINK_UP) {
+        return false;
+    }
+    if (_halfOpen) {
+        // Nothing is acknowledged, so the socket buffer only fills
+        if (_halfOpenBytes + length > _config.sendWindow) {
+            return false;
+        }
+        _halfOpenBytes += length;
+        _lost++;
+        return true;
+    }
+    if (_config.bandwidthBps > 0 && unsentBytes(millis()) + length > _config.sendWindow) {
+        return false;
+    }
+    return schedule(_up, data, length, binary);
+}
+
+bool SimLink::sendToDevice(const char* data, size_t length, bool binary) {
+    if (_state != SIM_LINK_UP || _halfOpen) {
+        return false;
+    }
+    return schedule(_down, data, length, binary);
+}
+
+bool SimLink::schedule(Direction& direction, const char* data, size_t length, bool binary) {
+    uint64_t now = nowUs();
+    uint64_t start = direction.wireFreeAtUs > now ? direction.wireFreeAtUs : now;
+    uint64_t transmit = _config.bandwidthBps > 0 ? (uint64_t)length * 1000000ULL / _config.bandwidthBps : 0;
+
+    Frame frame;
+    frame.sentAtUs = start + transmit;
+    frame.deliverAtUs = frame.sentAtUs + (uint64_t)(_config.latencyMs + _network.jitter(_config.jitterMs)) * 1000ULL;
+    // In order, as on one TCP stream
+    if (frame.deliverAtUs < direction.lastDeliveryUs) {
+        frame.deliverAtUs = direction.lastDeliveryUs;
+    }
+    frame.data.assign(data, length);
+    frame.binary = binary;
+
+    direction.wireFreeAtUs = frame.sentAtUs;
+    direction.lastDeliveryUs = frame.deliverAtUs;
+    // Lost on the way: the sender has no way to know
+    if (_network.chance(_config.loss)) {
+        _lost++;
+        return true;
+    }
+    direction.frames.push_back(std::move(frame));
+    return true;
+}
+
+size_t SimLink::unsentBytes(unsigned long now) const {
+    uint64_t at = (uint64_t)now * 1000ULL;
+    size_t bytes = 0;
+    for (const Frame& frame : _up.frames) {
+        if (frame.sentAtUs > at) {
+            bytes += frame.data.size();
+        }
+    }
+    return bytes;
+}
+
+bool SimLink::pollEvent(SimEvent& event) {
+    if (_events.empty()) {
+        return false;
+    }
+    event = std::move(_events.front());
+    _events.pop_front();
+    return true;
+}
+
+void SimLink::deliver(uint64_t now) {
+    SimServer* server = _network.server();
+    unsigned long ms = (unsigned long)(now / 1000ULL);
+
+    if (_halfOpen && now >= _halfOpenUntilUs) {
+        reset(true);
+        return;
+    }
+
+    if (_state == SIM_LINK_CONNECTING && now >= _connectAtUs) {
+        if (server && server->accept(*this, _headers, ms)) {
+            _state = SIM_LINK_UP;
+            _events.push_back(SimEvent{SIM_EVENT_CONNECTED, std::string()});
+            server->opened(*this, ms);
+        } else {
+            _state = SIM_LINK_DOWN;
+        }
+    }
+
+    // The server may answer or drop the link from receive(), so take one
+    // frame at a time and re-check the state
+    while (_state == SIM_LINK_UP && !_up.frames.empty() && _up.frames.front().deliverAtUs <= now) {
+        Frame frame = std::move(_up.frames.front());
+        _up.frames.pop_front();
+        if (server) {
+            server->receive(*this, frame.data, frame.binary, ms);
+        }
+    }
+
+    while (_state == SIM_LINK_UP && !_down.frames.empty() && _down.frames.front().deliverAtUs <= now) {
+        Frame& frame = _down.frames.front();
+        _events.push_back(SimEvent{frame.binary ? SIM_EVENT_BINARY : SIM_EVENT_TEXT, std::move(frame.data)});
+        _down.frames.pop_front();
+    }
+}
+
+SimNetwork::SimNetwork(uint32_t seed) : _server(nullptr), _random(seed) {
+}
+
+SimLink& SimNetwork::addLink(const SimLinkConfig& config) {
+    _links.emplace_back(new SimLink(*this, (int)_links.size()));
+    _links.back()->config() = config;
+    return *_links.back();
+}
+
+void SimNetwork::deliver(unsigned long now) {
+    uint64_t at = (uint64_t)now * 1000ULL;
+    for (auto& link : _links) {
+        link->deliver(at);
+    }
+}
+
+void SimNetwork::dropAll() {
+    for (auto& link : _links) {
+        link->drop();
+    }
+}
+
+uint32_t SimNetwork::jitter(uint32_t maxMs) {
+    if (maxMs == 0) {
+        return 0;
+    }
+    return std::uniform_int_distribution<uint32_t>(0, maxMs)(_random);
+}
+
+bool SimNetwork::chance(float probability) {
+    if (probability <= 0) {
+        return false;
+    }
+    return std::uniform_real_distribution<float>(0, 1)(_random) < probability;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file SimNetwork.h
+ * @brief Simulated links between many devices and one server
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Each device gets a SimLink carrying frames both ways with latency, jitter
+ * and a bandwidth cap, and can lose frames or go half-open. Frames keep
+ * their order, as on TCP. Time is the host
+ * virtual clock; SimNetwork::deliver() hands over whatever has arrived.
+ */
+
+#ifndef PARANODE_SIM_NETWORK_H
+#define PARANODE_SIM_NETWORK_H
+
+#include <Arduino.h>
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+class SimServer;
+
+/**
+ * @struct SimLinkConfig
+ * @brief Properties of one device's path to the server
+ */
+struct SimLinkConfig {
+    uint32_t latencyMs = 20;     // One way
+    uint32_t jitterMs = 0;       // Added uniformly at random, order is kept
+    uint32_t bandwidthBps = 0;   // Bytes per second each way, 0 for unlimited
+    uint32_t sendWindow = 8192;  // Unsent bytes before send() refuses (TCP buffer)
+    uint32_t handshakeMs = 0;    // Extra time for the upgrade, on top of a round trip
+    float loss = 0;              // Probability that a frame is lost, each way
+};
+
+enum SimLinkState {
+    SIM_LINK_DOWN,
+    SIM_LINK_CONNECTING,
+    SIM_LINK_UP
+};
+
+enum SimEventType {
+    SIM_EVENT_CONNECTED,
+    SIM_EVENT_DISCONNECTED,
+    SIM_EVENT_TEXT,
+    SIM_EVENT_BINARY
+};
+
+struct SimEvent {
+    SimEventType type;
+    std::string data;
+};
+
+class SimNetwork;
+
+/**
+ * @class SimLink
+ * @brief One device's connection; the device side is used by SimTransport
+ */
+class SimLink {
+public:
+    SimLink(SimNetwork& network, int device);
+
+    int device() const { return _device; }
+    SimLinkState state() const { return _state; }
+    SimLinkConfig& config() { return _config; }
+
+    // Device side
+    void connect(const std::string& headers);
+    void close();
+    bool send(const char* data, size_t length, bool binary = false);
+    bool pollEvent(SimEvent& event);
+
+    // Server side
+    bool sendToDevice(const char* data, size_t length, bool binary = false);
+    void drop();
+
+    /**
+     * @brief Lose the path without either end noticing at first
+     *
+     * The server's side closes; the device's stays open and its sends are
+     * taken until the send window fills, then refused. After detectMs the
+     * device sees the disconnect (TCP retransmission timeout).
+     */
+    void halfOpen(unsigned long detectMs);
+    bool isHalfOpen() const { return _halfOpen; }
+
+    uint32_t lostFrames() const { return _lost; }
+
+    /**
+     * @brief Bytes accepted by send() but not yet on the wire
+     */
+    size_t unsentBytes(unsigned long now) const;
+
+private:
+    friend class SimNetwork;
+
+    struct Frame {
+        uint64_t deliverAtUs;
+        uint64_t sentAtUs;  // Last byte leaves the sender
+        std::string data;
+        bool binary;
+    };
+
+    struct Direction {
+        std::deque<Frame> frames;
+        uint64_t wireFreeAtUs = 0;
+        uint64_t lastDeliveryUs = 0;
+    };
+
+    SimNetwork& _network;
+    int _device;
+    SimLinkConfig _config;
+    SimLinkState _state;
+    uint64_t _connectAtUs;
+    std::string _headers;
+    Direction _up;
+    Direction _down;
+    std::deque<SimEvent> _events;
+    bool _halfOpen;
+    uint64_t _halfOpenUntilUs;
+    size_t _halfOpenBytes;
+    uint32_t _lost;
+
+    bool schedule(Direction& direction, const char* data, size_t length, bool binary);
+    void deliver(uint64_t nowUs);
+    void reset(bool notifyDevice);
+};
+
+/**
+ * @class SimNetwork
+ * @brief Owns the links and moves frames between them and the server
+ */
+class SimNetwork {
+public:
+    explicit SimNetwork(uint32_t seed = 1);
+
+    SimLink& addLink(const SimLinkConfig& config);
+    SimLink& link(int device) { return *_links[device]; }
+    const SimLink& link(int device) const { return *_links[device]; }
+    size_t size() const { return _links.size(); }
+
+    void setServer(SimServer* server) { _server = server; }
+    SimServer* server() const { return _server; }
+
+    /**
+     * @brief Complete handshakes and deliver frames due by now
+     */
+    void deliver(unsigned long now);
+
+    /**
+     * @brief Drop every connection at once (server restart, access point reboot)
+     */
+    void dropAll();
+
+    uint32_t jitter(uint32_t maxMs);
+    bool chance(float probability);
+
+private:
+    std::vector<std::unique_ptr<SimLink>> _links;
+    SimServer* _server;
+    std::mt19937 _random;
+};
+
+/**
+ * @class SimServer
+ * @brief What SimNetwork needs from the server model
+ */
+class SimServer {
+public:
+    virtual ~SimServer() {}
+    virtual bool accept(SimLink& link, const std::string& headers, unsigned long now) = 0;
+    virtual void opened(SimLink& link, unsigned long now) = 0;
+    virtual void receive(SimLink& link, const std::string& frame, bool binary, unsigned long now) = 0;
+    virtual void closed(SimLink& link, unsigned long now) = 0;
+};
+
+#endif
@@ -0,0 +1,11 @@
+/**
+ * @file SimParanode.cpp
+ * @brief BasicParanode over the simulated transport, compiled once
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "SimTransport.h"
+#include "Paranode/ParanodeImpl.h"
+
+template class BasicParanode<SimTransport, ParanodeMessageQueue, ParanodeJsonBuilder, ParanodeClock>;
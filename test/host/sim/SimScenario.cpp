@@ -0,0 +1,266 @@
+/**
+ * @file SimScenario.cpp
+ * @brief Scripted fault timelines for the fleet simulator
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "SimScenario.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+static bool parseSwitch(const std::string& value, bool* out) {
+    if (value == "on") {
+        *out = true;
+        return true;
+    }
+    if (value == "off") {
+        *out = false;
+        return true;
+    }
+    return false;
+}
+
+// "name=value" options shared by "link" and the timeline
+static bool parseLinkOption(const std::string& option, SimLinkConfig& link) {
+    size_t eq = option.find('=');
+    if (eq == std::string::npos) {
+        return false;
+    }
+    std::string name = option.substr(0, eq);
+    const char* value = option.c_str() + eq + 1;
+    if (name == "latency") {
+        link.latencyMs = strtoul(value, nullptr, 10);
+    } else if (name == "jitter") {
+        link.jitterMs = strtoul(value, nullptr, 10);
+    } else if (name == "bandwidth") {
+        link.bandwidthBps = strtoul(value, nullptr, 10);
+    } else if (name == "loss") {
+        link.loss = strtof(value, nullptr);
+    } else if (name == "window") {
+        link.sendWindow = strtoul(value, nullptr, 10);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool SimScenario::load(const char* path) {
+    std::ifstream in(path);
+    if (!in) {
+        _error = std::string("cannot open ") + path;
+        return false;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+    return parse(text.str());
+}
+
+bool SimScenario::parse(const std::string& text) {
+    std::istringstream in(text);
+    std::string line;
+    int number = 0;
+    while (std::getline(in, line)) {
+        number++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        if (!parseLine(line, number)) {
+            if (_error.empty()) {
+                _error = "line " + std::to_string(number) + ": cannot parse \"" + line + "\"";
+            }
+            return false;
+        }
+    }
+    std::stable_sort(_faults.begin(), _faults.end(),
+                     [](const SimFault& a, const SimFault& b) { return a.at < b.at; });
+    return true;
+}
+
+bool SimScenario::parseLine(const std::string& line, int number) {
+    std::istringstream words(line);
+    std::string keyword;
+    words >> keyword;
+
+    if (keyword == "at") {
+        SimFault fault;
+        double seconds = -1;
+        words >> seconds >> fault.action;
+        if (seconds < 0 || fault.action.empty()) {
+            return false;
+        }
+        fault.at = (unsigned long)(seconds * 1000);
+
+        std::string word;
+        while (words >> word) {
+            if (word.compare(0, 8, "devices=") == 0) {
+                const char* range = word.c_str() + 8;
+                char* end = nullptr;
+                fault.first = strtoul(range, &end, 10);
+                fault.last = *end == '-' ? strtoul(end + 1, nullptr, 10) : fault.first;
+            } else if (word.compare(0, 7, "jitter=") == 0) {
+                fault.jitter = strtoul(word.c_str() + 7, nullptr, 10);
+                fault.hasJitter = true;
+            } else if (fault.argument.empty()) {
+                fault.argument = word;
+            } else {
+                return false;
+            }
+        }
+
+        static const char* const ACTIONS[] = {"latency", "bandwidth", "loss",  "half-open",      "storm",
+                                              "accepts", "wifi",      "revoke-sessions"};
+        for (const char* action : ACTIONS) {
+            if (fault.action == action) {
+                _faults.push_back(fault);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    if (keyword == "expect") {
+        SimExpectation expectation;
+        std::string op;
+        words >> expectation.metric >> op >> expectation.limit;
+        if (words.fail() || (op != ">=" && op != "<=")) {
+            return false;
+        }
+        expectation.atLeast = op == ">=";
+        static const char* const METRICS[] = {"delivery", "commands", "duplicates", "p50",     "p95",
+                                              "p99",      "max",      "refused",    "connects"};
+        if (std::find_if(std::begin(METRICS), std::end(METRICS), [&](const char* m) {
+                return expectation.metric == m;
+            }) == std::end(METRICS)) {
+            _error = "line " + std::to_string(number) + ": unknown metric " + expectation.metric;
+            return false;
+        }
+        _expectations.push_back(expectation);
+        return true;
+    }
+
+    if (keyword == "link") {
+        std::string option;
+        while (words >> option) {
+            if (!parseLinkOption(option, _config.link)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string value;
+    words >> value;
+    if (value.empty()) {
+        return false;
+    }
+    unsigned long number_ = strtoul(value.c_str(), nullptr, 10);
+
+    if (keyword == "devices") {
+        _config.devices = number_;
+    } else if (keyword == "duration") {
+        _config.durationMs = number_ * 1000UL;
+    } else if (keyword == "drain") {
+        _config.drainMs = number_ * 1000UL;
+    } else if (keyword == "rate") {
+        _config.workload.telemetryPerMinute = number_;
+    } else if (keyword == "commands") {
+        _config.server.commandsPerMinute = number_;
+    } else if (keyword == "seed") {
+        _config.seed = number_;
+    } else if (keyword == "boot-spread") {
+        _config.bootSpreadMs = number_ * 1000UL;
+    } else if (keyword == "accepts") {
+        _config.server.acceptsPerSecond = number_;
+    } else if (keyword == "batching") {
+        return parseSwitch(value, &_config.workload.batching);
+    } else if (keyword == "queue") {
+        return parseSwitch(value, &_config.workload.useQueue);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void SimScenario::run(SimFleet& fleet) const {
+    for (const SimFault& fault : _faults) {
+        fleet.runUntil(fault.at);
+        apply(fleet, fault);
+    }
+    fleet.run();
+}
+
+void SimScenario::apply(SimFleet& fleet, const SimFault& fault) const {
+    if (fault.action == "accepts") {
+        fleet.server().config().acceptsPerSecond = strtoul(fault.argument.c_str(), nullptr, 10);
+        return;
+    }
+    if (fault.action == "revoke-sessions") {
+        fleet.server().revokeSessions();
+        return;
+    }
+
+    size_t last = std::min(fault.last, fleet.size() - 1);
+    for (size_t i = fault.first; i <= last; i++) {
+        SimLink& link = fleet.network().link((int)i);
+        if (fault.action == "latency") {
+            link.config().latencyMs = strtoul(fault.argument.c_str(), nullptr, 10);
+            if (fault.hasJitter) {
+                link.config().jitterMs = fault.jitter;
+            }
+        } else if (fault.action == "bandwidth") {
+            link.config().bandwidthBps = strtoul(fault.argument.c_str(), nullptr, 10);
+        } else if (fault.action == "loss") {
+            link.config().loss = strtof(fault.argument.c_str(), nullptr);
+        } else if (fault.action == "half-open") {
+            link.halfOpen(strtoul(fault.argument.c_str(), nullptr, 10) * 1000UL);
+        } else if (fault.action == "storm") {
+            link.drop();
+        } else if (fault.action == "wifi") {
+            fleet.setWifi(i, fault.argument != "down");
+        }
+    }
+}
+
+bool SimScenario::metric(SimFleet& fleet, const std::string& name, double* value) {
+    SimFleetTotals t = fleet.totals();
+    if (name == "delivery") {
+        *value = t.generated > 0 ? t.delivered * 100.0 / t.generated : 100.0;
+    } else if (name == "commands") {
+        *value = t.commandsSent > 0 ? t.commandResponses * 100.0 / t.commandsSent : 100.0;
+    } else if (name == "duplicates") {
+        *value = t.delivered > 0 ? t.duplicates * 100.0 / t.delivered : 0.0;
+    } else if (name == "p50") {
+        *value = SimFleet::percentile(t.latencies, 0.50f);
+    } else if (name == "p95") {
+        *value = SimFleet::percentile(t.latencies, 0.95f);
+    } else if (name == "p99") {
+        *value = SimFleet::percentile(t.latencies, 0.99f);
+    } else if (name == "max") {
+        *value = SimFleet::percentile(t.latencies, 1.0f);
+    } else if (name == "refused") {
+        *value = (double)t.refused;
+    } else if (name == "connects") {
+        *value = (double)t.connects;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::vector<SimExpectationResult> SimScenario::evaluate(SimFleet& fleet) const {
+    std::vector<SimExpectationResult> results;
+    for (const SimExpectation& expectation : _expectations) {
+        SimExpectationResult result;
+        result.expectation = expectation;
+        metric(fleet, expectation.metric, &result.value);
+        result.passed = expectation.atLeast ? result.value >= expectation.limit : result.value <= expectation.limit;
+        results.push_back(result);
+    }
+    return results;
+}
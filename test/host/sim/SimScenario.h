@@ -0,0 +1,91 @@
+/**
+ * @file SimScenario.h
+ * @brief Scripted fault timelines for the fleet simulator
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * A scenario is a text file: fleet settings, a timeline of faults and the
+ * thresholds the run must meet. Blank lines and text after '#' are ignored.
+ *
+ *   devices 50            duration 120      drain 30       rate 60
+ *   commands 6            seed 7            boot-spread 5  accepts 0
+ *   batching on|off       queue on|off
+ *   link latency=20 jitter=5 bandwidth=0 loss=0
+ *
+ *   at <s> latency <ms> [jitter=<ms>]      at <s> bandwidth <bytes/s>
+ *   at <s> loss <0..1>                     at <s> half-open <detect s>
+ *   at <s> storm                           at <s> accepts <per s>
+ *   at <s> wifi down|up                    at <s> revoke-sessions
+ *
+ * Every "at" line takes devices=<a>-<b> (or devices=<n>) to limit it to a
+ * range; link changes apply to frames sent after the event.
+ *
+ *   expect <metric> >=|<= <value>
+ *
+ * Metrics: delivery and commands (% of generated / sent), duplicates (% of
+ * delivered), p50, p95, p99 and max (ms), refused and connects (counts).
+ */
+
+#ifndef PARANODE_SIM_SCENARIO_H
+#define PARANODE_SIM_SCENARIO_H
+
+#include "SimFleet.h"
+
+struct SimFault {
+    unsigned long at = 0;
+    std::string action;
+    std::string argument;
+    uint32_t jitter = 0;
+    bool hasJitter = false;
+    size_t first = 0;
+    size_t last = SIZE_MAX;
+};
+
+struct SimExpectation {
+    std::string metric;
+    bool atLeast = true;
+    double limit = 0;
+};
+
+struct SimExpectationResult {
+    SimExpectation expectation;
+    double value = 0;
+    bool passed = false;
+};
+
+class SimScenario {
+public:
+    /**
+     * @brief Parse a scenario file
+     * @return False with error set if a line is not understood
+     */
+    bool load(const char* path);
+    bool parse(const std::string& text);
+
+    const std::string& error() const { return _error; }
+    const SimFleetConfig& config() const { return _config; }
+    const std::vector<SimFault>& faults() const { return _faults; }
+
+    /**
+     * @brief Run the fleet through the timeline
+     */
+    void run(SimFleet& fleet) const;
+
+    /**
+     * @brief Check the thresholds against a finished run
+     */
+    std::vector<SimExpectationResult> evaluate(SimFleet& fleet) const;
+
+    static bool metric(SimFleet& fleet, const std::string& name, double* value);
+
+private:
+    SimFleetConfig _config;
+    std::vector<SimFault> _faults;
+    std::vector<SimExpectation> _expectations;
+    std::string _error;
+
+    void apply(SimFleet& fleet, const SimFault& fault) const;
+    bool parseLine(const std::string& line, int number);
+};
+
+#endif
@@ -0,0 +1,152 @@
+/**
+ * @file SimTransport.h
+ * @brief BasicParanode Transport over a SimLink
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Behaves like ParanodeSocket over WebSocketsClient: connect() starts the
+ * handshake, events are dispatched from loop(), and a failed handshake is
+ * retried every PARANODE_SIM_RETRY_INTERVAL until it succeeds.
+ */
+
+#ifndef PARANODE_SIM_TRANSPORT_H
+#define PARANODE_SIM_TRANSPORT_H
+
+#include <Paranode.h>
+#include "SimNetwork.h"
+
+// WebSocketsClient's setReconnectInterval() in ParanodeSocket::connect()
+#ifndef PARANODE_SIM_RETRY_INTERVAL
+#define PARANODE_SIM_RETRY_INTERVAL 5000
+#endif
+
+class SimTransport {
+public:
+    SimTransport()
+        : _link(nextLink()), _wantConnection(false), _isConnected(false), _nextAttempt(0), _capture(nullptr) {
+        nextLink() = nullptr;
+    }
+
+    /**
+     * @brief Link for the next SimTransport constructed
+     * @note BasicParanode owns its transport, so the link is handed over
+     *       before the device is constructed.
+     */
+    static void attachNext(SimLink* link) { nextLink() = link; }
+
+    bool connect(const String& url) {
+        if (!_link) {
+            return false;
+        }
+        _wantConnection = true;
+        _isConnected = false;
+        _link->close();
+        _link->connect(_headers);
+        _nextAttempt = millis() + PARANODE_SIM_RETRY_INTERVAL;
+        return true;
+    }
+
+    void setExtraHeaders(const char* headers) { _headers = headers ? headers : ""; }
+
+    void disconnect() {
+        _wantConnection = false;
+        _isConnected = false;
+        if (_link) {
+            _link->close();
+        }
+    }
+
+    bool isConnected() { return _isConnected; }
+
+    bool send(const String& message) { return send(message.c_str(), message.length()); }
+    bool send(const char* message) { return message ? send(message, strlen(message)) : false; }
+    bool send(const char* message, size_t length) {
+        if (!_isConnected || !message) {
+            return false;
+        }
+        if (_capture) {
+            _capture->record(PARANODE_CAPTURE_OUTBOUND, message, length);
+        }
+        return _link->send(message, length);
+    }
+
+    void onRawMessage(RawMessageCallback callback) { _rawMessageCallback = callback; }
+    void onBinaryMessage(BinaryMessageCallback callback) { _binaryMessageCallback = callback; }
+    void onConnect(ConnectionCallback callback) { _connectCallback = callback; }
+    void onDisconnect(ConnectionCallback callback) { _disconnectCallback = callback; }
+
+    void loop() {
+        if (!_link) {
+            return;
+        }
+
+        SimEvent event;
+        while (_link->pollEvent(event)) {
+            switch (event.type) {
+            case SIM_EVENT_CONNECTED:
+                _isConnected = true;
+                if (_connectCallback) {
+                    _connectCallback();
+                }
+                break;
+            case SIM_EVENT_DISCONNECTED:
+                _isConnected = false;
+                _nextAttempt = millis() + PARANODE_SIM_RETRY_INTERVAL;
+                if (_disconnectCallback) {
+                    _disconnectCallback();
+                }
+                break;
+            case SIM_EVENT_TEXT:
+                injectMessage(event.data.data(), event.data.size());
+                break;
+            case SIM_EVENT_BINARY:
+                if (_binaryMessageCallback) {
+                    _binaryMessageCallback((const uint8_t*)event.data.data(), event.data.size());
+                }
+                break;
+            }
+        }
+
+        // The client keeps retrying on its own until the server accepts
+        if (_wantConnection && _link->state() == SIM_LINK_DOWN && !_isConnected &&
+            (long)(millis() - _nextAttempt) >= 0) {
+            _link->connect(_headers);
+            _nextAttempt = millis() + PARANODE_SIM_RETRY_INTERVAL;
+        }
+    }
+
+    void injectMessage(const char* payload, size_t length) {
+        if (_capture) {
+            _capture->record(PARANODE_CAPTURE_INBOUND, payload, length);
+        }
+        if (_rawMessageCallback) {
+            _rawMessageCallback(payload, length);
+        }
+    }
+
+    void setCapture(ParanodeCapture* capture) { _capture = capture; }
+
+private:
+    SimLink* _link;
+
+    static SimLink*& nextLink() {
+        static SimLink* link = nullptr;
+        return link;
+    }
+
+    std::string _headers;
+    bool _wantConnection;
+    bool _isConnected;
+    unsigned long _nextAttempt;
+    ParanodeCapture* _capture;
+
+    RawMessageCallback _rawMessageCallback;
+    BinaryMessageCallback _binaryMessageCallback;
+    ConnectionCallback _connectCallback;
+    ConnectionCallback _disconnectCallback;
+};
+
+typedef BasicParanode<SimTransport, ParanodeMessageQueue, ParanodeJsonBuilder, ParanodeClock> SimParanode;
+extern template class BasicParanode<SimTransport, ParanodeMessageQueue, ParanodeJsonBuilder, ParanodeClock>;
+
+#endif
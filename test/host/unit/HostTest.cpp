@@ -0,0 +1,50 @@
+/**
+ * @file HostTest.cpp
+ * @brief Test registry and main() for the host unit tests
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "HostTest.h"
+#include <vector>
+
+namespace hosttest {
+
+struct Test {
+    const char* name;
+    TestFunction function;
+};
+
+static std::vector<Test>& tests() {
+    static std::vector<Test> registered;
+    return registered;
+}
+
+static int failures = 0;
+
+Registrar::Registrar(const char* name, TestFunction function) {
+    tests().push_back({name, function});
+}
+
+void fail(const char* file, int line, const char* expression) {
+    failures++;
+    Serial.printf("  %s:%d: CHECK(%s) failed\n", file, line, expression);
+}
+
+} // namespace hosttest
+
+int main() {
+    host::useVirtualClock(true);
+    int failed = 0;
+    for (const hosttest::Test& test : hosttest::tests()) {
+        host::setMillis(0);
+        int before = hosttest::failures;
+        test.function();
+        bool passed = hosttest::failures == before;
+        Serial.printf("%s %s\n", passed ? "PASS" : "FAIL", test.name);
+        failed += passed ? 0 : 1;
+    }
+    Serial.printf("%u tests, %d failed\n", (unsigned)hosttest::tests().size(), failed);
+    Serial.flush();
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file HostTest.h
+ * @brief Minimal test runner for the host unit tests
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ *   TEST(queue_keeps_fifo_order) {
+ *       CHECK(queue.isEmpty());
+ *       CHECK_EQ(queue.count(), 0u);
+ *   }
+ *
+ * Each test file is its own executable; HostTest.cpp supplies main(), which
+ * runs every TEST on the virtual clock (reset to 0 before each test) and
+ * returns non-zero if a check failed.
+ */
+
+#ifndef PARANODE_HOST_TEST_H
+#define PARANODE_HOST_TEST_H
+
+#include <Arduino.h>
+
+namespace hosttest {
+
+typedef void (*TestFunction)();
+
+struct Registrar {
+    Registrar(const char* name, TestFunction function);
+};
+
+void fail(const char* file, int line, const char* expression);
+
+template<typename A, typename B>
+void failEqual(const char* file, int line, const char* expression, const A& actual, const B& expected) {
+    fail(file, line, expression);
+    Serial.print("    actual:   ");
+    Serial.println(String(actual));
+    Serial.print("    expected: ");
+    Serial.println(String(expected));
+}
+
+} // namespace hosttest
+
+#define TEST(name)                                                  \
+    static void name();                                             \
+    static hosttest::Registrar name##_registrar(#name, name);       \
+    static void name()
+
+#define CHECK(expression)                                           \
+    do {                                                            \
+        if (!(expression)) {                                        \
+            hosttest::fail(__FILE__, __LINE__, #expression);        \
+        }                                                           \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                  \
+    do {                                                            \
+        auto actual_ = (actual);                                    \
+        auto expected_ = (expected);                                \
+        if (!(actual_ == expected_)) {                              \
+            hosttest::failEqual(__FILE__, __LINE__, #actual " == " #expected, actual_, expected_); \
+        }                                                           \
+    } while (0)
+
+#endif
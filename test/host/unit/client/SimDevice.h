@@ -0,0 +1,74 @@
+/**
+ * @file SimDevice.h
+ * @brief One SimParanode against MockServer, for unit tests of the client
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * The link has no latency, so a frame sent in one step() is seen by the
+ * server, and its reply by the device, in the next.
+ */
+
+#ifndef PARANODE_SIM_DEVICE_H
+#define PARANODE_SIM_DEVICE_H
+
+#include <Preferences.h>
+#include <memory>
+#include "MockServer.h"
+#include "SimTransport.h"
+
+class SimDevice {
+public:
+    /**
+     * @param keepPreferences Start from the stored preferences, as after a
+     *        reboot, instead of erased flash
+     */
+    explicit SimDevice(const char* token = "unit-token", bool keepPreferences = false)
+        : _network(1), _server(_network, MockServerConfig()), _now(0) {
+        // HostTest's main() runs each test on the virtual clock from 0
+        if (!keepPreferences) {
+            host::clearPreferences();
+        }
+        WiFi.setStatus(WL_CONNECTED);
+
+        SimLinkConfig link;
+        link.latencyMs = 0;
+        SimTransport::attachNext(&_network.addLink(link));
+        _paranode.reset(new SimParanode(token));
+        _paranode->setMacAddress("02:00:00:00:00:01");
+    }
+
+    SimParanode& paranode() { return *_paranode; }
+    const MockDeviceRecord& server() const { return _server.record(0); }
+    unsigned long now() const { return _now; }
+
+    /**
+     * @brief begin() and connect(), then step until authenticated
+     * @return False if the device is not authenticated after a few seconds
+     */
+    bool connect() {
+        _paranode->begin();
+        _paranode->connect();
+        for (int i = 0; i < 100 && !_paranode->isConnected(); i++) {
+            step(10);
+        }
+        return _paranode->isConnected();
+    }
+
+    /**
+     * @brief Advance the clock, deliver what is due and run loop() once
+     */
+    void step(unsigned long ms) {
+        _now += ms;
+        host::setMillis(_now);
+        _network.deliver(_now);
+        _paranode->loop();
+    }
+
+private:
+    SimNetwork _network;
+    MockServer _server;
+    std::unique_ptr<SimParanode> _paranode;
+    unsigned long _now;
+};
+
+#endif
@@ -0,0 +1,162 @@
+/**
+ * @file test_allocation.cpp
+ * @brief Steady-state send, batch, receive and heartbeat paths never allocate
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * The Benchmark example's heap_delta is a net difference, so a path that
+ * allocates and frees in the same run still reads 0. This test counts every
+ * allocation instead. The device runs on a loopback transport that keeps
+ * frames in a fixed buffer, so only library allocations are counted.
+ */
+
+#include "HostTest.h"
+#include <Paranode.h>
+#include <Preferences.h>
+#include "Paranode/ParanodeImpl.h"
+
+class LoopbackTransport {
+public:
+    LoopbackTransport() : _wantConnection(false), _isConnected(false), _frames(0), _length(0) {
+        _last[0] = '\0';
+    }
+
+    bool connect(const String& url) {
+        _wantConnection = true;
+        return true;
+    }
+
+    void setExtraHeaders(const char* headers) {}
+
+    void disconnect() {
+        _wantConnection = false;
+        _isConnected = false;
+    }
+
+    bool isConnected() { return _isConnected; }
+
+    bool send(const String& message) { return send(message.c_str(), message.length()); }
+    bool send(const char* message) { return message ? send(message, strlen(message)) : false; }
+    bool send(const char* message, size_t length) {
+        if (!_isConnected || !message) {
+            return false;
+        }
+        _length = length < sizeof(_last) - 1 ? length : sizeof(_last) - 1;
+        memcpy(_last, message, _length);
+        _last[_length] = '\0';
+        _frames++;
+        return true;
+    }
+
+    void onRawMessage(RawMessageCallback callback) { _rawMessageCallback = callback; }
+    void onBinaryMessage(BinaryMessageCallback callback) {}
+    void onConnect(ConnectionCallback callback) { _connectCallback = callback; }
+    void onDisconnect(ConnectionCallback callback) {}
+
+    // The upgrade completes on the first loop() after connect()
+    void loop() {
+        if (_wantConnection && !_isConnected) {
+            _isConnected = true;
+            if (_connectCallback) {
+                _connectCallback();
+            }
+        }
+    }
+
+    void injectMessage(const char* payload, size_t length) {
+        if (_rawMessageCallback) {
+            _rawMessageCallback(payload, length);
+        }
+    }
+
+    void setCapture(ParanodeCapture* capture) {}
+
+    uint32_t frames() const { return _frames; }
+    const char* last() const { return _last; }
+
+private:
+    bool _wantConnection;
+    bool _isConnected;
+    uint32_t _frames;
+    size_t _length;
+    char _last[1024];
+
+    RawMessageCallback _rawMessageCallback;
+    ConnectionCallback _connectCallback;
+};
+
+typedef BasicParanode<LoopbackTransport, ParanodeMessageQueue, ParanodeJsonBuilder, ParanodeClock> LoopbackParanode;
+template class BasicParanode<LoopbackTransport, ParanodeMessageQueue, ParanodeJsonBuilder, ParanodeClock>;
+
+static const char AUTH_RESPONSE[] =
+    "{\"type\":\"auth_token_response\",\"success\":true,\"deviceId\":\"loop-1\",\"sessionToken\":\"s1\"}";
+
+static LoopbackParanode* connectDevice() {
+    host::clearPreferences();
+    WiFi.setStatus(WL_CONNECTED);
+
+    LoopbackParanode* paranode = new LoopbackParanode("allocation-token");
+    paranode->setMacAddress("02:00:00:00:00:02");
+    paranode->setBatching(true, 5);
+    paranode->onCommand([paranode](const JsonObject& command) {
+        paranode->sendCommandResponse(command["id"] | "", "success");
+    });
+    paranode->begin();
+    paranode->connect();
+    paranode->loop();
+    paranode->injectMessage(AUTH_RESPONSE, sizeof(AUTH_RESPONSE) - 1);
+    paranode->loop();
+    return paranode;
+}
+
+// One round of everything a connected device does in steady state
+static void steadyState(LoopbackParanode& paranode, int round) {
+    // Direct sends
+    paranode.sendData<float>("temperature", 20.0f + (round & 7), "C");
+    paranode.sendData<int>("counter", round);
+    paranode.sendData<bool>("door", (round & 1) != 0);
+    paranode.sendData<const char*>("mode", "auto");
+    paranode.sendStatus("ONLINE");
+
+    // Queued: a full batch frame, then a partial one flushed by hand
+    for (int i = 0; i < 5; i++) {
+        paranode.sendData<int>("queued", i, "", true);
+    }
+    paranode.loop();
+    paranode.sendData<int>("queued", round, "", true);
+    paranode.flushQueue();
+
+    // Receive: a command, run and answered from loop()
+    char frame[128];
+    int length = snprintf(frame, sizeof(frame),
+                          "{\"type\":\"command\",\"command\":{\"id\":\"cmd-%d\",\"action\":\"relay\",\"value\":true}}",
+                          round);
+    paranode.injectMessage(frame, (size_t)length);
+    paranode.loop();
+
+    // Heartbeat and metrics come due
+    host::advanceMillis(61000);
+    paranode.loop();
+}
+
+TEST(steady_state_paths_do_not_allocate) {
+    LoopbackParanode* paranode = connectDevice();
+    CHECK(paranode->isConnected());
+
+    // Warm up lazily initialized state
+    for (int round = 0; round < 3; round++) {
+        steadyState(*paranode, round);
+    }
+
+    ParanodeStats before = paranode->getStats();
+    size_t allocations = host::allocationCount();
+    for (int round = 3; round < 53; round++) {
+        steadyState(*paranode, round);
+    }
+    CHECK_EQ(host::allocationCount() - allocations, (size_t)0);
+
+    // The rounds really went out
+    ParanodeStats after = paranode->getStats();
+    CHECK(after.sent - before.sent >= 50u * 11u);
+    delete paranode;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file test_batching.cpp
+ * @brief Batching: queued telemetry leaves in batch frames, not one by one
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "HostTest.h"
+#include "SimDevice.h"
+
+TEST(full_batch_goes_out_as_one_frame) {
+    SimDevice device;
+    SimParanode& paranode = device.paranode();
+    paranode.setBatching(true, 5);
+    CHECK(device.connect());
+    device.step(10);
+
+    uint32_t frames = device.server().frames;
+    uint32_t telemetry = device.server().telemetry;
+    for (int i = 0; i < 5; i++) {
+        paranode.sendData<int>("reading", i, "", true);
+    }
+    device.step(10);
+    device.step(10);
+
+    CHECK_EQ(paranode.getQueuedCount(), 0u);
+    CHECK_EQ(device.server().telemetry - telemetry, 5u);
+    CHECK_EQ(device.server().frames - frames, 1u);
+}
+
+TEST(partial_batch_waits_for_the_batch_interval) {
+    SimDevice device;
+    SimParanode& paranode = device.paranode();
+    paranode.setBatching(true, 5);
+    CHECK(device.connect());
+    device.step(10);
+
+    uint32_t frames = device.server().frames;
+    uint32_t telemetry = device.server().telemetry;
+    for (int i = 0; i < 3; i++) {
+        paranode.sendData<int>("reading", i, "", true);
+    }
+
+    // processQueue leaves batch-class messages for the batch frame
+    device.step(10);
+    device.step(10);
+    CHECK_EQ(paranode.getQueuedCount(), 3u);
+    CHECK_EQ(device.server().frames, frames);
+
+    for (int i = 0; i < 1000 && paranode.getQueuedCount() > 0; i++) {
+        device.step(20);
+    }
+    device.step(10);
+    CHECK_EQ(device.server().telemetry - telemetry, 3u);
+    CHECK_EQ(device.server().frames - frames, 1u);
+}
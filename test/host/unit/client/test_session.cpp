@@ -0,0 +1,107 @@
+/**
+ * @file test_session.cpp
+ * @brief Session store: device ID and config survive a reboot, bad records don't
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ *
+ * Preferences are backed by a file here. Each test saves a session, then
+ * reloads the file into a fresh device, as a power cycle would.
+ */
+
+#include "HostTest.h"
+#include "SimDevice.h"
+
+static const char PREFERENCE_FILE[] = "test_session.prefs";
+static const char CONFIG_FRAME[] = "{\"type\":\"config\",\"config\":{\"heartbeatInterval\":45000}}";
+
+// First boot: authenticate, take a config, and leave the session on disk
+static void saveSession(const char* token) {
+    remove(PREFERENCE_FILE);
+    host::usePreferenceFile(PREFERENCE_FILE);
+
+    SimDevice device(token);
+    CHECK(device.connect());
+    device.paranode().injectMessage(CONFIG_FRAME, sizeof(CONFIG_FRAME) - 1);
+    device.step(10);
+    CHECK(strcmp(device.paranode().getDeviceId(), "sim-0") == 0);
+    CHECK_EQ(device.paranode().getTuning().heartbeatInterval, (uint32_t)45000);
+}
+
+static void flipByte(long offsetFromEnd) {
+    FILE* file = fopen(PREFERENCE_FILE, "r+b");
+    CHECK(file != nullptr);
+    fseek(file, -offsetFromEnd, SEEK_END);
+    int c = fgetc(file);
+    fseek(file, -offsetFromEnd, SEEK_END);
+    fputc(c ^ 0x5a, file);
+    fclose(file);
+}
+
+static void finish() {
+    host::usePreferenceFile(nullptr);
+    remove(PREFERENCE_FILE);
+}
+
+TEST(session_is_restored_from_disk) {
+    saveSession("unit-token");
+    CHECK(host::reloadPreferences());
+
+    SimDevice device("unit-token", true);
+    SimParanode& paranode = device.paranode();
+    paranode.begin();
+    CHECK(paranode.isSessionRestored());
+    CHECK(strcmp(paranode.getDeviceId(), "sim-0") == 0);
+    CHECK_EQ(paranode.getTuning().heartbeatInterval, (uint32_t)45000);
+
+    // This server never issued the restored session token, so the device
+    // falls back to a handshake and keeps its ID
+    CHECK(device.connect());
+    CHECK(strcmp(paranode.getDeviceId(), "sim-0") == 0);
+    finish();
+}
+
+TEST(corrupt_record_is_discarded) {
+    saveSession("unit-token");
+    flipByte(1); // The session record is the last value in the file
+    CHECK(host::reloadPreferences());
+
+    SimDevice device("unit-token", true);
+    SimParanode& paranode = device.paranode();
+    paranode.begin();
+    CHECK(!paranode.isSessionRestored());
+    CHECK(strcmp(paranode.getDeviceId(), "") == 0);
+    CHECK_EQ(paranode.getTuning().heartbeatInterval, ParanodeTuning::defaults().heartbeatInterval);
+    finish();
+}
+
+TEST(record_of_another_project_is_discarded) {
+    saveSession("unit-token");
+    CHECK(host::reloadPreferences());
+
+    SimDevice device("other-token", true);
+    SimParanode& paranode = device.paranode();
+    paranode.begin();
+    CHECK(!paranode.isSessionRestored());
+    CHECK(strcmp(paranode.getDeviceId(), "") == 0);
+    CHECK_EQ(paranode.getTuning().heartbeatInterval, ParanodeTuning::defaults().heartbeatInterval);
+
+    // A full handshake, not a resumed session
+    CHECK(device.connect());
+    CHECK_EQ(device.server().handshakes, 1u);
+    finish();
+}
+
+TEST(unreadable_file_is_treated_as_erased_flash) {
+    saveSession("unit-token");
+    FILE* file = fopen(PREFERENCE_FILE, "r+b");
+    CHECK(file != nullptr);
+    fputs("junk", file);
+    fclose(file);
+    CHECK(!host::reloadPreferences());
+
+    SimDevice device("unit-token", true);
+    device.paranode().begin();
+    CHECK(!device.paranode().isSessionRestored());
+    CHECK(strcmp(device.paranode().getDeviceId(), "") == 0);
+    finish();
+}
@@ -0,0 +1,88 @@
+/**
+ * @file test_command_cache.cpp
+ * @brief ParanodeCommandCache: duplicate detection, replay and RTC restore
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "HostTest.h"
+#include "Paranode/Utils/ParanodeCommandCache.h"
+
+TEST(new_then_pending_then_answered) {
+    ParanodeCommandCache cache;
+    const char* status = nullptr;
+    const char* response = nullptr;
+    CHECK_EQ(cache.check("cmd-1", 0, &status, &response), PARANODE_COMMAND_NEW);
+    CHECK_EQ(cache.check("cmd-1", 10, &status, &response), PARANODE_COMMAND_PENDING);
+    cache.complete("cmd-1", "ok", "done");
+    CHECK_EQ(cache.check("cmd-1", 20, &status, &response), PARANODE_COMMAND_ANSWERED);
+    CHECK(strcmp(status, "ok") == 0);
+    CHECK(strcmp(response, "done") == 0);
+    CHECK_EQ(cache.duplicateCount(), (uint32_t)2);
+}
+
+TEST(unanswered_commands_run_again_after_the_pending_timeout) {
+    ParanodeCommandCache cache;
+    CHECK_EQ(cache.check("cmd-1", 0, nullptr, nullptr), PARANODE_COMMAND_NEW);
+    CHECK_EQ(cache.check("cmd-1", PARANODE_COMMAND_PENDING_TIMEOUT, nullptr, nullptr), PARANODE_COMMAND_PENDING);
+    CHECK_EQ(cache.check("cmd-1", PARANODE_COMMAND_PENDING_TIMEOUT + 1, nullptr, nullptr), PARANODE_COMMAND_NEW);
+    CHECK_EQ(cache.check("cmd-1", PARANODE_COMMAND_PENDING_TIMEOUT + 2, nullptr, nullptr), PARANODE_COMMAND_PENDING);
+}
+
+TEST(entries_expire_after_the_ttl) {
+    ParanodeCommandCache cache;
+    cache.check("cmd-1", 0, nullptr, nullptr);
+    cache.complete("cmd-1", "ok", "");
+    CHECK_EQ(cache.check("cmd-1", PARANODE_COMMAND_CACHE_TTL + 1, nullptr, nullptr), PARANODE_COMMAND_NEW);
+}
+
+TEST(oldest_entry_is_overwritten_when_full) {
+    ParanodeCommandCache cache;
+    for (int i = 0; i <= PARANODE_COMMAND_CACHE_SIZE; i++) {
+        CHECK_EQ(cache.check(String(i).c_str(), 0, nullptr, nullptr), PARANODE_COMMAND_NEW);
+    }
+    CHECK_EQ(cache.check("0", 0, nullptr, nullptr), PARANODE_COMMAND_NEW);
+    CHECK_EQ(cache.check(String(PARANODE_COMMAND_CACHE_SIZE).c_str(), 0, nullptr, nullptr),
+             PARANODE_COMMAND_PENDING);
+}
+
+TEST(long_responses_are_truncated) {
+    ParanodeCommandCache cache;
+    char response[PARANODE_COMMAND_RESPONSE_SIZE * 2];
+    memset(response, 'r', sizeof(response) - 1);
+    response[sizeof(response) - 1] = '\0';
+    cache.check("cmd-1", 0, nullptr, nullptr);
+    cache.complete("cmd-1", "ok", response);
+    const char* replay = nullptr;
+    cache.check("cmd-1", 0, nullptr, &replay);
+    CHECK_EQ(strlen(replay), (size_t)(PARANODE_COMMAND_RESPONSE_SIZE - 1));
+}
+
+#if PARANODE_COMMAND_CACHE_PERSIST
+TEST(entries_survive_a_warm_reset) {
+    {
+        ParanodeCommandCache before;
+        before.check("cmd-1", 0, nullptr, nullptr);
+        before.complete("cmd-1", "ok", "done");
+    }
+    ParanodeCommandCache after;
+    CHECK_EQ(after.restore(0), (size_t)1);
+    const char* response = nullptr;
+    CHECK_EQ(after.check("cmd-1", 0, nullptr, &response), PARANODE_COMMAND_ANSWERED);
+    CHECK(strcmp(response, "done") == 0);
+}
+
+TEST(pending_commands_are_interrupted_by_a_warm_reset) {
+    {
+        ParanodeCommandCache before;
+        before.check("cmd-2", 0, nullptr, nullptr);
+    }
+    ParanodeCommandCache after;
+    after.restore(0);
+    const char* status = nullptr;
+    const char* response = nullptr;
+    CHECK_EQ(after.check("cmd-2", 0, &status, &response), PARANODE_COMMAND_ANSWERED);
+    CHECK(strcmp(status, "interrupted") == 0);
+    CHECK(strcmp(response, "") == 0);
+}
+#endif
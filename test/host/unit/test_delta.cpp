@@ -0,0 +1,162 @@
+/**
+ * @file test_delta.cpp
+ * @brief ParanodeDeltaTarget: PND1 patches applied in any chunking
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "HostTest.h"
+#include "Paranode/OTA/ParanodeDelta.h"
+#include <vector>
+
+typedef std::vector<uint8_t> Bytes;
+
+// Collects the new image
+class MemoryTarget : public ParanodeUpdateTarget {
+public:
+    Bytes image;
+    bool ended = false;
+    bool aborted = false;
+
+    bool begin(uint32_t size) override {
+        image.clear();
+        image.reserve(size);
+        return true;
+    }
+    bool write(const uint8_t* data, size_t length) override {
+        image.insert(image.end(), data, data + length);
+        return true;
+    }
+    bool end() override { return ended = true; }
+    void abort() override { aborted = true; }
+};
+
+static void putU32(Bytes& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back((uint8_t)(value >> (8 * i)));
+    }
+}
+
+// One control triple: new[0, diffLength) against old[0, ...), then extra
+static Bytes makePatch(const Bytes& oldImage, const Bytes& newImage, size_t diffLength) {
+    Bytes patch = {'P', 'N', 'D', '1'};
+    putU32(patch, newImage.size());
+    putU32(patch, diffLength);
+    putU32(patch, newImage.size() - diffLength);
+    putU32(patch, 0);
+    for (size_t i = 0; i < diffLength;) {
+        uint8_t diff = newImage[i] - oldImage[i];
+        if (diff != 0) {
+            patch.push_back(diff);
+            i++;
+            continue;
+        }
+        size_t run = 0;
+        while (i + run < diffLength && run < 256 && newImage[i + run] == oldImage[i + run]) {
+            run++;
+        }
+        patch.push_back(0);
+        patch.push_back((uint8_t)(run - 1));
+        i += run;
+    }
+    patch.insert(patch.end(), newImage.begin() + diffLength, newImage.end());
+    return patch;
+}
+
+static Bytes oldImage;
+static Bytes newImage;
+
+static void makeImages() {
+    oldImage.resize(1500);
+    for (size_t i = 0; i < oldImage.size(); i++) {
+        oldImage[i] = (uint8_t)(i * 7);
+    }
+    newImage = oldImage;
+    newImage[3] += 1;
+    newImage[700] = 0;
+    newImage[701] -= 3;
+    for (int i = 0; i < 300; i++) {
+        newImage.push_back((uint8_t)i);
+    }
+}
+
+static bool apply(const Bytes& patch, size_t chunk, MemoryTarget& output, const uint8_t* sha = nullptr,
+                  size_t announced = 0) {
+    uint8_t digest[PARANODE_SHA256_SIZE];
+    ParanodeSha256 hash;
+    hash.update(newImage.data(), newImage.size());
+    hash.finish(digest);
+
+    ParanodeDeltaTarget delta;
+    delta.configure(&output, [](uint32_t offset, uint8_t* buffer, size_t length) {
+        if (offset + length > oldImage.size()) {
+            return false;
+        }
+        memcpy(buffer, oldImage.data() + offset, length);
+        return true;
+    }, newImage.size(), sha ? sha : digest);
+
+    if (!delta.begin(announced ? announced : patch.size())) {
+        return false;
+    }
+    for (size_t i = 0; i < patch.size(); i += chunk) {
+        if (!delta.write(patch.data() + i, std::min(chunk, patch.size() - i))) {
+            return false;
+        }
+    }
+    return delta.end();
+}
+
+TEST(rebuilds_the_image_in_any_chunking) {
+    makeImages();
+    Bytes patch = makePatch(oldImage, newImage, oldImage.size());
+    CHECK(patch.size() < newImage.size() / 2);
+    for (size_t chunk : {patch.size(), (size_t)1, (size_t)7, (size_t)64}) {
+        MemoryTarget output;
+        CHECK(apply(patch, chunk, output));
+        CHECK(output.ended);
+        CHECK(output.image == newImage);
+    }
+}
+
+TEST(wrong_hash_aborts) {
+    makeImages();
+    Bytes patch = makePatch(oldImage, newImage, oldImage.size());
+    uint8_t wrong[PARANODE_SHA256_SIZE] = {0};
+    MemoryTarget output;
+    CHECK(!apply(patch, patch.size(), output, wrong));
+    CHECK(output.aborted);
+    CHECK(!output.ended);
+}
+
+TEST(truncated_patch_is_refused) {
+    makeImages();
+    Bytes patch = makePatch(oldImage, newImage, oldImage.size());
+    patch.resize(patch.size() - 10);
+    MemoryTarget output;
+    CHECK(!apply(patch, patch.size(), output));
+    CHECK(output.aborted);
+}
+
+TEST(bad_magic_or_size_is_refused) {
+    makeImages();
+    Bytes patch = makePatch(oldImage, newImage, oldImage.size());
+    patch[0] = 'X';
+    MemoryTarget output;
+    CHECK(!apply(patch, patch.size(), output));
+
+    patch = makePatch(oldImage, newImage, oldImage.size());
+    patch[4] ^= 1;
+    CHECK(!apply(patch, patch.size(), output));
+}
+
+TEST(patch_longer_than_announced_is_refused) {
+    makeImages();
+    Bytes patch = makePatch(oldImage, newImage, oldImage.size());
+    size_t announced = patch.size();
+    patch.push_back(0);
+    MemoryTarget output;
+    CHECK(!apply(patch, 64, output, nullptr, announced));
+    CHECK(!apply(patch, 64, output, nullptr, announced + 2));
+    CHECK(!output.ended);
+}
@@ -0,0 +1,234 @@
+/**
+ * @file test_message_queue.cpp
+ * @brief ParanodeMessageQueue: order, priorities, eviction, batching, expiry
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "HostTest.h"
+#include "Paranode/Utils/ParanodeMessageQueue.h"
+
+static ParanodeMessageQueue queue;
+
+static void push(const char* message, uint8_t priority = 1, uint32_t tag = 0, uint8_t kind = 0) {
+    queue.enqueue(message, strlen(message), priority, tag, kind);
+}
+
+static String pop(uint8_t minPriority = 0) {
+    char buffer[PARANODE_MAX_MESSAGE_SIZE];
+    uint16_t length = queue.dequeue(buffer, sizeof(buffer), nullptr, nullptr, minPriority);
+    return String(buffer, length);
+}
+
+TEST(dequeues_in_fifo_order) {
+    queue.clear();
+    push("a");
+    push("bb");
+    push("ccc");
+    CHECK_EQ(queue.count(), (size_t)3);
+    CHECK_EQ(queue.bytes(), (size_t)6);
+    CHECK(pop() == "a");
+    CHECK(pop() == "bb");
+    CHECK(pop() == "ccc");
+    CHECK(queue.isEmpty());
+    CHECK_EQ(queue.bytes(), (size_t)0);
+}
+
+TEST(rejects_empty_and_oversized_messages) {
+    queue.clear();
+    static char big[PARANODE_MAX_MESSAGE_SIZE + 1];
+    memset(big, 'x', sizeof(big) - 1);
+    CHECK(!queue.enqueue("", 0));
+    CHECK(!queue.enqueue(big, PARANODE_MAX_MESSAGE_SIZE));
+    CHECK(queue.isEmpty());
+}
+
+TEST(min_priority_takes_first_urgent_and_keeps_the_rest_in_order) {
+    queue.clear();
+    push("low", 0);
+    push("urgent", 3);
+    push("normal", 1);
+    CHECK(pop(3) == "urgent");
+    CHECK(pop(3) == "");
+    CHECK(pop() == "low");
+    CHECK(pop() == "normal");
+}
+
+TEST(full_queue_evicts_low_priority_for_high) {
+    queue.clear();
+    for (int i = 0; i < PARANODE_QUEUE_SIZE; i++) {
+        push(String(i).c_str(), i == 0 ? 2 : 0);
+    }
+    CHECK(queue.isFull());
+    push("alarm", 2);
+    CHECK_EQ(queue.droppedCount(), (uint32_t)1);
+    CHECK_EQ(queue.droppedCount(0), (uint32_t)1);
+    // The high-priority head survived; the oldest low one went
+    CHECK(pop() == "0");
+    CHECK(pop() == "2");
+}
+
+TEST(full_queue_without_evict_refuses_the_new_message) {
+    queue.clear();
+    for (int i = 0; i < PARANODE_QUEUE_SIZE; i++) {
+        push("old");
+    }
+    CHECK(!queue.enqueue("new", 3, 1, 0, 0, false));
+    CHECK_EQ(queue.count(), (size_t)PARANODE_QUEUE_SIZE);
+    CHECK_EQ(queue.droppedCount(1), (uint32_t)1);
+}
+
+TEST(coalesce_replaces_the_newest_of_its_kind) {
+    queue.clear();
+    push("status-1", 1, 0, 7);
+    push("reading", 1, 0, 0);
+    bool replaced = false;
+    CHECK(queue.coalesce("status-2", 8, 1, 0, 7, millis(), &replaced));
+    CHECK(replaced);
+    CHECK_EQ(queue.count(), (size_t)2);
+    CHECK(pop() == "status-2");
+    CHECK(queue.coalesce("status-3", 8, 1, 0, 7, millis(), &replaced));
+    CHECK(!replaced);
+    CHECK_EQ(queue.count(), (size_t)2);
+}
+
+TEST(batch_joins_messages_as_a_json_array) {
+    queue.clear();
+    push("{\"a\":1}", 1, 11);
+    push("{\"b\":2}", 1, 12);
+    push("{\"c\":3}", 1, 13);
+    char buffer[128];
+    uint32_t tags[3] = {0, 0, 0};
+    int batched = queue.batchMessages(buffer, sizeof(buffer), 2, tags);
+    CHECK_EQ(batched, 2);
+    CHECK(strcmp(buffer, "[{\"a\":1},{\"b\":2}]") == 0);
+    CHECK_EQ(tags[0], (uint32_t)11);
+    CHECK_EQ(tags[1], (uint32_t)12);
+    // Batching reads; the caller dequeues what was sent
+    CHECK_EQ(queue.count(), (size_t)3);
+}
+
+TEST(batch_stops_at_the_first_refused_message) {
+    queue.clear();
+    push("{\"a\":1}", 1, 0, 0);
+    push("{\"b\":2}", 1, 0, 1);
+    push("{\"c\":3}", 1, 0, 0);
+    char buffer[128];
+    int batched = queue.batchMessages(buffer, sizeof(buffer), 5, nullptr, [](void*, uint8_t kind) { return kind == 0; });
+    CHECK_EQ(batched, 1);
+    CHECK(strcmp(buffer, "[{\"a\":1}]") == 0);
+}
+
+TEST(batch_stops_before_overflowing_the_buffer) {
+    queue.clear();
+    for (int i = 0; i < 3; i++) {
+        push("{\"value\":\"0123456789\"}");
+    }
+    char buffer[50];
+    CHECK_EQ(queue.batchMessages(buffer, sizeof(buffer), 5), 2);
+    CHECK(buffer[strlen(buffer) - 1] == ']');
+}
+
+TEST(expired_messages_are_removed_per_kind) {
+    queue.clear();
+    push("short", 1, 0, 1);
+    push("long", 1, 0, 2);
+    host::advanceMillis(5000);
+    int removed = queue.removeExpired([](uint8_t kind) { return kind == 1 ? 1000UL : 60000UL; }, millis());
+    CHECK_EQ(removed, 1);
+    CHECK_EQ(queue.expiredCount(), (uint32_t)1);
+    CHECK_EQ(queue.count(), (size_t)1);
+    CHECK(pop() == "long");
+}
+
+TEST(coalesce_keeps_the_original_timestamp) {
+    queue.clear();
+    queue.enqueue("status-1", 8, 1, 0, 7, true, 100);
+    queue.enqueue("reading", 7, 1, 0, 0, true, 300);
+    CHECK(queue.coalesce("status-2", 8, 1, 0, 7, 500));
+    // Still backlog for a connection opened at 200, and still first
+    CHECK_EQ(queue.countBefore(200), (size_t)1);
+    CHECK_EQ(queue.getOldestTimestamp(), 100UL);
+}
+
+TEST(lane_batches_select_by_time_not_position) {
+    queue.clear();
+    queue.enqueue("{\"live\":1}", 10, 1, 1, 0, true, 200);
+    queue.enqueue("{\"old\":1}", 9, 1, 2, 0, true, 50);
+    queue.enqueue("{\"live\":2}", 10, 1, 3, 0, true, 210);
+    char buffer[128];
+    uint32_t tags[4];
+    CHECK_EQ(queue.batchBefore(100, buffer, sizeof(buffer), 5, tags), 1);
+    CHECK(strcmp(buffer, "[{\"old\":1}]") == 0);
+    CHECK_EQ(queue.discardBefore(100, 1), (size_t)1);
+
+    CHECK_EQ(queue.batchSince(100, buffer, sizeof(buffer), 5, tags), 2);
+    CHECK(strcmp(buffer, "[{\"live\":1},{\"live\":2}]") == 0);
+    CHECK_EQ(tags[1], (uint32_t)3);
+    CHECK_EQ(queue.discardSince(100, 2), (size_t)2);
+    CHECK(queue.isEmpty());
+    CHECK_EQ(queue.bytes(), (size_t)0);
+}
+
+TEST(since_splits_backlog_from_live) {
+    queue.clear();
+    push("old-1");
+    push("old-2");
+    host::advanceMillis(100);
+    unsigned long since = millis();
+    push("live");
+    CHECK_EQ(queue.countBefore(since), (size_t)2);
+    char buffer[32];
+    CHECK(queue.dequeueSince(since, buffer, sizeof(buffer)) == 4);
+    CHECK(strcmp(buffer, "live") == 0);
+    CHECK(pop() == "old-1");
+    CHECK(pop() == "old-2");
+}
+
+TEST(out_of_order_takes_keep_the_rest_in_order_across_slot_reuse) {
+    queue.clear();
+    uint32_t dropped = queue.droppedCount();
+    int next = 0;
+    int expected = 0;
+    for (int round = 0; round < 3 * PARANODE_QUEUE_SIZE; round++) {
+        while (!queue.isFull()) {
+            push(String(next++).c_str(), 1);
+        }
+        push("urgent", 3);
+        expected++; // The oldest was evicted for it
+        CHECK(pop(3) == "urgent");
+        CHECK(pop() == String(expected++));
+    }
+    CHECK_EQ(queue.count(), (size_t)(PARANODE_QUEUE_SIZE - 2));
+    CHECK_EQ(queue.droppedCount() - dropped, (uint32_t)(3 * PARANODE_QUEUE_SIZE));
+}
+
+TEST(peek_leaves_the_message_in_place_until_discarded) {
+    queue.clear();
+    queue.enqueue("old", 3, 1, 1, 0, true, 100);
+    queue.enqueue("urgent", 6, 3, 2, 5, true, 200);
+    queue.enqueue("live", 4, 1, 3, 0, true, 300);
+
+    // A failed write: nothing moves
+    char buffer[32];
+    uint32_t tag = 0;
+    uint8_t kind = 0;
+    CHECK(queue.peek(buffer, sizeof(buffer), &tag, &kind, 3) == 6);
+    CHECK(strcmp(buffer, "urgent") == 0);
+    CHECK_EQ(tag, (uint32_t)2);
+    CHECK_EQ(kind, (uint8_t)5);
+    CHECK(queue.peekSince(250, buffer, sizeof(buffer), &tag) == 4);
+    CHECK_EQ(tag, (uint32_t)3);
+    CHECK_EQ(queue.count(), (size_t)3);
+    CHECK_EQ(queue.bytes(), (size_t)13);
+    CHECK_EQ(queue.peekKind(3), 5);
+    CHECK_EQ(queue.countBefore(250), (size_t)2);
+
+    // Written: removed
+    CHECK(queue.discardNext(3));
+    CHECK(!queue.discardNext(3));
+    CHECK(queue.discardNextSince(250));
+    CHECK_EQ(queue.bytes(), (size_t)3);
+    CHECK_EQ(queue.getOldestTimestamp(), 100ul);
+    CHECK(pop() == "old");
+}
@@ -0,0 +1,115 @@
+/**
+ * @file test_rate_limiter.cpp
+ * @brief ParanodeRateLimiter: per-class token buckets
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "HostTest.h"
+#include "Paranode/Utils/ParanodeRateLimiter.h"
+
+TEST(unlimited_by_default) {
+    ParanodeRateLimiter limiter;
+    for (int i = 0; i < 1000; i++) {
+        CHECK(limiter.tryConsume(PARANODE_MSG_TELEMETRY, 0));
+    }
+    CHECK_EQ(limiter.getLimit(PARANODE_MSG_TELEMETRY).perMinute, (uint32_t)0);
+}
+
+TEST(burst_then_refill_at_the_sustained_rate) {
+    ParanodeRateLimiter limiter;
+    limiter.setLimit(PARANODE_MSG_TELEMETRY, 60, 3);
+    for (int i = 0; i < 3; i++) {
+        CHECK(limiter.tryConsume(PARANODE_MSG_TELEMETRY, 0));
+    }
+    CHECK(!limiter.tryConsume(PARANODE_MSG_TELEMETRY, 0));
+    CHECK(!limiter.tryConsume(PARANODE_MSG_TELEMETRY, 999));
+    CHECK(limiter.tryConsume(PARANODE_MSG_TELEMETRY, 1000));
+    CHECK(!limiter.tryConsume(PARANODE_MSG_TELEMETRY, 1000));
+}
+
+TEST(refill_starts_at_the_first_use) {
+    ParanodeRateLimiter limiter;
+    host::setMillis(500000);
+    limiter.setLimit(PARANODE_MSG_TELEMETRY, 60, 1);
+
+    // The caller's clock, not the time of setLimit, starts the bucket
+    CHECK(limiter.tryConsume(PARANODE_MSG_TELEMETRY, 100000));
+    CHECK(!limiter.tryConsume(PARANODE_MSG_TELEMETRY, 100999));
+    CHECK(limiter.tryConsume(PARANODE_MSG_TELEMETRY, 101000));
+}
+
+TEST(slow_rates_accumulate_when_polled_often) {
+    ParanodeRateLimiter limiter;
+    limiter.setLimit(PARANODE_MSG_METRICS, 1, 1);
+    CHECK(limiter.tryConsume(PARANODE_MSG_METRICS, 0));
+    bool refilled = false;
+    for (unsigned long now = 1; now <= 60000 && !refilled; now++) {
+        refilled = limiter.tryConsume(PARANODE_MSG_METRICS, now);
+    }
+    CHECK(refilled);
+}
+
+TEST(refill_is_capped_at_the_burst) {
+    ParanodeRateLimiter limiter;
+    limiter.setLimit(PARANODE_MSG_TELEMETRY, 600, 2);
+    int taken = 0;
+    while (limiter.tryConsume(PARANODE_MSG_TELEMETRY, 3600000)) {
+        taken++;
+    }
+    CHECK_EQ(taken, 2);
+}
+
+TEST(default_burst_is_ten_seconds_of_rate) {
+    ParanodeRateLimiter limiter;
+    limiter.setLimit(PARANODE_MSG_TELEMETRY, 120);
+    CHECK_EQ(limiter.getLimit(PARANODE_MSG_TELEMETRY).burst, (uint32_t)20);
+    limiter.setLimit(PARANODE_MSG_STATUS, 3);
+    CHECK_EQ(limiter.getLimit(PARANODE_MSG_STATUS).burst, (uint32_t)1);
+}
+
+TEST(reannouncing_the_same_limit_keeps_the_level) {
+    ParanodeRateLimiter limiter;
+    limiter.setLimit(PARANODE_MSG_TELEMETRY, 60, 1);
+    CHECK(limiter.tryConsume(PARANODE_MSG_TELEMETRY, 0));
+    limiter.setLimit(PARANODE_MSG_TELEMETRY, 60, 1);
+    CHECK(!limiter.tryConsume(PARANODE_MSG_TELEMETRY, 0));
+}
+
+TEST(classes_are_independent) {
+    ParanodeRateLimiter limiter;
+    limiter.setLimit(PARANODE_MSG_TELEMETRY, 60, 1);
+    CHECK(limiter.tryConsume(PARANODE_MSG_TELEMETRY, 0));
+    CHECK(!limiter.tryConsume(PARANODE_MSG_TELEMETRY, 0));
+    CHECK(limiter.tryConsume(PARANODE_MSG_ERROR, 0));
+}
+
+TEST(status_and_metrics_coalesce_by_default) {
+    ParanodeRateLimiter limiter;
+    CHECK_EQ(limiter.getPolicy(PARANODE_MSG_STATUS), PARANODE_RATE_COALESCE);
+    CHECK_EQ(limiter.getPolicy(PARANODE_MSG_METRICS), PARANODE_RATE_COALESCE);
+    CHECK_EQ(limiter.getPolicy(PARANODE_MSG_TELEMETRY), PARANODE_RATE_QUEUE);
+    limiter.setPolicy(PARANODE_MSG_TELEMETRY, PARANODE_RATE_DROP);
+    CHECK_EQ(limiter.getPolicy(PARANODE_MSG_TELEMETRY), PARANODE_RATE_DROP);
+    limiter.recordThrottled(PARANODE_MSG_TELEMETRY);
+    CHECK_EQ(limiter.throttledCount(PARANODE_MSG_TELEMETRY), (uint32_t)1);
+}
+
+TEST(refund_returns_a_token_up_to_the_burst) {
+    ParanodeRateLimiter limiter;
+    limiter.setLimit(PARANODE_MSG_TELEMETRY, 60, 2);
+    CHECK(limiter.tryConsume(PARANODE_MSG_TELEMETRY, 0));
+    CHECK(limiter.tryConsume(PARANODE_MSG_TELEMETRY, 0));
+    CHECK(!limiter.tryConsume(PARANODE_MSG_TELEMETRY, 0));
+    limiter.refund(PARANODE_MSG_TELEMETRY);
+    CHECK(limiter.tryConsume(PARANODE_MSG_TELEMETRY, 0));
+
+    limiter.refund(PARANODE_MSG_TELEMETRY);
+    limiter.refund(PARANODE_MSG_TELEMETRY);
+    limiter.refund(PARANODE_MSG_TELEMETRY);
+    int taken = 0;
+    while (limiter.tryConsume(PARANODE_MSG_TELEMETRY, 0)) {
+        taken++;
+    }
+    CHECK_EQ(taken, 2);
+}
@@ -0,0 +1,84 @@
+/**
+ * @file test_receive_credits.cpp
+ * @brief ParanodeReceiveCredits: cumulative grants and overrun detection
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "HostTest.h"
+#include "Paranode/Utils/ParanodeReceiveCredits.h"
+
+TEST(nothing_is_enforced_before_the_first_grant) {
+    ParanodeReceiveCredits credits;
+    for (int i = 0; i < PARANODE_RECEIVE_CREDITS + 2; i++) {
+        CHECK(credits.receive(10));
+    }
+    CHECK_EQ(credits.overrunCount(), (uint32_t)0);
+    CHECK(credits.shouldAnnounce());
+}
+
+TEST(grant_is_received_plus_window_minus_held) {
+    ParanodeReceiveCredits credits;
+    credits.receive(100);
+    credits.release(100);
+    credits.receive(50); // Still held
+    uint32_t messages = 0;
+    uint32_t bytes = 0;
+    credits.announce(&messages, &bytes);
+    CHECK_EQ(messages, (uint32_t)(2 + PARANODE_RECEIVE_CREDITS - 1));
+    CHECK_EQ(bytes, (uint32_t)(150 + PARANODE_RECEIVE_CREDIT_BYTES - 50));
+    CHECK_EQ(credits.available(), (uint16_t)(PARANODE_RECEIVE_CREDITS - 1));
+}
+
+TEST(frames_past_the_grant_are_overruns) {
+    ParanodeReceiveCredits credits;
+    credits.announce(nullptr, nullptr);
+    for (int i = 0; i < PARANODE_RECEIVE_CREDITS; i++) {
+        CHECK(credits.receive(1));
+    }
+    CHECK(!credits.receive(1));
+    CHECK_EQ(credits.overrunCount(), (uint32_t)1);
+}
+
+TEST(bytes_past_the_grant_are_overruns) {
+    ParanodeReceiveCredits credits;
+    credits.announce(nullptr, nullptr);
+    CHECK(credits.receive(PARANODE_RECEIVE_CREDIT_BYTES));
+    CHECK(!credits.receive(1));
+}
+
+TEST(announces_when_the_server_is_waiting) {
+    ParanodeReceiveCredits credits;
+    credits.announce(nullptr, nullptr);
+    CHECK(!credits.shouldAnnounce());
+    for (int i = 0; i < PARANODE_RECEIVE_CREDITS; i++) {
+        credits.receive(1);
+    }
+    // Window used up and nothing released: no new credit to give
+    CHECK(!credits.shouldAnnounce());
+    credits.release(1);
+    CHECK(credits.shouldAnnounce());
+}
+
+TEST(announces_after_half_the_window_is_released) {
+    ParanodeReceiveCredits credits;
+    credits.announce(nullptr, nullptr);
+    int half = (PARANODE_RECEIVE_CREDITS + 1) / 2;
+    for (int i = 0; i < half; i++) {
+        credits.receive(1);
+        credits.release(1);
+        CHECK_EQ(credits.shouldAnnounce(), i == half - 1);
+    }
+}
+
+TEST(reset_starts_a_new_connection) {
+    ParanodeReceiveCredits credits;
+    credits.announce(nullptr, nullptr);
+    credits.receive(1);
+    credits.reset();
+    CHECK(credits.shouldAnnounce());
+    uint32_t messages = 0;
+    credits.announce(&messages, nullptr);
+    // The held frame still occupies the window
+    CHECK_EQ(messages, (uint32_t)(PARANODE_RECEIVE_CREDITS - 1));
+}
@@ -0,0 +1,78 @@
+/**
+ * @file test_sampler.cpp
+ * @brief ParanodeSampler: interval, aggregate and drop rules
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "HostTest.h"
+#include "Paranode/Utils/ParanodeSampler.h"
+
+TEST(no_rules_sends_everything) {
+    ParanodeSampler sampler;
+    uint8_t priority = 0;
+    CHECK_EQ(sampler.admit("temp", 0, &priority), PARANODE_SAMPLE_SEND);
+    CHECK_EQ(sampler.admit("temp", 0, &priority), PARANODE_SAMPLE_SEND);
+    CHECK_EQ(sampler.ruleCount(), (size_t)0);
+}
+
+TEST(interval_rule_sends_one_reading_per_interval) {
+    ParanodeSampler sampler;
+    CHECK(sampler.setRule("temp", 1000, PARANODE_SAMPLE_INTERVAL, 2));
+    uint8_t priority = 0;
+    CHECK_EQ(sampler.admit("temp", 0, &priority), PARANODE_SAMPLE_SEND);
+    CHECK_EQ(priority, (uint8_t)2);
+    CHECK_EQ(sampler.admit("temp", 500, &priority), PARANODE_SAMPLE_SKIP);
+    CHECK_EQ(sampler.admit("temp", 1000, &priority), PARANODE_SAMPLE_SEND);
+    CHECK_EQ(sampler.shedCount(), (uint32_t)1);
+}
+
+TEST(aggregate_rule_summarises_the_window) {
+    ParanodeSampler sampler;
+    sampler.setRule("temp", 1000, PARANODE_SAMPLE_AGGREGATE);
+    uint8_t priority = 0;
+    ParanodeSampleSummary summary = {0, 0, 0, 0};
+    CHECK_EQ(sampler.admit("temp", 1.0f, 0, &priority, &summary), PARANODE_SAMPLE_SKIP);
+    CHECK_EQ(sampler.admit("temp", 5.0f, 400, &priority, &summary), PARANODE_SAMPLE_SKIP);
+    CHECK_EQ(sampler.admit("temp", 3.0f, 1000, &priority, &summary), PARANODE_SAMPLE_SUMMARY);
+    CHECK_EQ(summary.count, (uint32_t)3);
+    CHECK(summary.mean == 3.0f);
+    CHECK(summary.min == 1.0f);
+    CHECK(summary.max == 5.0f);
+}
+
+TEST(drop_rule_sends_nothing) {
+    ParanodeSampler sampler;
+    sampler.setRule("debug", 0, PARANODE_SAMPLE_DROP);
+    uint8_t priority = 0;
+    CHECK_EQ(sampler.admit("debug", 0, &priority), PARANODE_SAMPLE_SKIP);
+    CHECK_EQ(sampler.admit("other", 0, &priority), PARANODE_SAMPLE_SEND);
+}
+
+TEST(wildcard_gives_each_key_its_own_interval) {
+    ParanodeSampler sampler;
+    sampler.setRule("*", 1000, PARANODE_SAMPLE_INTERVAL);
+    uint8_t priority = 0;
+    CHECK_EQ(sampler.admit("a", 0, &priority), PARANODE_SAMPLE_SEND);
+    CHECK_EQ(sampler.admit("b", 0, &priority), PARANODE_SAMPLE_SEND);
+    CHECK_EQ(sampler.admit("a", 10, &priority), PARANODE_SAMPLE_SKIP);
+    CHECK_EQ(sampler.ruleCount(), (size_t)1);
+}
+
+TEST(rules_lapse_at_the_expiry) {
+    ParanodeSampler sampler;
+    sampler.setRule("temp", 0, PARANODE_SAMPLE_DROP);
+    sampler.expireAt(5000);
+    CHECK(!sampler.shouldSample("temp", 4999));
+    CHECK(sampler.shouldSample("temp", 5000));
+    CHECK_EQ(sampler.ruleCount(), (size_t)0);
+}
+
+TEST(table_is_bounded) {
+    ParanodeSampler sampler;
+    for (int i = 0; i < PARANODE_SAMPLING_RULES; i++) {
+        CHECK(sampler.setRule(String(i).c_str(), 1000, PARANODE_SAMPLE_INTERVAL));
+    }
+    CHECK(!sampler.setRule("extra", 1000, PARANODE_SAMPLE_INTERVAL));
+    CHECK(sampler.setRule("0", 2000, PARANODE_SAMPLE_INTERVAL));
+}
@@ -0,0 +1,85 @@
+/**
+ * @file test_scheduler.cpp
+ * @brief ParanodeScheduler: weighted round robin and backlog slow start
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "HostTest.h"
+#include "Paranode/Utils/ParanodeScheduler.h"
+
+TEST(idle_lanes_yield_none) {
+    ParanodeScheduler scheduler;
+    CHECK_EQ(scheduler.next(false, false, 0), PARANODE_LANE_NONE);
+    CHECK_EQ(scheduler.next(true, false, 0), PARANODE_LANE_LIVE);
+}
+
+TEST(shares_interleave_live_and_backlog) {
+    ParanodeScheduler scheduler;
+    scheduler.setShares(3, 1);
+    scheduler.restart(0);
+    // Keep the backlog window open for the whole round
+    for (int i = 0; i < 4; i++) {
+        scheduler.sent(PARANODE_LANE_BACKLOG);
+    }
+    unsigned long now = PARANODE_SLOW_START_INTERVAL;
+    scheduler.next(false, true, now);
+
+    int live = 0;
+    int backlog = 0;
+    for (int i = 0; i < 4; i++) {
+        ParanodeLane lane = scheduler.next(true, true, now);
+        scheduler.sent(lane);
+        (lane == PARANODE_LANE_LIVE ? live : backlog)++;
+    }
+    CHECK_EQ(live, 3);
+    CHECK_EQ(backlog, 1);
+}
+
+TEST(backlog_window_starts_at_one_and_doubles) {
+    ParanodeScheduler scheduler;
+    scheduler.restart(0);
+    CHECK_EQ(scheduler.backlogWindow(), (uint8_t)1);
+    CHECK_EQ(scheduler.next(false, true, 0), PARANODE_LANE_BACKLOG);
+    scheduler.sent(PARANODE_LANE_BACKLOG);
+    CHECK_EQ(scheduler.next(false, true, 10), PARANODE_LANE_NONE);
+
+    unsigned long now = 0;
+    uint8_t expected = 1;
+    while (expected < PARANODE_BACKLOG_WINDOW_MAX) {
+        now += PARANODE_SLOW_START_INTERVAL;
+        expected = expected * 2 < PARANODE_BACKLOG_WINDOW_MAX ? expected * 2 : PARANODE_BACKLOG_WINDOW_MAX;
+        for (uint8_t i = 0; i < expected; i++) {
+            CHECK_EQ(scheduler.next(false, true, now), PARANODE_LANE_BACKLOG);
+            scheduler.sent(PARANODE_LANE_BACKLOG);
+        }
+        CHECK_EQ(scheduler.backlogWindow(), expected);
+    }
+}
+
+TEST(unused_window_does_not_grow) {
+    ParanodeScheduler scheduler;
+    scheduler.restart(0);
+    scheduler.next(false, false, PARANODE_SLOW_START_INTERVAL);
+    scheduler.next(false, false, 2 * PARANODE_SLOW_START_INTERVAL);
+    CHECK_EQ(scheduler.backlogWindow(), (uint8_t)1);
+}
+
+TEST(failure_halves_the_window) {
+    ParanodeScheduler scheduler;
+    scheduler.restart(0);
+    unsigned long now = 0;
+    for (int round = 0; round < 3; round++) {
+        now += PARANODE_SLOW_START_INTERVAL;
+        while (scheduler.next(false, true, now) == PARANODE_LANE_BACKLOG) {
+            scheduler.sent(PARANODE_LANE_BACKLOG);
+        }
+    }
+    uint8_t window = scheduler.backlogWindow();
+    CHECK(window > 1);
+    scheduler.failed();
+    CHECK_EQ(scheduler.backlogWindow(), (uint8_t)(window / 2));
+    scheduler.restart(now);
+    CHECK_EQ(scheduler.backlogWindow(), (uint8_t)1);
+    CHECK_EQ(scheduler.liveSince(), now);
+}
@@ -0,0 +1,64 @@
+/**
+ * @file test_sha256.cpp
+ * @brief ParanodeSha256 against the FIPS 180-2 test vectors
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "HostTest.h"
+#include "Paranode/Utils/ParanodeSha256.h"
+
+static String hex(const uint8_t digest[PARANODE_SHA256_SIZE]) {
+    char text[PARANODE_SHA256_SIZE * 2 + 1];
+    for (int i = 0; i < PARANODE_SHA256_SIZE; i++) {
+        snprintf(text + i * 2, 3, "%02x", digest[i]);
+    }
+    return String(text);
+}
+
+static String digestOf(const char* message, size_t chunk) {
+    ParanodeSha256 sha;
+    size_t length = strlen(message);
+    for (size_t i = 0; i < length; i += chunk) {
+        sha.update((const uint8_t*)message + i, length - i < chunk ? length - i : chunk);
+    }
+    uint8_t digest[PARANODE_SHA256_SIZE];
+    sha.finish(digest);
+    return hex(digest);
+}
+
+TEST(empty_message) {
+    CHECK(digestOf("", 1) == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+}
+
+TEST(abc) {
+    CHECK(digestOf("abc", 3) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+}
+
+TEST(two_blocks_in_any_chunking) {
+    const char* message = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    const char* expected = "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1";
+    CHECK(digestOf(message, 56) == expected);
+    CHECK(digestOf(message, 1) == expected);
+    CHECK(digestOf(message, 7) == expected);
+}
+
+TEST(million_a) {
+    ParanodeSha256 sha;
+    uint8_t block[1000];
+    memset(block, 'a', sizeof(block));
+    for (int i = 0; i < 1000; i++) {
+        sha.update(block, sizeof(block));
+    }
+    uint8_t digest[PARANODE_SHA256_SIZE];
+    sha.finish(digest);
+    CHECK(hex(digest) == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+TEST(parse_hex) {
+    uint8_t digest[PARANODE_SHA256_SIZE];
+    CHECK(ParanodeSha256::parseHex("BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD", digest));
+    CHECK(hex(digest) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    CHECK(!ParanodeSha256::parseHex("ba78", digest));
+    CHECK(!ParanodeSha256::parseHex("zz7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", digest));
+}
@@ -0,0 +1,47 @@
+/**
+ * @file test_tuning.cpp
+ * @brief ParanodeTuning: defaults, bounds and field names
+ * @author Muhammad Daffa
+ * @date 2025-10-25
+ */
+
+#include "HostTest.h"
+#include "Paranode/Utils/ParanodeTuning.h"
+
+TEST(defaults_are_valid) {
+    ParanodeTuning tuning = ParanodeTuning::defaults();
+    CHECK(tuning.isValid());
+    CHECK_EQ(tuning.heartbeatInterval, (uint32_t)PARANODE_HEARTBEAT_INTERVAL);
+    CHECK_EQ(tuning.messageTtl, (uint32_t)PARANODE_MESSAGE_TTL);
+}
+
+TEST(set_accepts_values_within_bounds) {
+    ParanodeTuning tuning = ParanodeTuning::defaults();
+    CHECK_EQ(tuning.set("batchSize", PARANODE_MAX_BATCH_SIZE), PARANODE_TUNING_OK);
+    CHECK_EQ(tuning.batchSize, (uint32_t)PARANODE_MAX_BATCH_SIZE);
+    CHECK_EQ(tuning.set("batching", 1), PARANODE_TUNING_OK);
+    CHECK_EQ(tuning.batching, (uint32_t)1);
+}
+
+TEST(set_rejects_values_out_of_bounds) {
+    ParanodeTuning tuning = ParanodeTuning::defaults();
+    CHECK_EQ(tuning.set("batchSize", PARANODE_MAX_BATCH_SIZE + 1), PARANODE_TUNING_OUT_OF_RANGE);
+    CHECK_EQ(tuning.set("heartbeatInterval", 10), PARANODE_TUNING_OUT_OF_RANGE);
+    CHECK_EQ(tuning.set("maxSendPerLoop", PARANODE_QUEUE_SIZE + 1), PARANODE_TUNING_OUT_OF_RANGE);
+    CHECK_EQ(tuning.batchSize, ParanodeTuning::defaults().batchSize);
+}
+
+TEST(unknown_fields) {
+    ParanodeTuning tuning = ParanodeTuning::defaults();
+    CHECK_EQ(tuning.set("nope", 1), PARANODE_TUNING_UNKNOWN);
+    CHECK_EQ(tuning.set(nullptr, 1), PARANODE_TUNING_UNKNOWN);
+    CHECK(ParanodeTuning::isField("messageTtl"));
+    CHECK(!ParanodeTuning::isField("nope"));
+    CHECK(!ParanodeTuning::isField(nullptr));
+}
+
+TEST(is_valid_checks_every_field) {
+    ParanodeTuning tuning = ParanodeTuning::defaults();
+    tuning.reconnectInterval = 0;
+    CHECK(!tuning.isValid());
+}